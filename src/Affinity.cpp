@@ -0,0 +1,98 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Pinning of the OpenMP threads to CPUs.
+ **/
+#include "Affinity.h"
+
+#include <omp.h>
+#include <sched.h>
+
+#include <sstream>
+
+std::vector<int> tsunami_lab::Affinity::s_processCpus;
+
+bool tsunami_lab::Affinity::pinThreads() {
+  if (omp_get_proc_bind() != omp_proc_bind_false) return false;
+
+  // CPUs the process may run on
+  cpu_set_t l_mask;
+  CPU_ZERO(&l_mask);
+  if (sched_getaffinity(0, sizeof(l_mask), &l_mask) != 0) return false;
+
+  std::vector<int> l_cpus;
+  for (int l_cpu = 0; l_cpu < CPU_SETSIZE; l_cpu++) {
+    if (CPU_ISSET(l_cpu, &l_mask)) l_cpus.push_back(l_cpu);
+  }
+  if (l_cpus.empty()) return false;
+  s_processCpus = l_cpus;
+
+  bool l_pinned = true;
+#pragma omp parallel reduction(&& : l_pinned)
+  {
+    std::size_t l_nThreads = omp_get_num_threads();
+    std::size_t l_thread = omp_get_thread_num();
+
+    cpu_set_t l_set;
+    CPU_ZERO(&l_set);
+    CPU_SET(l_cpus[(l_thread * l_cpus.size()) / l_nThreads], &l_set);
+    l_pinned = sched_setaffinity(0, sizeof(l_set), &l_set) == 0;
+  }
+
+  return l_pinned;
+}
+
+bool tsunami_lab::Affinity::unpinThread() {
+  if (s_processCpus.empty()) return false;
+
+  cpu_set_t l_mask;
+  CPU_ZERO(&l_mask);
+  for (int l_cpu : s_processCpus) CPU_SET(l_cpu, &l_mask);
+  return sched_setaffinity(0, sizeof(l_mask), &l_mask) == 0;
+}
+
+std::vector<int> tsunami_lab::Affinity::getPlacement() {
+  std::vector<int> l_placement(omp_get_max_threads(), -1);
+
+#pragma omp parallel
+  { l_placement[omp_get_thread_num()] = sched_getcpu(); }
+
+  return l_placement;
+}
+
+std::string tsunami_lab::Affinity::describePlacement() {
+  std::vector<int> l_placement = getPlacement();
+
+  std::ostringstream l_stream;
+  for (std::size_t l_th = 0; l_th < l_placement.size(); l_th++) {
+    if (l_th > 0) l_stream << " ";
+    l_stream << l_th << "->" << l_placement[l_th];
+  }
+
+  return l_stream.str();
+}
@@ -0,0 +1,90 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Pinning of the OpenMP threads to CPUs.
+ **/
+#ifndef TSUNAMI_LAB_AFFINITY_H
+#define TSUNAMI_LAB_AFFINITY_H
+
+#include <string>
+#include <vector>
+
+namespace tsunami_lab {
+class Affinity;
+}
+
+/**
+ * Pins the threads of the OpenMP team to CPUs. Pages are placed on the NUMA
+ *node of the thread touching them first, thus threads have to be pinned
+ *before the solver allocates its grids.
+ **/
+class tsunami_lab::Affinity {
+ private:
+  //! CPUs of the process' affinity mask before the threads were pinned,
+  //! empty if they were not pinned
+  static std::vector<int> s_processCpus;
+
+ public:
+  /**
+   * Pins every thread of the OpenMP team to a single CPU of the process'
+   *affinity mask, which is kept for the threads started afterwards, see
+   *unpinThread. The threads are spread evenly over the CPUs, which places
+   *neighbouring blocks of rows on the same socket. Nothing is done if the
+   *OpenMP runtime binds the threads already, e.g., through OMP_PROC_BIND.
+   *
+   * @return true if the threads were pinned by this call.
+   **/
+  static bool pinThreads();
+
+  /**
+   * Lets the calling thread run on all CPUs of the process' affinity mask
+   *before the threads were pinned. Threads started by a pinned thread, e.g.,
+   *helper threads, inherit its CPU and would compete with it otherwise.
+   *
+   * @return true if the mask of the calling thread was restored, false if
+   *the threads were not pinned.
+   **/
+  static bool unpinThread();
+
+  /**
+   * Gets the CPU every thread of the OpenMP team is running on.
+   *
+   * @return CPUs of the threads, -1 if unknown.
+   **/
+  static std::vector<int> getPlacement();
+
+  /**
+   * Describes the placement of the threads, e.g., for the output of the
+   *runtime configuration.
+   *
+   * @return thread-to-CPU pairs, e.g., "0->0 1->8".
+   **/
+  static std::string describePlacement();
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the pinning of threads.
+ **/
+#include <omp.h>
+#include <sched.h>
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Affinity.h"
+
+TEST_CASE("Test the pinning of the threads.", "[Affinity]") {
+  cpu_set_t l_mask;
+  CPU_ZERO(&l_mask);
+  REQUIRE(sched_getaffinity(0, sizeof(l_mask), &l_mask) == 0);
+
+  bool l_pinned = tsunami_lab::Affinity::pinThreads();
+
+  // every thread runs on a CPU of the process' mask
+  std::vector<int> l_placement = tsunami_lab::Affinity::getPlacement();
+  REQUIRE(l_placement.size() == (std::size_t)omp_get_max_threads());
+  for (std::size_t l_th = 0; l_th < l_placement.size(); l_th++) {
+    REQUIRE(l_placement[l_th] >= 0);
+    REQUIRE(CPU_ISSET(l_placement[l_th], &l_mask));
+  }
+
+  // pinned threads are bound to a single CPU each
+  if (l_pinned) {
+    int l_nCpus = 0;
+#pragma omp parallel reduction(max : l_nCpus)
+    {
+      cpu_set_t l_set;
+      CPU_ZERO(&l_set);
+      sched_getaffinity(0, sizeof(l_set), &l_set);
+      l_nCpus = CPU_COUNT(&l_set);
+    }
+    REQUIRE(l_nCpus == 1);
+
+    // the master thread is pinned to the first CPU of the mask
+    int l_first = 0;
+    while (!CPU_ISSET(l_first, &l_mask)) l_first++;
+    REQUIRE(l_placement[0] == l_first);
+
+    // a thread started by the pinned master thread inherits its CPU, unless
+    // it restores the process' mask
+    cpu_set_t l_inherited;
+    cpu_set_t l_restored;
+    bool l_unpinned = false;
+    std::thread l_helper([&] {
+      CPU_ZERO(&l_inherited);
+      sched_getaffinity(0, sizeof(l_inherited), &l_inherited);
+      l_unpinned = tsunami_lab::Affinity::unpinThread();
+      CPU_ZERO(&l_restored);
+      sched_getaffinity(0, sizeof(l_restored), &l_restored);
+    });
+    l_helper.join();
+    REQUIRE(CPU_COUNT(&l_inherited) == 1);
+    REQUIRE(l_unpinned);
+    REQUIRE(CPU_EQUAL(&l_restored, &l_mask));
+  }
+
+  std::string l_description = tsunami_lab::Affinity::describePlacement();
+  REQUIRE(l_description.find("0->") == 0);
+}
@@ -0,0 +1,227 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Arena of the large buffers of a simulation.
+ **/
+#include "Arena.h"
+
+#include <omp.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+
+tsunami_lab::Arena *tsunami_lab::Arena::s_global = nullptr;
+
+/**
+ * Rounds up to a multiple of a power of two.
+ *
+ * @param i_value value.
+ * @param i_multiple power of two.
+ * @return smallest multiple not smaller than the value.
+ **/
+static tsunami_lab::t_idx roundUp(tsunami_lab::t_idx i_value,
+                                  tsunami_lab::t_idx i_multiple) {
+  return (i_value + i_multiple - 1) & ~(i_multiple - 1);
+}
+
+tsunami_lab::Arena::Arena(t_idx i_capacity, bool i_prefault, bool i_lock) {
+  m_prefault = i_prefault;
+  m_lock = i_lock;
+
+  m_capacity = i_capacity;
+  if (m_capacity == 0) {
+    m_capacity = (t_idx)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+  }
+  m_capacity = roundUp(m_capacity, m_hugePageSize);
+
+  // the address space is reserved without committing memory, the slack
+  // aligns the reservation to huge pages
+  t_idx l_bytes = m_capacity + m_hugePageSize;
+  void *l_map = mmap(nullptr, l_bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (l_map == MAP_FAILED) throw std::bad_alloc();
+
+  char *l_first = static_cast<char *>(l_map);
+  m_base = reinterpret_cast<char *>(
+      roundUp(reinterpret_cast<t_idx>(l_first), m_hugePageSize));
+  if (m_base > l_first) munmap(l_first, m_base - l_first);
+  char *l_last = m_base + m_capacity;
+  if (l_first + l_bytes > l_last) munmap(l_last, l_first + l_bytes - l_last);
+
+  // the advice fails if the kernel has no transparent huge pages
+#ifdef MADV_HUGEPAGE
+  m_hugePages = madvise(m_base, m_capacity, MADV_HUGEPAGE) == 0;
+#endif
+  std::ifstream l_thp("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string l_mode;
+  if (std::getline(l_thp, l_mode) && l_mode.find("[never]") != l_mode.npos) {
+    m_hugePages = false;
+  }
+
+  m_free[0] = m_capacity;
+}
+
+tsunami_lab::Arena::~Arena() {
+  if (s_global == this) s_global = nullptr;
+  munmap(m_base, m_capacity);
+}
+
+void *tsunami_lab::Arena::allocate(t_idx i_bytes, t_idx i_alignment) {
+  std::lock_guard<std::mutex> l_guard(m_mutex);
+
+  // blocks of huge pages do not share a huge page with other blocks
+  t_idx l_alignment = std::max(i_alignment, (t_idx)64);
+  t_idx l_bytes = roundUp(std::max(i_bytes, (t_idx)1), 64);
+  if (l_bytes >= m_hugePageSize) {
+    l_alignment = std::max(l_alignment, m_hugePageSize);
+    l_bytes = roundUp(l_bytes, m_hugePageSize);
+  }
+
+  // first free range which holds the aligned block
+  std::map<t_idx, t_idx>::iterator l_range = m_free.begin();
+  t_idx l_offset = 0;
+  for (; l_range != m_free.end(); l_range++) {
+    l_offset = roundUp(l_range->first, l_alignment);
+    if (l_offset + l_bytes <= l_range->first + l_range->second) break;
+  }
+  if (l_range == m_free.end()) throw std::bad_alloc();
+
+  // the parts of the range before and after the block stay free
+  t_idx l_rangeFirst = l_range->first;
+  t_idx l_rangeLast = l_range->first + l_range->second;
+  m_free.erase(l_range);
+  if (l_offset > l_rangeFirst) m_free[l_rangeFirst] = l_offset - l_rangeFirst;
+  if (l_offset + l_bytes < l_rangeLast) {
+    m_free[l_offset + l_bytes] = l_rangeLast - l_offset - l_bytes;
+  }
+
+  m_used[l_offset] = l_bytes;
+  m_footprint += l_bytes;
+  m_peak = std::max(m_peak, m_footprint);
+
+  char *l_block = m_base + l_offset;
+  if (m_prefault || m_lock) {
+    // the block is split into the same shares as the rows of the grids by
+    // the first touch of the solvers (see WavePropagation2d::rowBlock), such
+    // that every thread faults in the pages of its rows on its NUMA node;
+    // the shares are whole huge pages, one write per page, the values of a
+    // new block are undefined
+    t_idx l_pageSize = sysconf(_SC_PAGESIZE);
+    t_idx l_chunk = (m_hugePages && l_bytes >= m_hugePageSize)
+                        ? m_hugePageSize
+                        : l_pageSize;
+    t_idx l_nChunks = (l_bytes + l_chunk - 1) / l_chunk;
+#pragma omp parallel
+    {
+      t_idx l_nThreads = omp_get_num_threads();
+      t_idx l_thread = omp_get_thread_num();
+      t_idx l_first = (l_nChunks * l_thread) / l_nThreads * l_chunk;
+      t_idx l_last = std::min((l_nChunks * (l_thread + 1)) / l_nThreads *
+                                  l_chunk,
+                              l_bytes);
+
+      volatile char *l_touch = l_block;
+      for (t_idx l_by = l_first; l_by < l_last; l_by += l_pageSize) {
+        l_touch[l_by] = 0;
+      }
+    }
+  }
+
+  // the pages are faulted in already, locking keeps their placement
+  if (m_lock && mlock(l_block, l_bytes) != 0) m_lockFailed = true;
+
+  return l_block;
+}
+
+void tsunami_lab::Arena::release(void *i_ptr) {
+  std::lock_guard<std::mutex> l_guard(m_mutex);
+
+  t_idx l_offset = static_cast<char *>(i_ptr) - m_base;
+  std::map<t_idx, t_idx>::iterator l_block = m_used.find(l_offset);
+  if (l_block == m_used.end()) return;
+  t_idx l_bytes = l_block->second;
+  m_used.erase(l_block);
+  m_footprint -= l_bytes;
+
+  // merge the block with the free ranges before and after it
+  t_idx l_first = l_offset;
+  t_idx l_last = l_offset + l_bytes;
+  std::map<t_idx, t_idx>::iterator l_next = m_free.lower_bound(l_offset);
+  if (l_next != m_free.end() && l_next->first == l_last) {
+    l_last += l_next->second;
+    l_next = m_free.erase(l_next);
+  }
+  if (l_next != m_free.begin()) {
+    std::map<t_idx, t_idx>::iterator l_prev = std::prev(l_next);
+    if (l_prev->first + l_prev->second == l_first) {
+      l_first = l_prev->first;
+      m_free.erase(l_prev);
+    }
+  }
+  m_free[l_first] = l_last - l_first;
+
+  // whole pages of the block which are not shared with allocated blocks are
+  // returned to the system
+  t_idx l_pageSize = sysconf(_SC_PAGESIZE);
+  t_idx l_pageFirst = roundUp(
+      std::max(l_first, l_offset / l_pageSize * l_pageSize), l_pageSize);
+  t_idx l_pageLast =
+      std::min(l_last, roundUp(l_offset + l_bytes, l_pageSize)) / l_pageSize *
+      l_pageSize;
+  if (l_pageLast > l_pageFirst) {
+    if (m_lock) munlock(m_base + l_pageFirst, l_pageLast - l_pageFirst);
+    madvise(m_base + l_pageFirst, l_pageLast - l_pageFirst, MADV_DONTNEED);
+  }
+}
+
+void *tsunami_lab::Arena::allocateGlobal(t_idx i_bytes, t_idx i_alignment) {
+  if (s_global != nullptr) return s_global->allocate(i_bytes, i_alignment);
+
+  void *l_ptr = nullptr;
+  t_idx l_alignment = std::max(i_alignment, (t_idx)sizeof(void *));
+  if (posix_memalign(&l_ptr, l_alignment, i_bytes > 0 ? i_bytes : 1) != 0) {
+    throw std::bad_alloc();
+  }
+  return l_ptr;
+}
+
+void tsunami_lab::Arena::releaseGlobal(void *i_ptr) {
+  if (i_ptr == nullptr) return;
+
+  if (s_global != nullptr && s_global->contains(i_ptr)) {
+    s_global->release(i_ptr);
+  } else {
+    free(i_ptr);
+  }
+}
@@ -0,0 +1,269 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Arena of the large buffers of a simulation.
+ **/
+#ifndef TSUNAMI_LAB_ARENA_H
+#define TSUNAMI_LAB_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+#include "constants.h"
+
+namespace tsunami_lab {
+class Arena;
+template <typename T>
+class ArenaAllocator;
+}  // namespace tsunami_lab
+
+/**
+ * Arena which reserves the address space of all large buffers of a
+ *simulation at once. The reservation is backed by transparent huge pages if
+ *the kernel supports them, which keeps the TLB misses of multi-GB grids low.
+ *Blocks of at least a huge page are aligned to huge pages, released blocks
+ *are returned to the system and reused.
+ *
+ * Optionally, the pages of a block are faulted in or locked in memory when
+ *the block is allocated, such that the time loop does not wait for page
+ *faults. The OpenMP threads fault in equal shares of the block, which match
+ *the blocks of rows the solvers touch first and sweep. Thus the pages are
+ *placed on the same NUMA nodes as by the first touch if the block is
+ *allocated outside of a parallel region and the threads are pinned; blocks
+ *allocated inside a parallel region are faulted in by the allocating thread.
+ *
+ * The grids are allocated from the global arena if one is set, otherwise from
+ *the heap.
+ **/
+class tsunami_lab::Arena {
+ private:
+  //! size of a huge page
+  static t_idx constexpr m_hugePageSize = t_idx(2) << 20;
+
+  //! first byte of the reservation
+  char *m_base = nullptr;
+
+  //! size of the reservation in bytes
+  t_idx m_capacity = 0;
+
+  //! true if the reservation is backed by transparent huge pages
+  bool m_hugePages = false;
+
+  //! true if the pages of the blocks are faulted in on allocation
+  bool m_prefault = false;
+
+  //! true if the pages of the blocks are locked in memory on allocation
+  bool m_lock = false;
+
+  //! true if locking the pages of a block failed, e.g., due to the limit of
+  //! locked memory
+  bool m_lockFailed = false;
+
+  //! bytes of the allocated blocks
+  t_idx m_footprint = 0;
+
+  //! maximum of the bytes of the allocated blocks
+  t_idx m_peak = 0;
+
+  //! offsets and sizes of the allocated blocks
+  std::map<t_idx, t_idx> m_used;
+
+  //! offsets and sizes of the free ranges, neighbouring ranges are merged
+  std::map<t_idx, t_idx> m_free;
+
+  //! serializes the allocations, e.g., of grids constructed by several
+  //! threads
+  std::mutex m_mutex;
+
+  //! arena the grids are allocated from, nullptr for the heap
+  static Arena *s_global;
+
+ public:
+  /**
+   * Reserves the address space of the arena. The pages are only backed by
+   *memory once they are touched.
+   *
+   * @param i_capacity size of the reservation in bytes, 0 reserves the size
+   *of the physical memory.
+   * @param i_prefault true if the pages of the blocks are faulted in on
+   *allocation.
+   * @param i_lock true if the pages of the blocks are locked in memory on
+   *allocation, which faults them in as well.
+   * @throw std::bad_alloc if the address space cannot be reserved.
+   **/
+  Arena(t_idx i_capacity = 0, bool i_prefault = false, bool i_lock = false);
+
+  /**
+   * Releases the reservation, unsets the global arena if it is this one.
+   **/
+  ~Arena();
+
+  Arena(Arena const &) = delete;
+  Arena &operator=(Arena const &) = delete;
+
+  /**
+   * Allocates a block of the arena.
+   *
+   * @param i_bytes size of the block.
+   * @param i_alignment alignment of the block, a power of two; blocks of at
+   *least a huge page are aligned to huge pages.
+   * @return first byte of the block.
+   * @throw std::bad_alloc if the arena has no free range of the size.
+   **/
+  void *allocate(t_idx i_bytes, t_idx i_alignment);
+
+  /**
+   * Releases a block of the arena and returns its whole pages to the system.
+   *
+   * @param i_ptr first byte of the block.
+   **/
+  void release(void *i_ptr);
+
+  /**
+   * Checks if memory belongs to the arena.
+   *
+   * @param i_ptr address.
+   * @return true if the address is in the reservation.
+   **/
+  bool contains(void const *i_ptr) const {
+    char const *l_ptr = static_cast<char const *>(i_ptr);
+    return l_ptr >= m_base && l_ptr < m_base + m_capacity;
+  }
+
+  /**
+   * Gets the size of the reservation.
+   *
+   * @return size in bytes.
+   **/
+  t_idx getCapacity() const { return m_capacity; }
+
+  /**
+   * Gets the bytes of the allocated blocks.
+   *
+   * @return footprint in bytes.
+   **/
+  t_idx getFootprint() const { return m_footprint; }
+
+  /**
+   * Gets the maximum of the bytes of the allocated blocks.
+   *
+   * @return peak footprint in bytes.
+   **/
+  t_idx getPeak() const { return m_peak; }
+
+  /**
+   * Checks if the reservation is backed by transparent huge pages.
+   *
+   * @return true if the kernel accepted the advice.
+   **/
+  bool usesHugePages() const { return m_hugePages; }
+
+  /**
+   * Checks if locking the pages of a block failed.
+   *
+   * @return true if a block is not locked.
+   **/
+  bool lockFailed() const { return m_lockFailed; }
+
+  /**
+   * Sets the arena the grids are allocated from. The arena has to outlive
+   *the grids allocated from it.
+   *
+   * @param i_arena arena, nullptr for the heap.
+   **/
+  static void setGlobal(Arena *i_arena) { s_global = i_arena; }
+
+  /**
+   * Gets the arena the grids are allocated from.
+   *
+   * @return arena, nullptr for the heap.
+   **/
+  static Arena *getGlobal() { return s_global; }
+
+  /**
+   * Allocates memory from the global arena or from the heap.
+   *
+   * @param i_bytes size of the memory.
+   * @param i_alignment alignment of the memory, a power of two.
+   * @return first byte of the memory.
+   * @throw std::bad_alloc if the memory cannot be allocated.
+   **/
+  static void *allocateGlobal(t_idx i_bytes, t_idx i_alignment);
+
+  /**
+   * Releases memory of allocateGlobal to the arena it belongs to or to the
+   *heap.
+   *
+   * @param i_ptr first byte of the memory, nullptr is ignored.
+   **/
+  static void releaseGlobal(void *i_ptr);
+};
+
+/**
+ * Allocator of the standard containers which allocates from the global arena.
+ **/
+template <typename T>
+class tsunami_lab::ArenaAllocator {
+ public:
+  typedef T value_type;
+
+  ArenaAllocator() {}
+
+  template <typename T_other>
+  ArenaAllocator(ArenaAllocator<T_other> const &) {}
+
+  /**
+   * Allocates the memory of values.
+   *
+   * @param i_n number of values.
+   * @return first value.
+   **/
+  T *allocate(std::size_t i_n) {
+    return static_cast<T *>(Arena::allocateGlobal(i_n * sizeof(T), 64));
+  }
+
+  /**
+   * Releases the memory of values.
+   *
+   * @param i_ptr first value.
+   **/
+  void deallocate(T *i_ptr, std::size_t) { Arena::releaseGlobal(i_ptr); }
+
+  template <typename T_other>
+  bool operator==(ArenaAllocator<T_other> const &) const {
+    return true;
+  }
+
+  template <typename T_other>
+  bool operator!=(ArenaAllocator<T_other> const &) const {
+    return false;
+  }
+};
+
+#endif
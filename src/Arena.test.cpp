@@ -0,0 +1,124 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the arena of the large buffers.
+ **/
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "Arena.h"
+#include "Grid2d.h"
+
+TEST_CASE("Test the allocation of blocks of the arena.", "[Arena]") {
+  tsunami_lab::t_idx l_mib = 1 << 20;
+  tsunami_lab::Arena l_arena(64 * l_mib);
+  REQUIRE(l_arena.getCapacity() == 64 * l_mib);
+
+  // small blocks are aligned as requested
+  char *l_small = static_cast<char *>(l_arena.allocate(100, 64));
+  REQUIRE(l_arena.contains(l_small));
+  REQUIRE(reinterpret_cast<std::uintptr_t>(l_small) % 64 == 0);
+  REQUIRE(l_arena.getFootprint() == 128);
+
+  // blocks of huge pages are aligned and rounded to huge pages
+  char *l_large[3];
+  for (int l_bl = 0; l_bl < 3; l_bl++) {
+    l_large[l_bl] = static_cast<char *>(l_arena.allocate(3 * l_mib, 64));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(l_large[l_bl]) % (2 * l_mib) ==
+            0);
+    for (tsunami_lab::t_idx l_by = 0; l_by < 3 * l_mib; l_by += 4096) {
+      l_large[l_bl][l_by] = l_bl + 1;
+    }
+  }
+  REQUIRE(l_arena.getFootprint() == 128 + 12 * l_mib);
+  REQUIRE(l_large[1] - l_large[0] == 4 * (std::ptrdiff_t)l_mib);
+
+  // released blocks are merged and reused
+  l_arena.release(l_large[1]);
+  l_arena.release(l_large[0]);
+  REQUIRE(l_arena.getFootprint() == 128 + 4 * l_mib);
+  REQUIRE(l_arena.getPeak() == 128 + 12 * l_mib);
+
+  char *l_merged = static_cast<char *>(l_arena.allocate(7 * l_mib, 64));
+  REQUIRE(l_merged == l_large[0]);
+  REQUIRE(l_large[2][0] == 3);
+
+  // the remaining range is too small
+  REQUIRE_THROWS_AS(l_arena.allocate(60 * l_mib, 64), std::bad_alloc);
+
+  l_arena.release(l_merged);
+  l_arena.release(l_large[2]);
+  l_arena.release(l_small);
+  REQUIRE(l_arena.getFootprint() == 0);
+  REQUIRE(l_arena.allocate(62 * l_mib, 64) != nullptr);
+
+  // faulted in and locked blocks, the limit of locked memory may be reached
+  tsunami_lab::Arena l_locked(4 * l_mib, true, true);
+  char *l_block = static_cast<char *>(l_locked.allocate(l_mib, 64));
+  l_block[l_mib - 1] = 1;
+  l_locked.release(l_block);
+
+  // the threads fault in every page of their shares of a prefaulted block
+  tsunami_lab::Arena l_prefaulted(16 * l_mib, true);
+  char *l_faulted =
+      static_cast<char *>(l_prefaulted.allocate(5 * l_mib + 100, 64));
+  tsunami_lab::t_idx l_pageSize = sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> l_resident(6 * l_mib / l_pageSize);
+  REQUIRE(mincore(l_faulted, 6 * l_mib, l_resident.data()) == 0);
+  for (unsigned char l_page : l_resident) REQUIRE((l_page & 1) == 1);
+  l_prefaulted.release(l_faulted);
+}
+
+TEST_CASE("Test the grids allocated from the global arena.", "[ArenaGlobal]") {
+  tsunami_lab::Grid2d<float> l_heap(5, 3);
+
+  {
+    tsunami_lab::Arena l_arena(16 << 20);
+    tsunami_lab::Arena::setGlobal(&l_arena);
+    REQUIRE(tsunami_lab::Arena::getGlobal() == &l_arena);
+
+    tsunami_lab::Grid2d<float> l_grid(1000, 1000);
+    REQUIRE(l_arena.contains(l_grid.data()));
+    REQUIRE(!l_arena.contains(l_heap.data()));
+    REQUIRE(l_grid(17, 3) == 0);
+
+    // grids of the heap are released to the heap
+    l_heap = tsunami_lab::Grid2d<float>(7, 2);
+    REQUIRE(l_arena.contains(l_heap.data()));
+    REQUIRE(l_arena.getFootprint() > 4000000);
+    l_heap = tsunami_lab::Grid2d<float>();
+  }
+
+  // the destructor unsets the global arena
+  REQUIRE(tsunami_lab::Arena::getGlobal() == nullptr);
+}
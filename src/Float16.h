@@ -0,0 +1,203 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * 16-bit floating point types which store values and convert them to float
+ *for the arithmetic.
+ **/
+#ifndef TSUNAMI_LAB_FLOAT16_H
+#define TSUNAMI_LAB_FLOAT16_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace tsunami_lab {
+class Float16;
+class BFloat16;
+}  // namespace tsunami_lab
+
+/**
+ * IEEE half precision number: 5 bits of exponent and 10 bits of mantissa,
+ *i.e., about 3 significant digits up to 65504. Values are rounded to the
+ *nearest even, larger ones become infinite.
+ **/
+class tsunami_lab::Float16 {
+ private:
+  //! bits of the number
+  std::uint16_t m_bits;
+
+ public:
+  /**
+   * Constructs a number whose value is undefined, e.g., for grids.
+   **/
+  Float16() = default;
+
+  /**
+   * Constructs the number closest to a value.
+   *
+   * @param i_value value.
+   **/
+  Float16(float i_value) {
+    std::uint32_t l_bits;
+    std::memcpy(&l_bits, &i_value, sizeof(float));
+
+    std::uint32_t l_sign = (l_bits >> 16) & 0x8000;
+    l_bits &= 0x7fffffff;
+
+    if (l_bits >= 0x47800000) {
+      // infinite, not a number or too large (>= 2^16)
+      m_bits = l_sign | ((l_bits > 0x7f800000) ? 0x7e00 : 0x7c00);
+    } else if (l_bits < 0x38800000) {
+      // subnormal or zero (< 2^-14): adding 0.5 aligns the 10 bits of the
+      // mantissa at the bottom and rounds them
+      float l_value;
+      std::memcpy(&l_value, &l_bits, sizeof(float));
+      l_value += 0.5f;
+      std::memcpy(&l_bits, &l_value, sizeof(float));
+      m_bits = l_sign | (l_bits - 0x3f000000);
+    } else {
+      // rebias the exponent and round the mantissa to the nearest even
+      l_bits += 0xc8000fff + ((l_bits >> 13) & 1);
+      m_bits = l_sign | (l_bits >> 13);
+    }
+  }
+
+  /**
+   * Constructs a number from its bits.
+   *
+   * @param i_bits bits of the number.
+   * @return number.
+   **/
+  static Float16 fromBits(std::uint16_t i_bits) {
+    Float16 l_number;
+    l_number.m_bits = i_bits;
+    return l_number;
+  }
+
+  /**
+   * Gets the bits of the number.
+   *
+   * @return bits.
+   **/
+  std::uint16_t getBits() const { return m_bits; }
+
+  /**
+   * Converts the number to float, which is exact.
+   *
+   * @return value.
+   **/
+  operator float() const {
+    std::uint32_t l_bits = std::uint32_t(m_bits & 0x7fff) << 13;
+    std::uint32_t l_exp = l_bits & 0x0f800000;
+
+    // rebias the exponent
+    l_bits += 0x38000000;
+    float l_value;
+    if (l_exp == 0x0f800000) {
+      // infinite or not a number
+      l_bits += 0x38000000;
+      std::memcpy(&l_value, &l_bits, sizeof(float));
+    } else if (l_exp == 0) {
+      // subnormal or zero: renormalize through 2^-14
+      l_bits += 0x00800000;
+      std::memcpy(&l_value, &l_bits, sizeof(float));
+      l_value -= 6.103515625e-05f;
+    } else {
+      std::memcpy(&l_value, &l_bits, sizeof(float));
+    }
+
+    return (m_bits & 0x8000) ? -l_value : l_value;
+  }
+};
+
+/**
+ * Brain floating point number: the 8 bits of exponent of float and 7 bits of
+ *mantissa, i.e., about 2 to 3 significant digits for the full range of float.
+ *Values are rounded to the nearest even.
+ **/
+class tsunami_lab::BFloat16 {
+ private:
+  //! bits of the number, the upper half of the bits of a float
+  std::uint16_t m_bits;
+
+ public:
+  /**
+   * Constructs a number whose value is undefined, e.g., for grids.
+   **/
+  BFloat16() = default;
+
+  /**
+   * Constructs the number closest to a value.
+   *
+   * @param i_value value.
+   **/
+  BFloat16(float i_value) {
+    std::uint32_t l_bits;
+    std::memcpy(&l_bits, &i_value, sizeof(float));
+
+    if ((l_bits & 0x7fffffff) > 0x7f800000) {
+      // keep not a number quiet
+      m_bits = (l_bits >> 16) | 0x0040;
+    } else {
+      l_bits += 0x7fff + ((l_bits >> 16) & 1);
+      m_bits = l_bits >> 16;
+    }
+  }
+
+  /**
+   * Constructs a number from its bits.
+   *
+   * @param i_bits bits of the number.
+   * @return number.
+   **/
+  static BFloat16 fromBits(std::uint16_t i_bits) {
+    BFloat16 l_number;
+    l_number.m_bits = i_bits;
+    return l_number;
+  }
+
+  /**
+   * Gets the bits of the number.
+   *
+   * @return bits.
+   **/
+  std::uint16_t getBits() const { return m_bits; }
+
+  /**
+   * Converts the number to float, which is exact.
+   *
+   * @return value.
+   **/
+  operator float() const {
+    std::uint32_t l_bits = std::uint32_t(m_bits) << 16;
+    float l_value;
+    std::memcpy(&l_value, &l_bits, sizeof(float));
+    return l_value;
+  }
+};
+
+#endif
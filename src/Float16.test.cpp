@@ -0,0 +1,87 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the 16-bit floating point types.
+ **/
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+
+#include "Float16.h"
+
+TEST_CASE("Test the conversions of half precision numbers.", "[Float16]") {
+  // exact values
+  REQUIRE(float(tsunami_lab::Float16(0.0f)) == 0);
+  REQUIRE(float(tsunami_lab::Float16(1.0f)) == 1);
+  REQUIRE(float(tsunami_lab::Float16(-2.5f)) == -2.5f);
+  REQUIRE(float(tsunami_lab::Float16(65504.0f)) == 65504);
+  REQUIRE(float(tsunami_lab::Float16(6.103515625e-05f)) == 6.103515625e-05f);
+  REQUIRE(float(tsunami_lab::Float16(5.9604644775390625e-08f)) ==
+          5.9604644775390625e-08f);
+
+  // rounding to the nearest even: 2049 is halfway between 2048 and 2050
+  REQUIRE(float(tsunami_lab::Float16(2049.0f)) == 2048);
+  REQUIRE(float(tsunami_lab::Float16(2051.0f)) == 2052);
+  REQUIRE(float(tsunami_lab::Float16(0.1f)) ==
+          Approx(0.1f).epsilon(1.0f / 2048));
+
+  // overflow
+  REQUIRE(std::isinf(float(tsunami_lab::Float16(65520.0f))));
+  REQUIRE(float(tsunami_lab::Float16(65519.0f)) == 65504);
+  REQUIRE(std::isnan(float(tsunami_lab::Float16(std::nanf("")))));
+
+  // every finite number is kept by a round trip through float
+  for (std::uint32_t l_bits = 0; l_bits < 65536; l_bits++) {
+    tsunami_lab::Float16 l_value = tsunami_lab::Float16::fromBits(l_bits);
+    if ((l_bits & 0x7c00) == 0x7c00) continue;
+
+    tsunami_lab::Float16 l_trip = float(l_value);
+    REQUIRE(l_trip.getBits() == l_bits);
+  }
+}
+
+TEST_CASE("Test the conversions of brain floating point numbers.",
+          "[BFloat16]") {
+  REQUIRE(float(tsunami_lab::BFloat16(0.0f)) == 0);
+  REQUIRE(float(tsunami_lab::BFloat16(-3.0f)) == -3);
+  REQUIRE(float(tsunami_lab::BFloat16(1E30f)) ==
+          Approx(1E30f).epsilon(1.0f / 128));
+
+  // rounding to the nearest even: 257 is halfway between 256 and 258
+  REQUIRE(float(tsunami_lab::BFloat16(257.0f)) == 256);
+  REQUIRE(float(tsunami_lab::BFloat16(259.0f)) == 260);
+  REQUIRE(std::isnan(float(tsunami_lab::BFloat16(std::nanf("")))));
+
+  for (std::uint32_t l_bits = 0; l_bits < 65536; l_bits++) {
+    tsunami_lab::BFloat16 l_value = tsunami_lab::BFloat16::fromBits(l_bits);
+    if ((l_bits & 0x7f80) == 0x7f80) continue;
+
+    tsunami_lab::BFloat16 l_trip = float(l_value);
+    REQUIRE(l_trip.getBits() == l_bits);
+  }
+}
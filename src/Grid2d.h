@@ -0,0 +1,303 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Two-dimensional grid of cells with aligned and padded rows.
+ **/
+#ifndef TSUNAMI_LAB_GRID2D_H
+#define TSUNAMI_LAB_GRID2D_H
+
+#include <utility>
+
+#include "Arena.h"
+#include "constants.h"
+
+namespace tsunami_lab {
+template <typename T>
+class Grid2d;
+}
+
+/**
+ * Grid of nx * ny cells surrounded by a layer of ghost cells. Every row
+ *starts at an address aligned to m_alignment bytes, the stride is padded
+ *accordingly. Grids own their memory, which is taken from the global arena
+ *if one is set, and can only be moved.
+ *
+ * Cells are addressed including the ghost layer, i.e., cell (0, 0) is the
+ *lower left ghost cell and cell (i_ghost, i_ghost) the first interior cell.
+ **/
+template <typename T>
+class tsunami_lab::Grid2d {
+ private:
+  //! number of interior cells in x-direction
+  t_idx m_nx = 0;
+
+  //! number of interior cells in y-direction
+  t_idx m_ny = 0;
+
+  //! width of the ghost layer
+  t_idx m_ghost = 0;
+
+  //! number of values between two rows
+  t_idx m_stride = 0;
+
+  //! values of all cells, row-major
+  T *m_data = nullptr;
+
+ public:
+  //! alignment of the rows in bytes, e.g., the size of a cache line
+  static t_idx constexpr m_alignment = 64;
+
+  /**
+   * Derives the padded stride of rows with the given number of values.
+   *
+   * @param i_nValues number of values of a row.
+   * @return smallest stride not smaller than i_nValues whose rows are
+   *aligned.
+   **/
+  static t_idx paddedStride(t_idx i_nValues) {
+    t_idx l_bytes = i_nValues * sizeof(T);
+    l_bytes = (l_bytes + m_alignment - 1) / m_alignment * m_alignment;
+    return (l_bytes + sizeof(T) - 1) / sizeof(T);
+  }
+
+  /**
+   * Constructs an empty grid.
+   **/
+  Grid2d() {}
+
+  /**
+   * Constructs a grid whose values are set to zero.
+   *
+   * @param i_nx number of interior cells in x-direction.
+   * @param i_ny number of interior cells in y-direction.
+   * @param i_ghost width of the ghost layer.
+   * @param i_stride stride of the rows, 0 derives the padded stride. Grids
+   *which are indexed alike share the stride of the first one.
+   * @param i_init if false, the values are not initialized and the pages are
+   *left untouched, e.g., to be first touched by the threads working on the
+   *rows through fillRows.
+   **/
+  Grid2d(t_idx i_nx, t_idx i_ny, t_idx i_ghost = 1, t_idx i_stride = 0,
+         bool i_init = true) {
+    m_nx = i_nx;
+    m_ny = i_ny;
+    m_ghost = i_ghost;
+    m_stride = (i_stride == 0) ? paddedStride(getNCols()) : i_stride;
+
+    m_data = static_cast<T *>(
+        Arena::allocateGlobal(getSize() * sizeof(T), m_alignment));
+    if (i_init) fill(0);
+  }
+
+  /**
+   * Destructor which frees the memory.
+   **/
+  ~Grid2d() { Arena::releaseGlobal(m_data); }
+
+  Grid2d(Grid2d const &) = delete;
+  Grid2d &operator=(Grid2d const &) = delete;
+
+  /**
+   * Moves the memory of another grid to a new grid.
+   *
+   * @param io_grid grid which will be empty afterwards.
+   **/
+  Grid2d(Grid2d &&io_grid) noexcept { *this = std::move(io_grid); }
+
+  /**
+   * Exchanges the memory with another grid.
+   *
+   * @param io_grid grid which gets the memory of this grid.
+   * @return this grid.
+   **/
+  Grid2d &operator=(Grid2d &&io_grid) noexcept {
+    t_idx l_nx = m_nx;
+    t_idx l_ny = m_ny;
+    t_idx l_ghost = m_ghost;
+    t_idx l_stride = m_stride;
+    T *l_data = m_data;
+
+    m_nx = io_grid.m_nx;
+    m_ny = io_grid.m_ny;
+    m_ghost = io_grid.m_ghost;
+    m_stride = io_grid.m_stride;
+    m_data = io_grid.m_data;
+
+    io_grid.m_nx = l_nx;
+    io_grid.m_ny = l_ny;
+    io_grid.m_ghost = l_ghost;
+    io_grid.m_stride = l_stride;
+    io_grid.m_data = l_data;
+
+    return *this;
+  }
+
+  /**
+   * Gets the number of interior cells in x-direction.
+   *
+   * @return number of cells.
+   **/
+  t_idx getNx() const { return m_nx; }
+
+  /**
+   * Gets the number of interior cells in y-direction.
+   *
+   * @return number of cells.
+   **/
+  t_idx getNy() const { return m_ny; }
+
+  /**
+   * Gets the width of the ghost layer.
+   *
+   * @return number of ghost cells on each side.
+   **/
+  t_idx getGhost() const { return m_ghost; }
+
+  /**
+   * Gets the number of columns including the ghost cells.
+   *
+   * @return number of columns.
+   **/
+  t_idx getNCols() const { return m_nx + 2 * m_ghost; }
+
+  /**
+   * Gets the number of rows including the ghost cells.
+   *
+   * @return number of rows.
+   **/
+  t_idx getNRows() const { return m_ny + 2 * m_ghost; }
+
+  /**
+   * Gets the stride in y-direction. x-direction is stride-1.
+   *
+   * @return stride in y-direction.
+   **/
+  t_idx getStride() const { return m_stride; }
+
+  /**
+   * Gets the number of values including the padding.
+   *
+   * @return number of values.
+   **/
+  t_idx getSize() const { return m_stride * getNRows(); }
+
+  /**
+   * Gets the values of all cells.
+   *
+   * @return values, the first one is the lower left ghost cell.
+   **/
+  T *data() { return m_data; }
+
+  /**
+   * Gets the values of all cells.
+   *
+   * @return values, the first one is the lower left ghost cell.
+   **/
+  T const *data() const { return m_data; }
+
+  /**
+   * Gets the view of the interior cells, which shares the stride.
+   *
+   * @return values starting at the first interior cell.
+   **/
+  T *interior() { return m_data + m_ghost * m_stride + m_ghost; }
+
+  /**
+   * Gets the view of the interior cells, which shares the stride.
+   *
+   * @return values starting at the first interior cell.
+   **/
+  T const *interior() const { return m_data + m_ghost * m_stride + m_ghost; }
+
+  /**
+   * Gets a row, which is aligned.
+   *
+   * @param i_y id of the row including the ghost cells.
+   * @return values of the row.
+   **/
+  T *row(t_idx i_y) { return m_data + i_y * m_stride; }
+
+  /**
+   * Accesses the value at a position of the array.
+   *
+   * @param i_ce position, see getStride.
+   * @return value.
+   **/
+  T &operator[](t_idx i_ce) { return m_data[i_ce]; }
+
+  /**
+   * Accesses the value at a position of the array.
+   *
+   * @param i_ce position, see getStride.
+   * @return value.
+   **/
+  T const &operator[](t_idx i_ce) const { return m_data[i_ce]; }
+
+  /**
+   * Accesses the value of a cell.
+   *
+   * @param i_x id of the cell in x-direction including the ghost cells.
+   * @param i_y id of the cell in y-direction including the ghost cells.
+   * @return value.
+   **/
+  T &operator()(t_idx i_x, t_idx i_y) { return m_data[i_x + i_y * m_stride]; }
+
+  /**
+   * Accesses the value of a cell.
+   *
+   * @param i_x id of the cell in x-direction including the ghost cells.
+   * @param i_y id of the cell in y-direction including the ghost cells.
+   * @return value.
+   **/
+  T const &operator()(t_idx i_x, t_idx i_y) const {
+    return m_data[i_x + i_y * m_stride];
+  }
+
+  /**
+   * Sets all values including the ghost cells and the padding.
+   *
+   * @param i_value value.
+   **/
+  void fill(T i_value) { fillRows(0, getNRows(), i_value); }
+
+  /**
+   * Sets all values of a block of rows including the ghost cells and the
+   *padding.
+   *
+   * @param i_first first row of the block including the ghost cells.
+   * @param i_last row after the last row of the block.
+   * @param i_value value.
+   **/
+  void fillRows(t_idx i_first, t_idx i_last, T i_value) {
+    for (t_idx l_ce = i_first * m_stride; l_ce < i_last * m_stride; l_ce++) {
+      m_data[l_ce] = i_value;
+    }
+  }
+};
+
+#endif
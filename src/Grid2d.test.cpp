@@ -0,0 +1,89 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the two-dimensional grid.
+ **/
+#include <catch2/catch.hpp>
+#include <cstdint>
+
+#include "Grid2d.h"
+
+TEST_CASE("Test the padding and alignment of the rows.", "[Grid2dLayout]") {
+  tsunami_lab::Grid2d<tsunami_lab::t_real> l_grid(13, 5);
+
+  REQUIRE(l_grid.getNCols() == 15);
+  REQUIRE(l_grid.getNRows() == 7);
+  REQUIRE(l_grid.getStride() >= l_grid.getNCols());
+  REQUIRE(l_grid.getStride() * sizeof(tsunami_lab::t_real) %
+              tsunami_lab::Grid2d<tsunami_lab::t_real>::m_alignment ==
+          0);
+  REQUIRE(l_grid.getSize() == l_grid.getStride() * 7);
+
+  // every row starts at an aligned address
+  for (tsunami_lab::t_idx l_ceY = 0; l_ceY < l_grid.getNRows(); l_ceY++) {
+    REQUIRE(reinterpret_cast<std::uintptr_t>(l_grid.row(l_ceY)) %
+                tsunami_lab::Grid2d<tsunami_lab::t_real>::m_alignment ==
+            0);
+  }
+
+  // values are zero including the ghost cells and the padding
+  for (tsunami_lab::t_idx l_ce = 0; l_ce < l_grid.getSize(); l_ce++) {
+    REQUIRE(l_grid[l_ce] == 0);
+  }
+
+  // an explicit stride is kept
+  tsunami_lab::Grid2d<tsunami_lab::t_real> l_dense(13, 5, 0, 13);
+  REQUIRE(l_dense.getStride() == 13);
+  REQUIRE(l_dense.getSize() == 13 * 5);
+}
+
+TEST_CASE("Test the access and the moves of grids.", "[Grid2dAccess]") {
+  tsunami_lab::Grid2d<tsunami_lab::t_real> l_grid(4, 3);
+  tsunami_lab::t_idx l_stride = l_grid.getStride();
+
+  l_grid(1, 1) = 3;
+  l_grid(4, 3) = 5;
+  REQUIRE(l_grid[1 + l_stride] == 3);
+  REQUIRE(l_grid.interior()[0] == 3);
+  REQUIRE(l_grid.interior()[3 + 2 * l_stride] == 5);
+  REQUIRE(l_grid.row(3)[4] == 5);
+
+  // moves hand over the memory
+  tsunami_lab::t_real *l_data = l_grid.data();
+  tsunami_lab::Grid2d<tsunami_lab::t_real> l_moved(std::move(l_grid));
+  REQUIRE(l_moved.data() == l_data);
+  REQUIRE(l_moved.getStride() == l_stride);
+  REQUIRE(l_moved(1, 1) == 3);
+  REQUIRE(l_grid.data() == nullptr);
+  REQUIRE(l_grid.getSize() == 0);
+
+  l_grid = tsunami_lab::Grid2d<tsunami_lab::t_real>(2, 2);
+  std::swap(l_grid, l_moved);
+  REQUIRE(l_grid.data() == l_data);
+  REQUIRE(l_moved.getNx() == 2);
+}
@@ -32,6 +32,9 @@
 #define TSUNAMI_LAB_CONSTANTS_H
 
 #include <cstddef>
+#include <cstdint>
+
+#include "Float16.h"
 
 namespace tsunami_lab {
 //! integral type for cell-ids, pointer arithmetic, etc.
@@ -39,6 +42,57 @@ typedef std::size_t t_idx;
 
 //! floating point type
 typedef float t_real;
+
+/**
+ * Precision policies of the solvers, which separate the type of the stored
+ *quantities from the type of the flux and Riemann arithmetic. The bathymetry
+ *is stored in its own type, integral types are quantized linearly. If the
+ *heights are relative, the stored heights of wet cells are the sea surface
+ *height, i.e., the heights relative to the still-water level.
+ **/
+namespace precision {
+//! single precision, the default
+struct Float {
+  typedef float t_store;
+  typedef float t_compute;
+  typedef float t_bath;
+  static bool constexpr m_relative = false;
+};
+
+//! double precision, e.g., for long-duration runs
+struct Double {
+  typedef double t_store;
+  typedef double t_compute;
+  typedef double t_bath;
+  static bool constexpr m_relative = false;
+};
+
+//! quantities stored in single precision, net-updates computed in double
+struct Mixed {
+  typedef float t_store;
+  typedef double t_compute;
+  typedef float t_bath;
+  static bool constexpr m_relative = false;
+};
+
+//! relative heights and momenta stored in half precision, quantized
+//! bathymetry, net-updates computed in single precision
+struct Fp16 {
+  typedef Float16 t_store;
+  typedef float t_compute;
+  typedef std::int16_t t_bath;
+  static bool constexpr m_relative = true;
+};
+
+//! relative heights and momenta stored as brain floating point numbers,
+//! quantized bathymetry, net-updates computed in single precision
+struct Bf16 {
+  typedef BFloat16 t_store;
+  typedef float t_compute;
+  typedef std::int16_t t_bath;
+  static bool constexpr m_relative = true;
+};
+}  // namespace precision
 }  // namespace tsunami_lab
 
 #endif
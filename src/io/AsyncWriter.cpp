@@ -0,0 +1,201 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Writer thread of the output.
+ **/
+#include "AsyncWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "../Affinity.h"
+
+tsunami_lab::io::AsyncWriter::AsyncWriter(NetCdf_Write &io_writer,
+                                          t_idx i_nSlots)
+    : m_writer(io_writer) {
+  t_idx l_nx = m_writer.getNxOut();
+  t_idx l_ny = m_writer.getNyOut();
+  t_idx l_stride = std::max(l_nx, t_idx(1));
+
+  m_slots.resize(std::max(i_nSlots, t_idx(1)));
+  for (t_idx l_sl = 0; l_sl < m_slots.size(); l_sl++) {
+    m_slots[l_sl].m_h = Grid2d<t_real>(l_nx, l_ny, 0, l_stride);
+    m_slots[l_sl].m_hu = Grid2d<t_real>(l_nx, l_ny, 0, l_stride);
+    m_slots[l_sl].m_hv = Grid2d<t_real>(l_nx, l_ny, 0, l_stride);
+    m_free.push_back(l_sl);
+  }
+
+  m_thread = std::thread(&AsyncWriter::run, this);
+}
+
+tsunami_lab::io::AsyncWriter::~AsyncWriter() {
+  {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_stop = true;
+  }
+  m_queued.notify_one();
+  m_thread.join();
+}
+
+void tsunami_lab::io::AsyncWriter::run() {
+  // the thread inherits the CPU of the pinned thread which started it and
+  // would compete with its sweeps otherwise
+  Affinity::unpinThread();
+
+  while (true) {
+    t_idx l_sl = 0;
+    std::function<void()> l_task;
+    {
+      std::unique_lock<std::mutex> l_lock(m_mutex);
+      m_queued.wait(l_lock, [this] {
+        return m_stop || !m_queue.empty() || !m_tasks.empty();
+      });
+      if (!m_tasks.empty()) {
+        l_task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+      } else if (m_queue.empty()) {
+        return;
+      } else {
+        l_sl = m_queue.front();
+        m_queue.pop_front();
+      }
+    }
+
+    if (l_task) {
+      std::chrono::steady_clock::time_point l_start =
+          std::chrono::steady_clock::now();
+      l_task();
+      std::chrono::duration<double> l_duration =
+          std::chrono::steady_clock::now() - l_start;
+      {
+        std::lock_guard<std::mutex> l_lock(m_mutex);
+        m_writeTime += l_duration.count();
+        m_nTasks--;
+      }
+      m_freed.notify_all();
+      continue;
+    }
+
+    std::chrono::steady_clock::time_point l_start =
+        std::chrono::steady_clock::now();
+    Slot const &l_slot = m_slots[l_sl];
+    m_writer.writeFrames(l_slot.m_h.data(), l_slot.m_hu.data(),
+                         l_slot.m_hv.data(), l_slot.m_timeStep,
+                         l_slot.m_simTime);
+    std::chrono::duration<double> l_duration =
+        std::chrono::steady_clock::now() - l_start;
+
+    {
+      std::lock_guard<std::mutex> l_lock(m_mutex);
+      m_writeTime += l_duration.count();
+      m_free.push_back(l_sl);
+    }
+    m_freed.notify_all();
+  }
+}
+
+void tsunami_lab::io::AsyncWriter::write(NetCdf_Write::RowSource const &i_h,
+                                         NetCdf_Write::RowSource const &i_hu,
+                                         NetCdf_Write::RowSource const &i_hv,
+                                         t_idx i_timeStep, t_real i_simTime) {
+  t_idx l_sl = 0;
+  {
+    std::unique_lock<std::mutex> l_lock(m_mutex);
+    if (m_free.empty()) {
+      // back-pressure: the disk falls behind the solver
+      std::chrono::steady_clock::time_point l_start =
+          std::chrono::steady_clock::now();
+      m_freed.wait(l_lock, [this] { return !m_free.empty(); });
+      std::chrono::duration<double> l_duration =
+          std::chrono::steady_clock::now() - l_start;
+      m_stallTime += l_duration.count();
+      m_nStalls++;
+    }
+    l_sl = m_free.front();
+    m_free.pop_front();
+  }
+
+  // the snapshot is taken before the solver continues
+  Slot &l_slot = m_slots[l_sl];
+  t_idx l_nx = m_writer.getNxOut();
+  t_idx l_ny = m_writer.getNyOut();
+  t_idx l_rescale = m_writer.getRescaleFactor();
+  t_idx l_nxIn = m_writer.getNxIn();
+  NetCdf_Write::downsample(l_nx, l_ny, l_rescale, l_nxIn, i_h,
+                           l_slot.m_h.data());
+  NetCdf_Write::downsample(l_nx, l_ny, l_rescale, l_nxIn, i_hu,
+                           l_slot.m_hu.data());
+  NetCdf_Write::downsample(l_nx, l_ny, l_rescale, l_nxIn, i_hv,
+                           l_slot.m_hv.data());
+  l_slot.m_timeStep = i_timeStep;
+  l_slot.m_simTime = i_simTime;
+
+  {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_queue.push_back(l_sl);
+    m_nWrites++;
+  }
+  m_queued.notify_one();
+}
+
+void tsunami_lab::io::AsyncWriter::post(std::function<void()> i_task) {
+  {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_tasks.push_back(std::move(i_task));
+    m_nTasks++;
+  }
+  m_queued.notify_one();
+}
+
+void tsunami_lab::io::AsyncWriter::flush() {
+  std::unique_lock<std::mutex> l_lock(m_mutex);
+  m_freed.wait(l_lock, [this] {
+    return m_free.size() == m_slots.size() && m_nTasks == 0;
+  });
+}
+
+tsunami_lab::t_idx tsunami_lab::io::AsyncWriter::getNumWrites() const {
+  std::lock_guard<std::mutex> l_lock(m_mutex);
+  return m_nWrites;
+}
+
+tsunami_lab::t_idx tsunami_lab::io::AsyncWriter::getNumStalls() const {
+  std::lock_guard<std::mutex> l_lock(m_mutex);
+  return m_nStalls;
+}
+
+double tsunami_lab::io::AsyncWriter::getStallTime() const {
+  std::lock_guard<std::mutex> l_lock(m_mutex);
+  return m_stallTime;
+}
+
+double tsunami_lab::io::AsyncWriter::getWriteTime() const {
+  std::lock_guard<std::mutex> l_lock(m_mutex);
+  return m_writeTime;
+}
@@ -0,0 +1,198 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Writer thread of the output.
+ **/
+#ifndef TSUNAMI_LAB_IO_ASYNC_WRITER_H
+#define TSUNAMI_LAB_IO_ASYNC_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Grid2d.h"
+#include "../constants.h"
+#include "NetCdf_Write.h"
+
+namespace tsunami_lab {
+namespace io {
+class AsyncWriter;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Writer thread which takes the output off the time loop.
+ *
+ * The calling thread downsamples the heights and momenta into a free slot
+ *of frames and queues it, the writer thread writes the queued slots to the
+ *file in order while the solver continues. The number of slots bounds the
+ *memory of the output; if all slots are queued, the calling thread waits
+ *until the oldest one is written (back-pressure).
+ **/
+class tsunami_lab::io::AsyncWriter {
+ private:
+  //! downsampled frames of one output
+  struct Slot {
+    Grid2d<t_real> m_h;
+    Grid2d<t_real> m_hu;
+    Grid2d<t_real> m_hv;
+    t_idx m_timeStep = 0;
+    t_real m_simTime = 0;
+  };
+
+  //! writer of the file, only used by the writer thread
+  NetCdf_Write &m_writer;
+
+  //! slots of frames
+  std::vector<Slot> m_slots;
+
+  //! ids of the free slots
+  std::deque<t_idx> m_free;
+
+  //! ids of the queued slots in the order of the outputs
+  std::deque<t_idx> m_queue;
+
+  //! queued writes of other files
+  std::deque<std::function<void()>> m_tasks;
+
+  //! number of queued or running tasks
+  t_idx m_nTasks = 0;
+
+  //! true if the writer thread finishes once the queue is empty
+  bool m_stop = false;
+
+  //! number of queued outputs
+  t_idx m_nWrites = 0;
+
+  //! number of outputs which waited for a free slot
+  t_idx m_nStalls = 0;
+
+  //! time the calling thread waited for free slots in seconds
+  double m_stallTime = 0;
+
+  //! time the writer thread spent writing in seconds
+  double m_writeTime = 0;
+
+  //! guards the queue, the free slots and the statistics
+  mutable std::mutex m_mutex;
+
+  //! signals queued slots to the writer thread
+  std::condition_variable m_queued;
+
+  //! signals freed slots to the calling thread
+  std::condition_variable m_freed;
+
+  //! writer thread
+  std::thread m_thread;
+
+  /**
+   * Writes the queued slots and runs the queued tasks until the writer is
+   *stopped.
+   **/
+  void run();
+
+ public:
+  /**
+   * Constructs the writer and starts the writer thread.
+   *
+   * @param io_writer writer of the file, must outlive the async writer.
+   * @param i_nSlots number of slots of frames, at least one; two overlap
+   *the writing of an output with the computation of the next one.
+   **/
+  AsyncWriter(NetCdf_Write &io_writer, t_idx i_nSlots = 2);
+
+  /**
+   * Writes the queued outputs and joins the writer thread.
+   **/
+  ~AsyncWriter();
+
+  AsyncWriter(AsyncWriter const &) = delete;
+  AsyncWriter &operator=(AsyncWriter const &) = delete;
+
+  /**
+   * Downsamples the heights and momenta into a free slot and queues it. Waits
+   *if no slot is free.
+   *
+   * @param i_h rows of the heights.
+   * @param i_hu rows of the momenta in x-direction.
+   * @param i_hv rows of the momenta in y-direction.
+   * @param i_timeStep id of the output.
+   * @param i_simTime simulation time of the output.
+   **/
+  void write(NetCdf_Write::RowSource const &i_h,
+             NetCdf_Write::RowSource const &i_hu,
+             NetCdf_Write::RowSource const &i_hv, t_idx i_timeStep,
+             t_real i_simTime);
+
+  /**
+   * Queues a task for the writer thread, e.g., the write of another NetCDF
+   *file. The NetCDF library is not thread-safe, thus no other thread may
+   *call it while the writer is active.
+   *
+   * @param i_task task, copies the data it writes.
+   **/
+  void post(std::function<void()> i_task);
+
+  /**
+   * Waits until all queued outputs are written and all tasks are done.
+   **/
+  void flush();
+
+  /**
+   * Gets the number of queued outputs.
+   *
+   * @return number of outputs.
+   **/
+  t_idx getNumWrites() const;
+
+  /**
+   * Gets the number of outputs which waited for a free slot.
+   *
+   * @return number of outputs.
+   **/
+  t_idx getNumStalls() const;
+
+  /**
+   * Gets the time the calling thread waited for free slots.
+   *
+   * @return time in seconds.
+   **/
+  double getStallTime() const;
+
+  /**
+   * Gets the time the writer thread spent writing.
+   *
+   * @return time in seconds.
+   **/
+  double getWriteTime() const;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the writer thread of the output.
+ **/
+#include <netcdf.h>
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "AsyncWriter.h"
+
+TEST_CASE("Test the writer thread of the output.", "[AsyncWriter]") {
+  /*
+   * Test case:
+   *
+   *   Frames of 4 x 3 cells whose values are the id of the output, written
+   *   through two slots. A task blocks the writer thread until both slots
+   *   are queued: the third output waits for the oldest slot, and a task
+   *   posted meanwhile runs before the queued slots. The destructor writes
+   *   the fourth output, the file holds the outputs in the order of their
+   *   ids.
+   */
+  tsunami_lab::t_idx l_nx = 4;
+  tsunami_lab::t_idx l_ny = 3;
+  char const *l_path = "AsyncWriter.test.nc";
+  std::vector<float> l_cells(l_nx * l_ny);
+  tsunami_lab::io::NetCdf_Write::RowSource l_rows =
+      [&l_cells, l_nx](tsunami_lab::t_idx i_iy, tsunami_lab::t_real *) {
+        return l_cells.data() + i_iy * l_nx;
+      };
+
+  {
+    tsunami_lab::io::NetCdf_Write l_writer(l_nx, l_ny, 1, 1, l_path);
+    tsunami_lab::io::AsyncWriter l_async(l_writer, 2);
+
+    // blocks the writer thread until it is released
+    std::promise<void> l_started;
+    std::promise<void> l_release;
+    std::shared_future<void> l_released = l_release.get_future().share();
+    l_async.post([&l_started, l_released] {
+      l_started.set_value();
+      l_released.wait();
+    });
+    l_started.get_future().wait();
+
+    for (tsunami_lab::t_idx l_id = 0; l_id < 2; l_id++) {
+      l_cells.assign(l_nx * l_ny, l_id);
+      l_async.write(l_rows, l_rows, l_rows, l_id, 10 * l_id);
+    }
+    REQUIRE(l_async.getNumStalls() == 0);
+
+    // all slots are queued, the third output waits
+    std::atomic<bool> l_written(false);
+    std::thread l_third([&] {
+      l_cells.assign(l_nx * l_ny, 2);
+      l_async.write(l_rows, l_rows, l_rows, 2, 20);
+      l_written = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE_FALSE(l_written);
+
+    // the task runs before the queued slots, no slot is freed while it runs
+    bool l_ahead = false;
+    l_async.post([&l_written, &l_ahead] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      l_ahead = !l_written;
+    });
+
+    l_release.set_value();
+    l_third.join();
+    l_async.flush();
+    REQUIRE(l_written);
+    REQUIRE(l_ahead);
+    REQUIRE(l_async.getNumWrites() == 3);
+    REQUIRE(l_async.getNumStalls() == 1);
+
+    // written by the destructor
+    l_cells.assign(l_nx * l_ny, 3);
+    l_async.write(l_rows, l_rows, l_rows, 3, 30);
+  }
+
+  int l_ncId = 0;
+  int l_timeId = 0;
+  int l_hId = 0;
+  REQUIRE(nc_open(l_path, NC_NOWRITE, &l_ncId) == NC_NOERR);
+  REQUIRE(nc_inq_varid(l_ncId, "seconds since", &l_timeId) == NC_NOERR);
+  REQUIRE(nc_inq_varid(l_ncId, "height", &l_hId) == NC_NOERR);
+
+  for (std::size_t l_id = 0; l_id < 4; l_id++) {
+    std::size_t l_start[3] = {l_id, 0, 0};
+    std::size_t l_count[3] = {1, l_ny, l_nx};
+    std::size_t l_one = 1;
+    float l_time = -1;
+    std::vector<float> l_frame(l_nx * l_ny, -1);
+    REQUIRE(nc_get_vara_float(l_ncId, l_timeId, l_start, &l_one, &l_time) ==
+            NC_NOERR);
+    REQUIRE(nc_get_vara_float(l_ncId, l_hId, l_start, l_count,
+                              l_frame.data()) == NC_NOERR);
+    REQUIRE(l_time == 10.0f * l_id);
+    for (std::size_t l_ce = 0; l_ce < l_nx * l_ny; l_ce++) {
+      REQUIRE(l_frame[l_ce] == l_id);
+    }
+  }
+
+  nc_close(l_ncId);
+  std::remove(l_path);
+}
@@ -102,12 +102,13 @@ tsunami_lab::io::NetCdf_Read::NetCdf_Read(t_idx rescale,const char *bathymetry_f
     l_displ_cellsize = (l_displ_max_value_x -l_displ_min_value_x) / (r_x_displ_length - 1);
 
 
-    l_b = new t_real[r_x_bath_length * r_y_bath_length];
-    l_d = new t_real[r_x_bath_length * r_y_bath_length];
+    // the files are read contiguously, thus the rows are not padded
+    l_b = Grid2d<t_real>(r_x_bath_length, r_y_bath_length, 0, r_x_bath_length);
+    l_d = Grid2d<t_real>(r_x_bath_length, r_y_bath_length, 0, r_x_bath_length);
 
     
-    read_bathymetry(l_b);
-    read_displacement(l_d);
+    read_bathymetry(l_b.data());
+    read_displacement(l_d.data());
 
     l_dxy = l_bath_cellsize*rescaleFactor;
     l_nx = r_x_bath_length/rescaleFactor;
@@ -115,24 +116,20 @@ tsunami_lab::io::NetCdf_Read::NetCdf_Read(t_idx rescale,const char *bathymetry_f
 
     if(rescaleFactor != 1){
         //save data temporarily
-        t_real *l_b_temp = l_b;
-        t_real *l_d_temp = l_d;
+        Grid2d<t_real> l_b_temp = std::move(l_b);
+        Grid2d<t_real> l_d_temp = std::move(l_d);
 
-        //new smaller array
-        l_b = new t_real[l_nx * l_ny];
-        l_d = new t_real[l_nx * l_ny];
+        //new smaller grid
+        l_b = Grid2d<t_real>(l_nx, l_ny, 0);
+        l_d = Grid2d<t_real>(l_nx, l_ny, 0);
 
         for(size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
             for (size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
-               l_b[l_ceX + l_ceY * l_nx] = l_b_temp[l_ceX*rescaleFactor + l_ceY*rescaleFactor * r_x_bath_length];
-               l_d[l_ceX + l_ceY * l_nx] = l_d_temp[l_ceX*rescaleFactor + l_ceY*rescaleFactor * r_x_bath_length];
+               l_b(l_ceX, l_ceY) = l_b_temp(l_ceX*rescaleFactor, l_ceY*rescaleFactor);
+               l_d(l_ceX, l_ceY) = l_d_temp(l_ceX*rescaleFactor, l_ceY*rescaleFactor);
             }
         }
 
-
-        delete[] l_b_temp;
-        delete[] l_d_temp;
-
     }
 }
 
@@ -140,6 +137,8 @@ tsunami_lab::io::NetCdf_Read::NetCdf_Read(t_idx rescale,const char *bathymetry_f
 
 
 
+tsunami_lab::io::NetCdf_Read::~NetCdf_Read() {}
+
 void tsunami_lab::io::NetCdf_Read::read_bathymetry(t_real *o_b){    
         std::cout << "reading Bathymetry Data" << std::endl;
         /*for(size_t l_ce= 0; l_ce < r_x_bath_length * r_y_bath_length; l_ce++){
@@ -163,8 +162,10 @@ void tsunami_lab::io::NetCdf_Read::read_displacement(t_real *o_d){
         if ((retval = nc_close(r_displ_ncid))) ERR(retval);
     }
     else{
-        float *i_d_temp = new float[r_x_displ_length * r_y_displ_length];
-        if ((retval = nc_get_var_float(r_displ_ncid, r_displ_z_varid, i_d_temp)))
+        Grid2d<float> i_d_temp(r_x_displ_length, r_y_displ_length, 0,
+                               r_x_displ_length, false);
+        if ((retval = nc_get_var_float(r_displ_ncid, r_displ_z_varid,
+                                       i_d_temp.data())))
             ERR(retval);
         if ((retval = nc_close(r_displ_ncid))) ERR(retval);
 
@@ -186,6 +187,5 @@ void tsunami_lab::io::NetCdf_Read::read_displacement(t_real *o_d){
                 }                
             }
         }
-        delete[] i_d_temp;
     }
 }
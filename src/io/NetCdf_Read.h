@@ -10,6 +10,7 @@
 #include <iostream>
 #include <string>
 
+#include "../Grid2d.h"
 #include "../constants.h"
 
 namespace tsunami_lab {
@@ -25,11 +26,11 @@ class tsunami_lab::io::NetCdf_Read {
     t_idx l_ny;
     t_real l_dxy;
 
-    //bathymetry array
-    t_real *l_b = nullptr;
+    //bathymetry grid without ghost cells
+    Grid2d<t_real> l_b;
 
-    //displacemet array
-    t_real *l_d = nullptr;
+    //displacemet grid without ghost cells
+    Grid2d<t_real> l_d;
 
     //for rescaling input Data
     t_idx rescaleFactor;
@@ -106,16 +107,30 @@ class tsunami_lab::io::NetCdf_Read {
         return l_dxy;
     }
 
+    /**
+     * x-coordinate of the left edge of the first cell
+    **/
+    t_real get_x_min(){
+        return l_bath_min_value_x - l_bath_cellsize / 2;
+    }
+
+    /**
+     * y-coordinate of the bottom edge of the first cell
+    **/
+    t_real get_y_min(){
+        return l_bath_min_value_y - l_bath_cellsize / 2;
+    }
+
     t_real get_i_b(t_idx i_x, t_idx i_y){
-        if(l_b[i_x+i_y*l_nx] == l_b[i_x+i_y*l_nx]){
-            return l_b[i_x+i_y*l_nx];
+        if(l_b(i_x, i_y) == l_b(i_x, i_y)){
+            return l_b(i_x, i_y);
         }
         return 0;
     }
 
     t_real get_i_d(t_idx i_x, t_idx i_y){
-        if(l_d[i_x+i_y*l_nx] == l_d[i_x+i_y*l_nx]){
-            return l_d[i_x+i_y*l_nx];
+        if(l_d(i_x, i_y) == l_d(i_x, i_y)){
+            return l_d(i_x, i_y);
         }
         return 0;
     }
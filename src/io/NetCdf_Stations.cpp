@@ -0,0 +1,181 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Time series of the stations in a NetCDF file.
+ **/
+#include "NetCdf_Stations.h"
+
+#include <netcdf.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <cstring>
+
+#define ERR(e) \
+  { printf("Error: %s\n", nc_strerror(e)); }
+
+/**
+ * Sets the units of a variable.
+ *
+ * @param i_ncid id of the file.
+ * @param i_varid id of the variable.
+ * @param i_units units.
+ **/
+static void putUnits(int i_ncid, int i_varid, char const *i_units) {
+  int l_retval = nc_put_att_text(i_ncid, i_varid, "units", strlen(i_units),
+                                 i_units);
+  if (l_retval) ERR(l_retval);
+}
+
+tsunami_lab::io::NetCdf_Stations::NetCdf_Stations(
+    char const *i_path, std::vector<Stations::Station> const &i_stations,
+    std::vector<t_real> const &i_b)
+    : m_nStations(i_stations.size()), m_b(i_b) {
+  int l_retval = 0;
+  if ((l_retval = nc_create(i_path, NC_CLOBBER, &m_ncid))) ERR(l_retval);
+
+  // the names are padded to the longest one
+  size_t l_nameLength = 1;
+  for (Stations::Station const &l_station : i_stations) {
+    l_nameLength = std::max(l_nameLength, l_station.m_name.size());
+  }
+
+  int l_stationDim = 0;
+  int l_nameDim = 0;
+  int l_timeDim = 0;
+  if ((l_retval = nc_def_dim(m_ncid, "station", m_nStations, &l_stationDim)))
+    ERR(l_retval);
+  if ((l_retval = nc_def_dim(m_ncid, "name_length", l_nameLength,
+                             &l_nameDim)))
+    ERR(l_retval);
+  if ((l_retval = nc_def_dim(m_ncid, "time", NC_UNLIMITED, &l_timeDim)))
+    ERR(l_retval);
+
+  int l_nameDims[2] = {l_stationDim, l_nameDim};
+  int l_nameVarid = 0;
+  int l_xVarid = 0;
+  int l_yVarid = 0;
+  int l_bVarid = 0;
+  if ((l_retval = nc_def_var(m_ncid, "station_name", NC_CHAR, 2, l_nameDims,
+                             &l_nameVarid)))
+    ERR(l_retval);
+  if ((l_retval = nc_def_var(m_ncid, "x", NC_FLOAT, 1, &l_stationDim,
+                             &l_xVarid)))
+    ERR(l_retval);
+  if ((l_retval = nc_def_var(m_ncid, "y", NC_FLOAT, 1, &l_stationDim,
+                             &l_yVarid)))
+    ERR(l_retval);
+  if ((l_retval = nc_def_var(m_ncid, "bathymetry", NC_FLOAT, 1,
+                             &l_stationDim, &l_bVarid)))
+    ERR(l_retval);
+  if ((l_retval = nc_def_var(m_ncid, "time", NC_FLOAT, 1, &l_timeDim,
+                             &m_timeVarid)))
+    ERR(l_retval);
+  putUnits(m_ncid, l_bVarid, "m");
+  putUnits(m_ncid, m_timeVarid, "s");
+
+  // the values of all stations of a record are contiguous
+  char const *l_names[4] = {"height", "momentum_x", "momentum_y",
+                            "sea_surface_height"};
+  char const *l_units[4] = {"m", "m^2/s", "m^2/s", "m"};
+  int l_seriesDims[2] = {l_timeDim, l_stationDim};
+  for (int l_va = 0; l_va < 4; l_va++) {
+    if ((l_retval = nc_def_var(m_ncid, l_names[l_va], NC_FLOAT, 2,
+                               l_seriesDims, &m_varids[l_va])))
+      ERR(l_retval);
+    putUnits(m_ncid, m_varids[l_va], l_units[l_va]);
+  }
+  if ((l_retval = nc_enddef(m_ncid))) ERR(l_retval);
+
+  std::vector<char> l_nameData(m_nStations * l_nameLength, '\0');
+  std::vector<t_real> l_x(m_nStations);
+  std::vector<t_real> l_y(m_nStations);
+  for (t_idx l_st = 0; l_st < m_nStations; l_st++) {
+    std::string const &l_name = i_stations[l_st].m_name;
+    std::copy(l_name.begin(), l_name.end(),
+              l_nameData.begin() + l_st * l_nameLength);
+    l_x[l_st] = i_stations[l_st].m_x;
+    l_y[l_st] = i_stations[l_st].m_y;
+  }
+  if (m_nStations > 0) {
+    if ((l_retval = nc_put_var_text(m_ncid, l_nameVarid, l_nameData.data())))
+      ERR(l_retval);
+    if ((l_retval = nc_put_var_float(m_ncid, l_xVarid, l_x.data())))
+      ERR(l_retval);
+    if ((l_retval = nc_put_var_float(m_ncid, l_yVarid, l_y.data())))
+      ERR(l_retval);
+    if ((l_retval = nc_put_var_float(m_ncid, l_bVarid, m_b.data())))
+      ERR(l_retval);
+  }
+}
+
+tsunami_lab::io::NetCdf_Stations::~NetCdf_Stations() {
+  int l_retval = 0;
+  if ((l_retval = nc_close(m_ncid))) ERR(l_retval);
+}
+
+void tsunami_lab::io::NetCdf_Stations::write(t_idx i_nRecords,
+                                             t_real const *i_records) {
+  if (i_nRecords == 0) return;
+
+  // one block of i_nRecords x m_nStations values per variable, the time
+  // series of the times follows
+  t_idx l_nValues = i_nRecords * m_nStations;
+  t_idx l_recordSize = 1 + 3 * m_nStations;
+  m_values.resize(4 * l_nValues + i_nRecords);
+  t_real *l_times = m_values.data() + 4 * l_nValues;
+
+  for (t_idx l_re = 0; l_re < i_nRecords; l_re++) {
+    t_real const *l_record = i_records + l_re * l_recordSize;
+    l_times[l_re] = l_record[0];
+
+    for (t_idx l_st = 0; l_st < m_nStations; l_st++) {
+      t_idx l_id = l_re * m_nStations + l_st;
+      m_values[l_id] = l_record[1 + l_st];
+      m_values[l_nValues + l_id] = l_record[1 + m_nStations + l_st];
+      m_values[2 * l_nValues + l_id] = l_record[1 + 2 * m_nStations + l_st];
+      m_values[3 * l_nValues + l_id] = l_record[1 + l_st] + m_b[l_st];
+    }
+  }
+
+  int l_retval = 0;
+  size_t l_start[2] = {m_nRecords, 0};
+  size_t l_count[2] = {i_nRecords, m_nStations};
+  if ((l_retval = nc_put_vara_float(m_ncid, m_timeVarid, l_start, l_count,
+                                    l_times)))
+    ERR(l_retval);
+  if (m_nStations > 0) {
+    for (int l_va = 0; l_va < 4; l_va++) {
+      if ((l_retval = nc_put_vara_float(m_ncid, m_varids[l_va], l_start,
+                                        l_count,
+                                        m_values.data() + l_va * l_nValues)))
+        ERR(l_retval);
+    }
+  }
+  m_nRecords += i_nRecords;
+}
@@ -0,0 +1,111 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Time series of the stations in a NetCDF file.
+ **/
+#ifndef TSUNAMI_LAB_IO_NETCDF_STATIONS_H
+#define TSUNAMI_LAB_IO_NETCDF_STATIONS_H
+
+#include <string>
+#include <vector>
+
+#include "../constants.h"
+#include "Stations.h"
+
+namespace tsunami_lab {
+namespace io {
+class NetCdf_Stations;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Writer of the time series of the stations.
+ *
+ * The file has the names, coordinates and bathymetry of the stations and
+ *per record the simulated time and the height, momenta and sea surface
+ *height of all stations. The records of several time steps are appended
+ *with a single call per variable.
+ **/
+class tsunami_lab::io::NetCdf_Stations {
+ private:
+  //! number of stations
+  t_idx m_nStations = 0;
+
+  //! bathymetry of the stations, added to the heights
+  std::vector<t_real> m_b;
+
+  //! number of written records
+  t_idx m_nRecords = 0;
+
+  //! records transposed to one variable after another
+  std::vector<t_real> m_values;
+
+  //! ids of the file and of its variables
+  int m_ncid = -1;
+  int m_timeVarid = -1;
+  int m_varids[4] = {-1, -1, -1, -1};
+
+ public:
+  /**
+   * Creates the file and writes the stations.
+   *
+   * @param i_path path of the file.
+   * @param i_stations stations.
+   * @param i_b bathymetry at the cells of the stations.
+   **/
+  NetCdf_Stations(char const *i_path,
+                  std::vector<Stations::Station> const &i_stations,
+                  std::vector<t_real> const &i_b);
+
+  /**
+   * Closes the file.
+   **/
+  ~NetCdf_Stations();
+
+  NetCdf_Stations(NetCdf_Stations const &) = delete;
+  NetCdf_Stations &operator=(NetCdf_Stations const &) = delete;
+
+  /**
+   * Appends records of the solver's ring buffer, see
+   *WavePropagation2d::getStationRecords.
+   *
+   * @param i_nRecords number of records.
+   * @param i_records simulated time, heights, momenta in x-direction and
+   *momenta in y-direction of all stations per record.
+   **/
+  void write(t_idx i_nRecords, t_real const *i_records);
+
+  /**
+   * Gets the number of written records.
+   *
+   * @return number of records.
+   **/
+  t_idx getNumRecords() const { return m_nRecords; }
+};
+
+#endif
@@ -6,15 +6,72 @@
 
 #include "NetCdf_Write.h"
 
+#include <netcdf_meta.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#if NC_HAS_ZSTD
+#include <netcdf_filter.h>
+#endif
+
 #define SECOND "s"
 #define METER "m"
 #define METER_PER_SECOND "m/s"
 #define ERR(e) \
   { printf("Error: %s\n", nc_strerror(e)); }
 
-tsunami_lab::io::NetCdf_Write::NetCdf_Write(t_idx i_nx, t_idx i_ny, t_idx i_rescaleFactor, t_real l_dxy) {
+/**
+ * Gets the size of a file.
+ *
+ * @param i_path path of the file.
+ * @return size in bytes, 0 if the file does not exist.
+ **/
+static double fileSize(std::string const &i_path) {
+  struct stat l_stat;
+  if (stat(i_path.c_str(), &l_stat) != 0) return 0;
+  return l_stat.st_size;
+}
+
+/**
+ * Reduces a value of a map of extremes into the reduction of other cells.
+ *
+ * @param i_reduced reduction of the other cells.
+ * @param i_value value of the cell.
+ * @param i_arrival true for arrival times, false for maxima.
+ * @return maximum or earliest non-negative arrival time, -1 if none.
+ **/
+static tsunami_lab::t_real reduceCells(tsunami_lab::t_real i_reduced,
+                                       tsunami_lab::t_real i_value,
+                                       bool i_arrival) {
+  if (!i_arrival) return std::max(i_reduced, i_value);
+  if (i_value >= 0 && (i_reduced < 0 || i_value < i_reduced)) return i_value;
+  return i_reduced;
+}
 
-l_rescaleFactor = i_rescaleFactor;
+tsunami_lab::io::NetCdf_Write::NetCdf_Write(t_idx i_nx, t_idx i_ny, t_idx i_rescaleFactor, t_real l_dxy,
+                                            char const *i_path, t_idx i_offsetX,
+                                            t_idx i_offsetY, int i_level,
+                                            int i_digits, bool i_extremes) {
+
+  l_rescaleFactor = i_rescaleFactor;
+  l_nx_in = i_nx;
+  l_level = std::max(i_level, 0);
+  l_digits = std::max(i_digits, 0);
+#ifndef NC_QUANTIZE_GRANULARBR
+  // the warning is printed once, not for every variable or file
+  static bool s_warned = false;
+  if (l_digits > 0 && !s_warned) {
+    std::cerr << "quantization requires netCDF 4.9, ignored" << std::endl;
+    s_warned = true;
+  }
+  l_digits = 0;
+#endif
+  l_netcdf4 = l_level > 0 || l_digits > 0;
+  l_codec = "none";
+  l_path = i_path;
 
 /////////////////////////////////////////
   /// Prepare writing data into a file ///
@@ -22,9 +79,14 @@ l_rescaleFactor = i_rescaleFactor;
 
   l_nx_out = (t_idx)(i_nx / l_rescaleFactor);
   l_ny_out = (t_idx)(i_ny / l_rescaleFactor);
+  // first touched by the threads downsampling the rows
+  l_frame = Grid2d<t_real>(l_nx_out, l_ny_out, 0, std::max(l_nx_out, t_idx(1)),
+                           false);
   int x_dim, y_dim, time_dim;
 
-  if ((retval = nc_create("solver.nc", NC_CLOBBER, &ncid))) ERR(retval);
+  // NetCDF-4 (HDF5) files support chunking, filters and quantization
+  int l_mode = l_netcdf4 ? (NC_CLOBBER | NC_NETCDF4) : NC_CLOBBER;
+  if ((retval = nc_create(i_path, l_mode, &ncid))) ERR(retval);
 
   // define the dimensions.
   if ((retval = nc_def_dim(ncid, "x", l_nx_out, &x_dim))) ERR(retval);
@@ -76,6 +138,51 @@ l_rescaleFactor = i_rescaleFactor;
            nc_def_var(ncid, "bathymetry", NC_FLOAT, 2, l_dimBath, &bath_varid)))
     ERR(retval);
 
+  // 2 dim maps of the extremes
+  if (i_extremes) {
+    if ((retval = nc_def_var(ncid, "max_amplitude", NC_FLOAT, 2, l_dimBath,
+                             &amp_varid)))
+      ERR(retval);
+    if ((retval = nc_def_var(ncid, "max_velocity", NC_FLOAT, 2, l_dimBath,
+                             &vel_varid)))
+      ERR(retval);
+    if ((retval = nc_def_var(ncid, "arrival_time", NC_FLOAT, 2, l_dimBath,
+                             &arr_varid)))
+      ERR(retval);
+
+    float l_none = -1;
+    if ((retval = nc_put_att_text(ncid, amp_varid, "units", strlen(METER),
+                                  METER)))
+      ERR(retval);
+    if ((retval = nc_put_att_text(ncid, vel_varid, "units",
+                                  strlen(METER_PER_SECOND), METER_PER_SECOND)))
+      ERR(retval);
+    if ((retval = nc_put_att_text(ncid, arr_varid, "units", strlen(SECOND),
+                                  SECOND)))
+      ERR(retval);
+    if ((retval = nc_put_att_float(ncid, arr_varid, "missing_value", NC_FLOAT,
+                                   1, &l_none)))
+      ERR(retval);
+  }
+
+  if (l_netcdf4) {
+    // chunks of whole rows, at most 4 MiB, i.e., a frame or a tile of it
+    t_idx l_nxChunk = std::max(l_nx_out, t_idx(1));
+    t_idx l_nyChunk = (t_idx(1) << 20) / l_nxChunk;
+    l_nyChunk = std::max(std::min(l_nyChunk, l_ny_out), t_idx(1));
+
+    size_t l_chunks[3] = {1, l_nyChunk, l_nxChunk};
+    defineStorage(h_varid, l_chunks);
+    defineStorage(hu_varid, l_chunks);
+    defineStorage(hv_varid, l_chunks);
+    defineStorage(bath_varid, l_chunks + 1);
+    if (i_extremes) {
+      defineStorage(amp_varid, l_chunks + 1);
+      defineStorage(vel_varid, l_chunks + 1);
+      defineStorage(arr_varid, l_chunks + 1);
+    }
+  }
+
   // assign units attributes to other variables
   if ((retval = nc_put_att_text(ncid, h_varid, "units", strlen(METER), METER)))
     ERR(retval);
@@ -96,10 +203,10 @@ l_rescaleFactor = i_rescaleFactor;
   t_real *l_posX = new t_real[l_nx_out];
   t_real *l_posY = new t_real[l_ny_out];
   for (t_idx l_iy = 0; l_iy < l_ny_out; l_iy++) {
-    l_posY[l_iy] = (l_iy + 0.5) * l_dxy * l_rescaleFactor;
+    l_posY[l_iy] = (l_iy + 0.5) * l_dxy * l_rescaleFactor + i_offsetY * l_dxy;
   }
   for (t_idx l_ix = 0; l_ix < l_nx_out; l_ix++) {
-    l_posX[l_ix] = (l_ix + 0.5) * l_dxy * l_rescaleFactor;
+    l_posX[l_ix] = (l_ix + 0.5) * l_dxy * l_rescaleFactor + i_offsetX * l_dxy;
   }
 
   // write the coordinate variable data
@@ -108,57 +215,219 @@ l_rescaleFactor = i_rescaleFactor;
 
   delete[] l_posX;
   delete[] l_posY;
+
+  if (l_netcdf4) {
+    if ((retval = nc_sync(ncid))) ERR(retval);
+    l_fileSize = fileSize(l_path);
+  }
 }
 
-tsunami_lab::io::NetCdf_Write::~NetCdf_Write() {
-    if ((retval = nc_close(ncid))) ERR(retval);
+void tsunami_lab::io::NetCdf_Write::defineStorage(int i_varid,
+                                                  size_t const *i_chunks) {
+  if ((retval = nc_def_var_chunking(ncid, i_varid, NC_CHUNKED, i_chunks)))
+    ERR(retval);
+
+#ifdef NC_QUANTIZE_GRANULARBR
+  if (l_digits > 0) {
+    // zeroes the insignificant bits, which compress well
+    if ((retval = nc_def_var_quantize(ncid, i_varid, NC_QUANTIZE_GRANULARBR,
+                                      l_digits)))
+      ERR(retval);
+  }
+#endif
+
+  if (l_level > 0) {
+    // the shuffle groups the bytes of the floats by significance
+#if NC_HAS_ZSTD
+    if ((retval = nc_def_var_deflate(ncid, i_varid, 1, 0, 0))) ERR(retval);
+    // the zstd filter is a plugin of HDF5, deflate is built in
+    if (nc_def_var_zstandard(ncid, i_varid, l_level) == NC_NOERR) {
+      l_codec = "zstd";
+      return;
+    }
+#endif
+    if ((retval =
+             nc_def_var_deflate(ncid, i_varid, 1, 1, std::min(l_level, 9))))
+      ERR(retval);
+    l_codec = "deflate";
+  }
 }
 
-void tsunami_lab::io::NetCdf_Write::writeArray(t_idx i_stride, t_real const *i_array,
-                                        t_idx i_timeStep, int i_varid) {
+void tsunami_lab::io::NetCdf_Write::putVariable(int i_var, int i_varid,
+                                                size_t const *i_start,
+                                                size_t const *i_count,
+                                                int i_nDims,
+                                                t_real const *i_data) {
+  std::chrono::steady_clock::time_point l_start =
+      std::chrono::steady_clock::now();
 
-    size_t start[3], count[3];
+  if ((retval = nc_put_vara_float(ncid, i_varid, i_start, i_count, i_data)))
+    ERR(retval);
 
-    // array count for data to write per time steps
-    count[0] = 1;
-    count[1] = 1;
-    count[2] = 1;
-    // array start for position displaceent in dimensions
-    start[0] = i_timeStep;
-    start[1] = 0;
-    start[2] = 0;
+  double l_bytes = sizeof(float);
+  for (int l_di = 0; l_di < i_nDims; l_di++) l_bytes *= i_count[l_di];
+
+  std::chrono::duration<double> l_duration =
+      std::chrono::steady_clock::now() - l_start;
+  l_rawBytes[i_var] += l_bytes;
+  l_writeTime[i_var] += l_duration.count();
+}
 
-    t_real l_cell_Value;
-    t_idx l_arrayPos;
+void tsunami_lab::io::NetCdf_Write::printStatistics(
+    std::ostream &io_stream) const {
+  char const *l_names[7] = {"height",       "momentum_x",    "momentum_y",
+                            "bathymetry",   "max_amplitude", "max_velocity",
+                            "arrival_time"};
+  double l_mib = 1 << 20;
+
+  io_stream << "  output compression:             " << l_codec;
+  if (l_digits > 0) io_stream << ", " << l_digits << " significant digits";
+  io_stream << std::endl;
+
+  double l_raw = 0;
+  for (int l_va = 0; l_va < 7; l_va++) {
+    if (l_rawBytes[l_va] == 0) continue;
+    l_raw += l_rawBytes[l_va];
+    std::string l_name = l_names[l_va];
+    l_name.resize(31, ' ');
+    io_stream << "  " << l_name << " " << l_rawBytes[l_va] / l_mib << " MiB, "
+              << l_rawBytes[l_va] / l_mib / l_writeTime[l_va] << " MiB/s"
+              << std::endl;
+  }
 
-    // write the computed data.
-    for (t_idx l_ceX = 0; l_ceX < l_nx_out; l_ceX++) {
-        for (t_idx l_ceY = 0; l_ceY < l_ny_out; l_ceY++) {
+  if (l_raw == 0) return;
 
-            l_cell_Value = 0;
+  // the filters run when the chunks are flushed, which is done once for the
+  // statistics instead of after every write
+  double l_stored = l_raw;
+  if (l_netcdf4) {
+    int l_retval = nc_sync(ncid);
+    if (l_retval) ERR(l_retval);
+    l_stored = fileSize(l_path) - l_fileSize;
+  }
+  io_stream << "  output stored:                  " << l_stored / l_mib
+            << " MiB, ratio " << l_raw / l_stored << std::endl;
+}
 
-            //iterate and average over the cells in one output cell
-            for (t_idx l_ix = 0; l_ix < l_rescaleFactor; l_ix++) {
-                for (t_idx l_iy = 0; l_iy < l_rescaleFactor; l_iy++) {
-                    l_arrayPos = (l_ceX * l_rescaleFactor + l_ix) +
-                        (l_ceY * l_rescaleFactor + l_iy)* i_stride;
-                    l_cell_Value += i_array[l_arrayPos];
+tsunami_lab::io::NetCdf_Write::~NetCdf_Write() {
+    if ((retval = nc_close(ncid))) ERR(retval);
+}
+
+void tsunami_lab::io::NetCdf_Write::downsample(t_idx i_nxOut, t_idx i_nyOut,
+                                               t_idx i_rescale, t_idx i_nx,
+                                               RowSource const &i_rows,
+                                               t_real *o_frame) {
+    t_idx l_nxIn = i_nxOut * i_rescale;
+    t_real l_nCells = i_rescale * i_rescale;
+
+#pragma omp parallel
+    {
+        // buffer of a row of the source and sum of the input rows of one
+        // output row
+        std::vector<t_real> l_buffer(i_nx);
+        std::vector<t_real> l_sum(l_nxIn);
+
+#pragma omp for schedule(static)
+        for (t_idx l_ceY = 0; l_ceY < i_nyOut; l_ceY++) {
+            t_real *l_out = o_frame + l_ceY * i_nxOut;
+            t_real const *l_in = i_rows(l_ceY * i_rescale, l_buffer.data());
+
+            if (i_rescale == 1) {
+                std::copy(l_in, l_in + i_nxOut, l_out);
+                continue;
+            }
+
+            // add up the rows, contiguous and vectorized
+            std::copy(l_in, l_in + l_nxIn, l_sum.data());
+            for (t_idx l_iy = 1; l_iy < i_rescale; l_iy++) {
+                t_real const *l_row =
+                    i_rows(l_ceY * i_rescale + l_iy, l_buffer.data());
+#pragma omp simd
+                for (t_idx l_ix = 0; l_ix < l_nxIn; l_ix++) {
+                    l_sum[l_ix] += l_row[l_ix];
                 }
             }
 
-            l_cell_Value /= (l_rescaleFactor * l_rescaleFactor);
-            start[1] = l_ceY;
-            start[2] = l_ceX;
+            // add up the columns of every block
+            for (t_idx l_ceX = 0; l_ceX < i_nxOut; l_ceX++) {
+                t_real l_cell_Value = 0;
+                for (t_idx l_ix = 0; l_ix < i_rescale; l_ix++) {
+                    l_cell_Value += l_sum[l_ceX * i_rescale + l_ix];
+                }
+                l_out[l_ceX] = l_cell_Value / l_nCells;
+            }
+        }
+    }
+}
 
-            if ((retval = nc_put_vara_float(ncid, i_varid, start, count, &l_cell_Value))) ERR(retval);
+void tsunami_lab::io::NetCdf_Write::downsample(t_idx i_nxOut, t_idx i_nyOut,
+                                               t_idx i_rescale, t_idx i_stride,
+                                               t_real const *i_array,
+                                               t_real *o_frame) {
+    downsample(i_nxOut, i_nyOut, i_rescale, 0,
+               [i_stride, i_array](t_idx i_iy, t_real *) {
+                   return i_array + i_iy * i_stride;
+               },
+               o_frame);
+}
 
+void tsunami_lab::io::NetCdf_Write::reduceBlocks(t_idx i_nxOut, t_idx i_nyOut,
+                                                 t_idx i_rescale, t_idx i_nx,
+                                                 RowSource const &i_rows,
+                                                 bool i_arrival,
+                                                 t_real *o_frame) {
+#pragma omp parallel
+    {
+        // buffer of a row of the source and the reduced rows of one output
+        // row
+        std::vector<t_real> l_buffer(i_nx);
+        std::vector<t_real> l_reduced(i_nxOut * i_rescale);
+
+#pragma omp for schedule(static)
+        for (t_idx l_ceY = 0; l_ceY < i_nyOut; l_ceY++) {
+            t_real *l_out = o_frame + l_ceY * i_nxOut;
+            std::fill(l_reduced.begin(), l_reduced.end(),
+                      i_arrival ? -1 : 0);
+
+            // reduce the rows, then the columns of every block
+            for (t_idx l_iy = 0; l_iy < i_rescale; l_iy++) {
+                t_real const *l_row =
+                    i_rows(l_ceY * i_rescale + l_iy, l_buffer.data());
+                for (t_idx l_ix = 0; l_ix < l_reduced.size(); l_ix++) {
+                    l_reduced[l_ix] =
+                        reduceCells(l_reduced[l_ix], l_row[l_ix], i_arrival);
+                }
+            }
+            for (t_idx l_ceX = 0; l_ceX < i_nxOut; l_ceX++) {
+                t_real l_cell_Value = i_arrival ? -1 : 0;
+                for (t_idx l_ix = 0; l_ix < i_rescale; l_ix++) {
+                    l_cell_Value = reduceCells(
+                        l_cell_Value, l_reduced[l_ceX * i_rescale + l_ix],
+                        i_arrival);
+                }
+                l_out[l_ceX] = l_cell_Value;
+            }
         }
     }
 }
 
-void tsunami_lab::io::NetCdf_Write::write(t_idx i_stride, t_real const *i_h,
-                                        t_real const *i_hu, t_real const *i_hv,
-                                        t_idx i_timeStep, t_real i_simTime) {
+void tsunami_lab::io::NetCdf_Write::writeArray(RowSource const &i_rows,
+                                               t_idx i_timeStep, int i_varid) {
+
+    // the whole frame is a single hyperslab of the time step
+    size_t start[3] = {i_timeStep, 0, 0};
+    size_t count[3] = {1, l_ny_out, l_nx_out};
+
+    downsample(l_nx_out, l_ny_out, l_rescaleFactor, l_nx_in, i_rows,
+               l_frame.data());
+    int l_var = (i_varid == h_varid) ? 0 : (i_varid == hu_varid) ? 1 : 2;
+    putVariable(l_var, i_varid, start, count, 3, l_frame.data());
+}
+
+void tsunami_lab::io::NetCdf_Write::write(RowSource const &i_h,
+                                          RowSource const &i_hu,
+                                          RowSource const &i_hv,
+                                          t_idx i_timeStep, t_real i_simTime) {
 
     size_t start[1], count[1];
 
@@ -171,39 +440,57 @@ void tsunami_lab::io::NetCdf_Write::write(t_idx i_stride, t_real const *i_h,
     if ((retval = nc_put_vara_float(ncid, time_varid, start, count, &i_simTime)))
         ERR(retval);
 
-    writeArray(i_stride, i_h, i_timeStep, h_varid);
-    writeArray(i_stride, i_hu, i_timeStep, hu_varid);
-    writeArray(i_stride, i_hv, i_timeStep, hv_varid);
+    writeArray(i_h, i_timeStep, h_varid);
+    writeArray(i_hu, i_timeStep, hu_varid);
+    writeArray(i_hv, i_timeStep, hv_varid);
     
 }
 
-void tsunami_lab::io::NetCdf_Write::writeBathymetry(t_idx i_stride,
-                                              t_real const *i_b) {
-
-
-    t_real l_cell_Value;
-    t_idx l_arrayPos;
-    size_t count[2] = {1,1};
-    size_t start[2] = {0,0};
-    //iterate over every cell in the output array
-    for (t_idx l_ceX = 0; l_ceX < l_nx_out; l_ceX++) {
-        for (t_idx l_ceY = 0; l_ceY < l_ny_out; l_ceY++) {
-
-            l_cell_Value = 0;
-            //iterate and average over the cells in one output cell
-            for (t_idx l_ix = 0; l_ix < l_rescaleFactor; l_ix++) {
-                for (t_idx l_iy = 0; l_iy < l_rescaleFactor; l_iy++) {
-                    l_arrayPos = (l_ceX * l_rescaleFactor + l_ix) +
-                        (l_ceY * l_rescaleFactor + l_iy)* i_stride;
-                    l_cell_Value += i_b[l_arrayPos];
-                }
-            }
+void tsunami_lab::io::NetCdf_Write::writeFrames(t_real const *i_h,
+                                                t_real const *i_hu,
+                                                t_real const *i_hv,
+                                                t_idx i_timeStep,
+                                                t_real i_simTime) {
 
-            l_cell_Value /= (l_rescaleFactor * l_rescaleFactor);
-            start[0] = l_ceY;
-            start[1] = l_ceX;
-            if ((retval = nc_put_vara_float(ncid, bath_varid, start, count, &l_cell_Value))) ERR(retval);
-        }
-    }
+    size_t start[3] = {i_timeStep, 0, 0};
+    size_t count[3] = {1, l_ny_out, l_nx_out};
+
+    // write time since start, the time is one-dimensional
+    size_t l_startTime[1] = {i_timeStep};
+    size_t l_countTime[1] = {1};
+    if ((retval = nc_put_vara_float(ncid, time_varid, l_startTime, l_countTime,
+                                    &i_simTime)))
+        ERR(retval);
+
+    putVariable(0, h_varid, start, count, 3, i_h);
+    putVariable(1, hu_varid, start, count, 3, i_hu);
+    putVariable(2, hv_varid, start, count, 3, i_hv);
 }
 
+void tsunami_lab::io::NetCdf_Write::writeBathymetry(RowSource const &i_b) {
+
+    size_t start[2] = {0, 0};
+    size_t count[2] = {l_ny_out, l_nx_out};
+
+    downsample(l_nx_out, l_ny_out, l_rescaleFactor, l_nx_in, i_b,
+               l_frame.data());
+    putVariable(3, bath_varid, start, count, 2, l_frame.data());
+}
+
+void tsunami_lab::io::NetCdf_Write::writeExtremes(RowSource const &i_ampMax,
+                                                  RowSource const &i_velMax,
+                                                  RowSource const &i_arrival) {
+
+    size_t start[2] = {0, 0};
+    size_t count[2] = {l_ny_out, l_nx_out};
+
+    reduceBlocks(l_nx_out, l_ny_out, l_rescaleFactor, l_nx_in, i_ampMax,
+                 false, l_frame.data());
+    putVariable(4, amp_varid, start, count, 2, l_frame.data());
+    reduceBlocks(l_nx_out, l_ny_out, l_rescaleFactor, l_nx_in, i_velMax,
+                 false, l_frame.data());
+    putVariable(5, vel_varid, start, count, 2, l_frame.data());
+    reduceBlocks(l_nx_out, l_ny_out, l_rescaleFactor, l_nx_in, i_arrival,
+                 true, l_frame.data());
+    putVariable(6, arr_varid, start, count, 2, l_frame.data());
+}
@@ -8,10 +8,13 @@
 #include <cmath>
 #include <iostream>
 #include <cstring>
+#include <functional>
+#include <string>
 
 
 
 #include "../constants.h"
+#include "../Grid2d.h"
 
 namespace tsunami_lab {
     namespace io {
@@ -20,16 +23,55 @@ namespace tsunami_lab {
 }  // namespace tsunami_lab
 
 class tsunami_lab::io::NetCdf_Write {
+ public:
+    /**
+     * Source of the rows of a quantity, which is called by several threads
+     *at once: gets the interior cells of a row, either the stored values or
+     *the values converted into the given buffer of a row.
+     **/
+    typedef std::function<t_real const*(t_idx i_iy, t_real* io_row)>
+        RowSource;
+
  private:
     t_idx l_rescaleFactor;
 
+    //number of cells in x-direction, i.e., the length of the rows of the
+    //sources
+    t_idx l_nx_in;
+
     //saves the length of the output array in the specific directions
     t_idx l_nx_out;
     t_idx l_ny_out;
 
+    //downsampled frame of one variable, written at once
+    Grid2d<t_real> l_frame;
+
     // saves errors
     int retval;
 
+    //compression level of the NetCDF-4 file, 0: uncompressed
+    int l_level;
+
+    //significant digits kept by the quantization, 0: all
+    int l_digits;
+
+    //true for a NetCDF-4 file instead of a classic one
+    bool l_netcdf4;
+
+    //compression of the variables: none, deflate or zstd
+    std::string l_codec;
+
+    //path of the file, its growth is the stored size of a NetCDF-4 file
+    std::string l_path;
+
+    //size of the NetCDF-4 file after the coordinates were written
+    double l_fileSize = 0;
+
+    //statistics of height, momentum_x, momentum_y, bathymetry,
+    //max_amplitude, max_velocity and arrival_time
+    double l_rawBytes[7] = {0, 0, 0, 0, 0, 0, 0};
+    double l_writeTime[7] = {0, 0, 0, 0, 0, 0, 0};
+
     //variables for writing
     int ncid;
     int h_varid;
@@ -39,18 +81,196 @@ class tsunami_lab::io::NetCdf_Write {
     int bath_varid;
     int w_x_varid;
     int w_y_varid;
+    int amp_varid = -1;
+    int vel_varid = -1;
+    int arr_varid = -1;
+
+    /**
+     * Chunks, quantizes and compresses a variable of the NetCDF-4 file.
+     *
+     * @param i_varid id of the variable.
+     * @param i_chunks shape of the chunks.
+     **/
+    void defineStorage(int i_varid, size_t const* i_chunks);
+
+    /**
+     * Writes a hyperslab of a variable and records its statistics.
+     *
+     * @param i_var id of the statistics: 0 height, 1 momentum_x, 2
+     *momentum_y, 3 bathymetry, 4 max_amplitude, 5 max_velocity, 6
+     *arrival_time.
+     * @param i_varid id of the variable.
+     * @param i_start first index of the hyperslab in every dimension.
+     * @param i_count size of the hyperslab in every dimension.
+     * @param i_nDims number of dimensions.
+     * @param i_data values of the hyperslab.
+     **/
+    void putVariable(int i_var, int i_varid, size_t const* i_start,
+                     size_t const* i_count, int i_nDims,
+                     t_real const* i_data);
 
  public:
-    NetCdf_Write(t_idx i_nx, t_idx i_ny, t_idx rescale, t_real l_dxy);
+    /**
+     * Creates the output file.
+     *
+     * @param i_nx number of cells in x-direction.
+     * @param i_ny number of cells in y-direction.
+     * @param rescale number of cells in each direction averaged to an output
+     *cell.
+     * @param l_dxy cell size.
+     * @param i_path path of the file.
+     * @param i_offsetX id of the first cell in x-direction, e.g., of the
+     *block of an MPI process.
+     * @param i_offsetY id of the first cell in y-direction.
+     * @param i_level compression level of a NetCDF-4 file with shuffled
+     *and compressed chunks, 0: uncompressed.
+     * @param i_digits significant digits kept by the quantization of a
+     *NetCDF-4 file, 0: all. A classic file is written if neither is set.
+     * @param i_extremes true if the file has the maps of the extremes, see
+     *writeExtremes.
+     **/
+    NetCdf_Write(t_idx i_nx, t_idx i_ny, t_idx rescale, t_real l_dxy,
+                 char const* i_path = "solver.nc", t_idx i_offsetX = 0,
+                 t_idx i_offsetY = 0, int i_level = 0, int i_digits = 0,
+                 bool i_extremes = false);
 
     ~NetCdf_Write();
 
-    void writeArray(t_idx i_stride, t_real const* i_array, t_idx i_timeStep, int i_varid);
+    /**
+     * Averages the blocks of rescale x rescale cells of a quantity into a
+     *contiguous frame. Every thread gathers the rows of its output rows
+     *from the source and sums them before the cells of the blocks are
+     *added.
+     *
+     * @param i_nxOut number of output cells in x-direction.
+     * @param i_nyOut number of output cells in y-direction.
+     * @param i_rescale number of cells in each direction averaged to an
+     *output cell.
+     * @param i_nx number of cells of a row of the source.
+     * @param i_rows source of the rows.
+     * @param o_frame will be set to the averages, rows of i_nxOut values.
+     **/
+    static void downsample(t_idx i_nxOut, t_idx i_nyOut, t_idx i_rescale,
+                           t_idx i_nx, RowSource const& i_rows,
+                           t_real* o_frame);
+
+    /**
+     * Averages the blocks of rescale x rescale cells of an array into a
+     *contiguous frame.
+     *
+     * @param i_nxOut number of output cells in x-direction.
+     * @param i_nyOut number of output cells in y-direction.
+     * @param i_rescale number of cells in each direction averaged to an
+     *output cell.
+     * @param i_stride stride of the rows of the array.
+     * @param i_array values of the cells, starting at the first interior one.
+     * @param o_frame will be set to the averages, rows of i_nxOut values.
+     **/
+    static void downsample(t_idx i_nxOut, t_idx i_nyOut, t_idx i_rescale,
+                           t_idx i_stride, t_real const* i_array,
+                           t_real* o_frame);
+
+    /**
+     * Reduces the blocks of rescale x rescale cells of a map of extremes into
+     *a contiguous frame: to the maximum or to the earliest non-negative
+     *arrival time, -1 if no cell of the block has one.
+     *
+     * @param i_nxOut number of output cells in x-direction.
+     * @param i_nyOut number of output cells in y-direction.
+     * @param i_rescale number of cells in each direction reduced to an output
+     *cell.
+     * @param i_nx number of cells of a row of the source.
+     * @param i_rows source of the rows.
+     * @param i_arrival true for arrival times, false for maxima.
+     * @param o_frame will be set to the reduced values, rows of i_nxOut
+     *values.
+     **/
+    static void reduceBlocks(t_idx i_nxOut, t_idx i_nyOut, t_idx i_rescale,
+                             t_idx i_nx, RowSource const& i_rows,
+                             bool i_arrival, t_real* o_frame);
+
+    void writeArray(RowSource const& i_rows, t_idx i_timeStep, int i_varid);
+
+    /**
+     * Writes the downsampled frames of a time step, e.g., by a writer thread.
+     *
+     * @param i_h frame of the heights, rows of getNxOut() values.
+     * @param i_hu frame of the momenta in x-direction.
+     * @param i_hv frame of the momenta in y-direction.
+     * @param i_timeStep id of the output.
+     * @param i_simTime simulation time of the output.
+     **/
+    void writeFrames(t_real const* i_h, t_real const* i_hu,
+                     t_real const* i_hv, t_idx i_timeStep, t_real i_simTime);
+
+    /**
+     * Downsamples and writes the heights and momenta of a time step.
+     *
+     * @param i_h rows of the heights.
+     * @param i_hu rows of the momenta in x-direction.
+     * @param i_hv rows of the momenta in y-direction.
+     * @param i_timeStep id of the output.
+     * @param i_simTime simulation time of the output.
+     **/
+    void write(RowSource const& i_h, RowSource const& i_hu,
+               RowSource const& i_hv, t_idx i_timeStep, t_real i_simTime);
+
+    /**
+     * Downsamples and writes the bathymetry.
+     *
+     * @param i_b rows of the bathymetry.
+     **/
+    void writeBathymetry(RowSource const& i_b);
+
+    /**
+     * Writes the maps of the extremes, overwrites the ones of earlier calls.
+     *
+     * @param i_ampMax rows of the maximum absolute sea surface heights.
+     * @param i_velMax rows of the maximum velocities.
+     * @param i_arrival rows of the arrival times, -1 if the wave did not
+     *arrive.
+     **/
+    void writeExtremes(RowSource const& i_ampMax, RowSource const& i_velMax,
+                       RowSource const& i_arrival);
+
+    /**
+     * Gets the number of output cells in x-direction.
+     *
+     * @return number of output cells.
+     **/
+    t_idx getNxOut() const { return l_nx_out; }
+
+    /**
+     * Gets the number of output cells in y-direction.
+     *
+     * @return number of output cells.
+     **/
+    t_idx getNyOut() const { return l_ny_out; }
+
+    /**
+     * Gets the number of cells in x-direction, i.e., of a row of a source.
+     *
+     * @return number of cells.
+     **/
+    t_idx getNxIn() const { return l_nx_in; }
 
-    void write(t_idx i_stride, t_real const* i_h, t_real const* i_hu,
-             t_real const* i_hv, t_idx i_timeStep, t_real i_simTime);
+    /**
+     * Gets the number of cells in each direction averaged to an output cell.
+     *
+     * @return rescale factor.
+     **/
+    t_idx getRescaleFactor() const { return l_rescaleFactor; }
 
-    void writeBathymetry(t_idx i_stride, t_real const* i_b);
+    /**
+     * Prints the written size and the write bandwidth of every variable and
+     *the stored size and compression ratio of all variables. The stored size
+     *of a NetCDF-4 file is the growth of the file since the coordinates were
+     *written, which includes the metadata of the chunks; the file is flushed
+     *once for it.
+     *
+     * @param io_stream stream to which the statistics are written.
+     **/
+    void printStatistics(std::ostream& io_stream) const;
 
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the downsampling of the output.
+ **/
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <vector>
+
+#include "NetCdf_Write.h"
+
+TEST_CASE("Test the downsampling of the output frames.", "[NetCdfWrite]") {
+  /*
+   * Test case:
+   *
+   *   7 x 5 cells with the value x + 10y in rows of a stride of 9, the two
+   *   padding cells of every row must not be read. The blocks of 2 x 2 cells
+   *   result in 3 x 2 output cells, the blocks of 3 x 3 cells in 2 x 1
+   *   output cells, the remaining columns and rows are dropped.
+   */
+  std::size_t l_nx = 7;
+  std::size_t l_ny = 5;
+  std::size_t l_stride = 9;
+  std::vector<float> l_array(l_stride * l_ny, 1.0E6f);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      l_array[l_ceX + l_ceY * l_stride] = l_ceX + 10.0f * l_ceY;
+    }
+  }
+
+  // blocks of 2 x 2 cells
+  std::vector<float> l_frame(3 * 2, -1);
+  tsunami_lab::io::NetCdf_Write::downsample(3, 2, 2, l_stride,
+                                            l_array.data(), l_frame.data());
+  for (std::size_t l_ceY = 0; l_ceY < 2; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < 3; l_ceX++) {
+      REQUIRE(l_frame[l_ceX + l_ceY * 3] ==
+              Approx(2 * l_ceX + 0.5f + 10 * (2 * l_ceY + 0.5f)));
+    }
+  }
+
+  // blocks of 3 x 3 cells
+  l_frame.assign(2, -1);
+  tsunami_lab::io::NetCdf_Write::downsample(2, 1, 3, l_stride,
+                                            l_array.data(), l_frame.data());
+  REQUIRE(l_frame[0] == Approx(1 + 10 * 1));
+  REQUIRE(l_frame[1] == Approx(4 + 10 * 1));
+
+  // a factor of one copies the cells
+  l_frame.assign(l_nx * l_ny, -1);
+  tsunami_lab::io::NetCdf_Write::downsample(l_nx, l_ny, 1, l_stride,
+                                            l_array.data(), l_frame.data());
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      REQUIRE(l_frame[l_ceX + l_ceY * l_nx] == l_ceX + 10.0f * l_ceY);
+    }
+  }
+}
+
+TEST_CASE("Test the reduction of the maps of the extremes.",
+          "[NetCdfWriteExtremes]") {
+  /*
+   * Test case:
+   *
+   *   7 x 5 cells with the value x + 10y, gathered row by row. The blocks of
+   *   2 x 2 cells are reduced to their maximum. Arrival times of three cells,
+   *   the others are -1: the blocks are reduced to their earliest arrival,
+   *   -1 if the wave did not arrive at any of their cells.
+   */
+  std::size_t l_nx = 7;
+  std::size_t l_ny = 5;
+  std::vector<float> l_array(l_nx * l_ny);
+  std::vector<float> l_arrival(l_nx * l_ny, -1);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      l_array[l_ceX + l_ceY * l_nx] = l_ceX + 10.0f * l_ceY;
+    }
+  }
+  l_arrival[1 + 0 * l_nx] = 5;
+  l_arrival[0 + 1 * l_nx] = 3;
+  l_arrival[3 + 3 * l_nx] = 7;
+
+  // the rows are converted into the buffer
+  tsunami_lab::io::NetCdf_Write::RowSource l_rows =
+      [&l_array, l_nx](std::size_t i_iy, float *io_row) {
+        std::copy(l_array.begin() + i_iy * l_nx,
+                  l_array.begin() + (i_iy + 1) * l_nx, io_row);
+        return io_row;
+      };
+  std::vector<float> l_frame(3 * 2, -2);
+  tsunami_lab::io::NetCdf_Write::reduceBlocks(3, 2, 2, l_nx, l_rows, false,
+                                              l_frame.data());
+  for (std::size_t l_ceY = 0; l_ceY < 2; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < 3; l_ceX++) {
+      REQUIRE(l_frame[l_ceX + l_ceY * 3] ==
+              2 * l_ceX + 1 + 10.0f * (2 * l_ceY + 1));
+    }
+  }
+
+  l_frame.assign(3 * 2, -2);
+  tsunami_lab::io::NetCdf_Write::reduceBlocks(
+      3, 2, 2, l_nx,
+      [&l_arrival, l_nx](std::size_t i_iy, float *) {
+        return l_arrival.data() + i_iy * l_nx;
+      },
+      true, l_frame.data());
+  REQUIRE(l_frame[0] == 3);
+  REQUIRE(l_frame[1] == -1);
+  REQUIRE(l_frame[2] == -1);
+  REQUIRE(l_frame[3] == -1);
+  REQUIRE(l_frame[4] == 7);
+  REQUIRE(l_frame[5] == -1);
+}
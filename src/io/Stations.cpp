@@ -0,0 +1,67 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * List of the stations, e.g., virtual tide gauges.
+ **/
+#include "Stations.h"
+
+#include <cmath>
+#include <sstream>
+
+bool tsunami_lab::io::Stations::read(std::istream &io_stream,
+                                     std::vector<Station> &o_stations) {
+  o_stations.clear();
+
+  std::string l_line;
+  while (std::getline(io_stream, l_line)) {
+    std::istringstream l_fields(l_line);
+    Station l_station;
+    if (!(l_fields >> l_station.m_name)) continue;
+    if (l_station.m_name[0] == '#') continue;
+
+    std::string l_rest;
+    if (!(l_fields >> l_station.m_x >> l_station.m_y) || (l_fields >> l_rest)) {
+      return false;
+    }
+    o_stations.push_back(l_station);
+  }
+  return true;
+}
+
+bool tsunami_lab::io::Stations::locate(Station const &i_station,
+                                       t_real i_xMin, t_real i_yMin,
+                                       t_real i_dxy, t_idx i_nx, t_idx i_ny,
+                                       t_idx &o_ix, t_idx &o_iy) {
+  double l_x = std::floor((double(i_station.m_x) - i_xMin) / i_dxy);
+  double l_y = std::floor((double(i_station.m_y) - i_yMin) / i_dxy);
+  if (!(l_x >= 0 && l_x < i_nx && l_y >= 0 && l_y < i_ny)) return false;
+
+  o_ix = t_idx(l_x);
+  o_iy = t_idx(l_y);
+  return true;
+}
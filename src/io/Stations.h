@@ -0,0 +1,90 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * List of the stations, e.g., virtual tide gauges.
+ **/
+#ifndef TSUNAMI_LAB_IO_STATIONS_H
+#define TSUNAMI_LAB_IO_STATIONS_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "../constants.h"
+
+namespace tsunami_lab {
+namespace io {
+class Stations;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Reads the stations of a text file and maps them to the cells of the grid.
+ *
+ * Every line of the file has the name and the x- and y-coordinate of a
+ *station, separated by whitespace. The coordinates are given in the ones of
+ *the input grid, e.g., metres or degrees of longitude and latitude. Empty
+ *lines and lines starting with # are skipped.
+ **/
+class tsunami_lab::io::Stations {
+ public:
+  //! station of the file
+  struct Station {
+    std::string m_name;
+    t_real m_x = 0;
+    t_real m_y = 0;
+  };
+
+  /**
+   * Reads the stations of a stream.
+   *
+   * @param io_stream stream of the station file.
+   * @param o_stations will be set to the stations in the order of the file.
+   * @return true if all lines were valid.
+   **/
+  static bool read(std::istream &io_stream, std::vector<Station> &o_stations);
+
+  /**
+   * Gets the cell of the grid containing a station.
+   *
+   * @param i_station station.
+   * @param i_xMin x-coordinate of the left edge of the grid.
+   * @param i_yMin y-coordinate of the bottom edge of the grid.
+   * @param i_dxy cell width.
+   * @param i_nx number of cells in x-direction.
+   * @param i_ny number of cells in y-direction.
+   * @param o_ix will be set to the id of the cell in x-direction.
+   * @param o_iy will be set to the id of the cell in y-direction.
+   * @return true if the station is inside the grid.
+   **/
+  static bool locate(Station const &i_station, t_real i_xMin, t_real i_yMin,
+                     t_real i_dxy, t_idx i_nx, t_idx i_ny, t_idx &o_ix,
+                     t_idx &o_iy);
+};
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the list of the stations.
+ **/
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "Stations.h"
+
+TEST_CASE("Test the reading of the stations.", "[Stations]") {
+  std::istringstream l_file(
+      "# name x y\n"
+      "\n"
+      "gauge_a 100 250.5\n"
+      "  gauge_b\t-20   3e2  \n");
+  std::vector<tsunami_lab::io::Stations::Station> l_stations;
+  REQUIRE(tsunami_lab::io::Stations::read(l_file, l_stations));
+
+  REQUIRE(l_stations.size() == 2);
+  REQUIRE(l_stations[0].m_name == "gauge_a");
+  REQUIRE(l_stations[0].m_x == Approx(100));
+  REQUIRE(l_stations[0].m_y == Approx(250.5));
+  REQUIRE(l_stations[1].m_name == "gauge_b");
+  REQUIRE(l_stations[1].m_x == Approx(-20));
+  REQUIRE(l_stations[1].m_y == Approx(300));
+
+  // missing and surplus coordinates
+  std::istringstream l_missing("gauge_a 100\n");
+  REQUIRE_FALSE(tsunami_lab::io::Stations::read(l_missing, l_stations));
+  std::istringstream l_surplus("gauge_a 100 200 300\n");
+  REQUIRE_FALSE(tsunami_lab::io::Stations::read(l_surplus, l_stations));
+}
+
+TEST_CASE("Test the cells of the stations.", "[StationsLocate]") {
+  tsunami_lab::io::Stations::Station l_station;
+  tsunami_lab::t_idx l_ix = 0;
+  tsunami_lab::t_idx l_iy = 0;
+
+  // grid of 10 x 5 cells of width 25, lower-left corner at (-100, 50)
+  l_station.m_x = -100;
+  l_station.m_y = 50;
+  REQUIRE(tsunami_lab::io::Stations::locate(l_station, -100, 50, 25, 10, 5,
+                                            l_ix, l_iy));
+  REQUIRE(l_ix == 0);
+  REQUIRE(l_iy == 0);
+
+  l_station.m_x = 37.5;
+  l_station.m_y = 174.9;
+  REQUIRE(tsunami_lab::io::Stations::locate(l_station, -100, 50, 25, 10, 5,
+                                            l_ix, l_iy));
+  REQUIRE(l_ix == 5);
+  REQUIRE(l_iy == 4);
+
+  // outside of the grid
+  l_station.m_x = 150;
+  REQUIRE_FALSE(tsunami_lab::io::Stations::locate(l_station, -100, 50, 25, 10,
+                                                  5, l_ix, l_iy));
+  l_station.m_x = 0;
+  l_station.m_y = 49;
+  REQUIRE_FALSE(tsunami_lab::io::Stations::locate(l_station, -100, 50, 25, 10,
+                                                  5, l_ix, l_iy));
+}
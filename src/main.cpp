@@ -30,6 +30,7 @@
  **/
 
 #include <netcdf.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <chrono>
@@ -37,15 +38,145 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
-#include <limits>
+#include <new>
+#include <string>
+#include <vector>
 
+#include "Affinity.h"
+#include "Arena.h"
 #include "io/NetCdf_Read.h"
+#include "io/AsyncWriter.h"
+#include "io/NetCdf_Stations.h"
 #include "io/NetCdf_Write.h"
+#include "io/Stations.h"
+#include "patches/PatchedDomain.h"
+#include "patches/SparseWavePropagation2d.h"
 #include "patches/WavePropagation2d.h"
 #include "patches/cuda_WavePropagation2d.h"
+#ifdef USE_MPI
+#include "patches/mpi_WavePropagation2d.h"
+#endif
 #include "setups/ArtificialTsunami.h"
 #include "setups/TsunamiEvent.h"
 
+/**
+ * Constructs the solver of a single patch with the given precision policy and
+ *configures its execution.
+ *
+ * @param i_precision name of the precision policy.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ * @param i_computeSteps number of time steps per output.
+ * @param i_inPlace true for the in-place sweeps of a single buffer.
+ * @param i_unsplit true for the unsplit scheme.
+ * @param i_tiled true for the tiled execution.
+ * @param io_tileSize tile size, will be set to the derived one if tiled.
+ * @param io_tileDepth time steps per tile, will be set to the derived one if
+ *tiled.
+ * @param i_balanced true if the rows are balanced.
+ * @param i_persistent true for the persistent parallel region.
+ * @param i_activityTileSize tile size of the activity tracking, 0: disabled.
+ * @param i_bathMin minimum bathymetry of the setup if it is quantized.
+ * @param i_bathMax maximum bathymetry of the setup if it is quantized.
+ * @return solver.
+ **/
+static tsunami_lab::patches::WavePropagation2dBase *constructPatch(
+    std::string const &i_precision, tsunami_lab::t_idx i_nx,
+    tsunami_lab::t_idx i_ny, tsunami_lab::t_idx i_computeSteps,
+    bool i_inPlace, bool i_unsplit, bool i_tiled,
+    tsunami_lab::t_idx &io_tileSize, tsunami_lab::t_idx &io_tileDepth,
+    bool i_balanced, bool i_persistent, tsunami_lab::t_idx i_activityTileSize,
+    tsunami_lab::t_real i_bathMin, tsunami_lab::t_real i_bathMax) {
+  tsunami_lab::patches::WavePropagation2dBase *l_waveProp2d =
+      tsunami_lab::patches::WavePropagation2dBase::create(i_precision, i_nx,
+                                                          i_ny, i_inPlace);
+  l_waveProp2d->setBathymetryRange(i_bathMin, i_bathMax);
+
+  // the flags of the other modes are rejected with the in-place sweeps
+  if (i_inPlace) {
+    std::cout << "  state:                          single buffer, in place"
+              << std::endl;
+  }
+  if (i_unsplit) {
+    l_waveProp2d->setUnsplit(true);
+    std::cout << "  scheme:                         unsplit" << std::endl;
+  }
+  if (i_tiled) {
+    l_waveProp2d->setTiling(true, io_tileSize, io_tileDepth);
+    l_waveProp2d->deriveTiling(i_computeSteps, io_tileSize, io_tileDepth);
+    std::cout << "  tile size:                      " << io_tileSize
+              << std::endl;
+    std::cout << "  time steps per tile:            " << io_tileDepth
+              << std::endl;
+  }
+  if (i_balanced) {
+    l_waveProp2d->setBalancing(true);
+    std::cout << "  row distribution:               balanced" << std::endl;
+  }
+  if (i_persistent) {
+    l_waveProp2d->setPersistent(true);
+    std::cout << "  parallel region:                persistent" << std::endl;
+  }
+  if (i_activityTileSize > 0) {
+    l_waveProp2d->setActivityTracking(true, i_activityTileSize);
+    std::cout << "  activity tile size:             " << i_activityTileSize
+              << std::endl;
+  }
+
+  return l_waveProp2d;
+}
+
+/**
+ * Checks that none of the flags which do not apply to a mode was given.
+ *
+ * @param i_given flags which were given.
+ * @param i_mode description of the mode, e.g., "-i".
+ * @param i_excluded flags which do not apply to the mode.
+ * @return true if the flags apply to the mode, otherwise an error is printed.
+ **/
+static bool checkFlags(std::string const &i_given, std::string const &i_mode,
+                       std::string const &i_excluded) {
+  for (char l_flag : i_excluded) {
+    if (i_given.find(l_flag) != std::string::npos) {
+      std::cerr << "-" << l_flag << " cannot be combined with " << i_mode
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Gets the rows of a quantity of the solver for the output, which are
+ *converted into the buffers of the writer if the solver stores them in a
+ *different precision.
+ *
+ * @param i_waveProp solver.
+ * @param i_quantity 0: height, 1: momentum in x-direction, 2: momentum in
+ *y-direction, 3: bathymetry, 4-6: extremes.
+ * @return source of the rows.
+ **/
+static tsunami_lab::io::NetCdf_Write::RowSource rowSource(
+    tsunami_lab::patches::WavePropagation *i_waveProp,
+    unsigned short i_quantity) {
+  return [i_waveProp, i_quantity](tsunami_lab::t_idx i_iy,
+                                  tsunami_lab::t_real *io_row) {
+    return i_waveProp->getRow(i_quantity, i_iy, io_row);
+  };
+}
+
+/**
+ * Writes the maps of the extremes accumulated by the solver.
+ *
+ * @param i_waveProp solver.
+ * @param io_write writer of the output, no other thread may write to it.
+ **/
+static void writeExtremes(tsunami_lab::patches::WavePropagation *i_waveProp,
+                          tsunami_lab::io::NetCdf_Write &io_write) {
+  io_write.writeExtremes(rowSource(i_waveProp, 4), rowSource(i_waveProp, 5),
+                         rowSource(i_waveProp, 6));
+}
+
 int main(int i_argc, char *i_argv[]) {
   // number of cells in x- and y-direction. Default for y-dimension is 1.
   tsunami_lab::t_idx l_nx = 0;
@@ -55,6 +186,57 @@ int main(int i_argc, char *i_argv[]) {
   tsunami_lab::t_idx l_computeSteps = 1;
   tsunami_lab::t_real l_endTime = 100;
 
+  // tiled execution with temporal blocking; 0: derived by the solver
+  bool l_tiled = false;
+  tsunami_lab::t_idx l_tileSize = 0;
+  tsunami_lab::t_idx l_tileDepth = 0;
+
+  // skipping of tiles at rest; 0: disabled
+  tsunami_lab::t_idx l_activityTileSize = 0;
+
+  // in-place sweeps of a single buffer instead of double buffering
+  bool l_inPlace = false;
+
+  // unsplit instead of dimensionally split scheme
+  bool l_unsplit = false;
+
+  // pinning of the threads to CPUs
+  bool l_pin = false;
+
+  // single parallel region for all steps of an output interval
+  bool l_persistent = false;
+
+  // distribution of the rows by their cost
+  bool l_balanced = false;
+
+  // number of patches of the decomposed domain; 0: single patch
+  tsunami_lab::t_idx l_nPatches = 0;
+
+  // sparse storage of the cells within a margin of water; -1: dense grid
+  int l_margin = -1;
+
+  // pages of the arena: faulted in (prefault) or locked (lock) on allocation
+  std::string l_memory = "lazy";
+
+  // outputs queued for the writer thread; 0: written by the time loop
+  tsunami_lab::t_idx l_nSlots = 2;
+
+  // compression level and significant digits of a NetCDF-4 output; 0: off
+  int l_level = 0;
+  int l_digits = 0;
+
+  // arrival threshold of the maps of the extremes; 0: no maps
+  tsunami_lab::t_real l_threshold = 0;
+
+  // frames of the heights and momenta in the output
+  bool l_frames = true;
+
+  // file of the stations sampled at every time step; empty: no stations
+  std::string l_stationPath;
+
+  // precision policy of the single patch: float, double, mixed, fp16 or bf16
+  std::string l_precision = "float";
+
   // set cell size
   tsunami_lab::t_real l_dxy = 1;
 
@@ -64,31 +246,221 @@ int main(int i_argc, char *i_argv[]) {
   std::cout << "### http://scalable.uni-jena.de ###" << std::endl;
   std::cout << "###################################" << std::endl;
 
-  if (i_argc != 5) {
+  // parse optional flags
+  int l_opt = 0;
+  std::string l_given;
+  while ((l_opt = getopt(i_argc, i_argv,
+                         "t:k:a:iupsbn:l:r:m:q:c:d:e:fg:")) != -1) {
+    l_given += (char)l_opt;
+    if (l_opt == 't') {
+      l_tiled = true;
+      l_tileSize = atoi(optarg);
+    } else if (l_opt == 'k') {
+      l_tileDepth = atoi(optarg);
+    } else if (l_opt == 'a') {
+      l_activityTileSize = atoi(optarg);
+    } else if (l_opt == 'i') {
+      l_inPlace = true;
+    } else if (l_opt == 'u') {
+      l_unsplit = true;
+    } else if (l_opt == 'p') {
+      l_pin = true;
+    } else if (l_opt == 's') {
+      l_persistent = true;
+    } else if (l_opt == 'b') {
+      l_balanced = true;
+    } else if (l_opt == 'n') {
+      l_nPatches = atoi(optarg);
+    } else if (l_opt == 'l') {
+      l_margin = std::max(atoi(optarg), 0);
+    } else if (l_opt == 'r') {
+      l_precision = optarg;
+    } else if (l_opt == 'm') {
+      l_memory = optarg;
+    } else if (l_opt == 'q') {
+      l_nSlots = std::max(atoi(optarg), 0);
+    } else if (l_opt == 'c') {
+      l_level = atoi(optarg);
+    } else if (l_opt == 'd') {
+      l_digits = atoi(optarg);
+    } else if (l_opt == 'e') {
+      l_threshold = std::max(atof(optarg), 0.0);
+    } else if (l_opt == 'f') {
+      l_frames = false;
+    } else if (l_opt == 'g') {
+      l_stationPath = optarg;
+    } else {
+      return EXIT_FAILURE;
+    }
+  }
+  bool l_compact = l_precision == "fp16" || l_precision == "bf16";
+  if (l_precision != "float" && l_precision != "double" &&
+      l_precision != "mixed" && !l_compact) {
+    std::cerr << "unknown precision " << l_precision
+              << ", use float, double, mixed, fp16 or bf16" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (l_memory != "lazy" && l_memory != "prefault" && l_memory != "lock") {
+    std::cerr << "unknown memory mode " << l_memory
+              << ", use lazy, prefault or lock" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // the flags of modes which the solver would not apply are rejected, every
+  // mode is checked against the modes it excludes; the default precision
+  // applies to every solver
+  if (l_precision == "float") {
+    l_given.erase(std::remove(l_given.begin(), l_given.end(), 'r'),
+                  l_given.end());
+  }
+  bool l_valid = true;
+  if (l_given.find('k') != std::string::npos && !l_tiled) {
+    std::cerr << "-k requires -t" << std::endl;
+    l_valid = false;
+  }
+  if (l_unsplit) l_valid = l_valid && checkFlags(l_given, "-u", "ta");
+  if (l_given.find('a') != std::string::npos) {
+    l_valid = l_valid && checkFlags(l_given, "-a", "t");
+  }
+  if (l_persistent) l_valid = l_valid && checkFlags(l_given, "-s", "uta");
+  if (l_balanced) l_valid = l_valid && checkFlags(l_given, "-b", "tas");
+  if (l_nPatches > 0) l_valid = l_valid && checkFlags(l_given, "-n", "tkasb");
+  if (l_given.find('r') != std::string::npos) {
+    l_valid = l_valid && checkFlags(l_given, "-r", "n");
+  }
+  if (l_margin >= 0) l_valid = l_valid && checkFlags(l_given, "-l", "utkasbrn");
+  if (l_inPlace) l_valid = l_valid && checkFlags(l_given, "-i", "utkasbnl");
+  // only the single patch samples the stations
+  if (!l_stationPath.empty()) {
+    l_valid = l_valid && checkFlags(l_given, "-g", "nl");
+  }
+#ifdef USE_MPI
+  // the processes advance their blocks with the plain split scheme in float
+  l_valid = l_valid && checkFlags(l_given, "MPI", "utkasbnrlig");
+#endif
+  if (!l_valid) return EXIT_FAILURE;
+
+  if (i_argc - optind != 4) {
     std::cerr << "invalid number of arguments, usage:" << std::endl;
+    std::cerr << "  ./build/tsunami_lab [-t TILE_SIZE] [-k DEPTH] [-a SIZE] "
+                 "[-i] [-u] [-p] [-s] [-b] [-n NPATCHES] [-l MARGIN] "
+                 "[-r PRECISION] [-m MEMORY] [-q SLOTS] [-c LEVEL] "
+                 "[-d DIGITS] [-e THRESHOLD] [-f] [-g STATIONS] RESCALE_IN "
+                 "RESCALE_OUT END_TIME COMPUTE_STEPS"
+              << std::endl;
+    std::cerr << "    -t TILE_SIZE computes the time steps tile by tile, 0 "
+                 "derives the size from the L2 cache"
+              << std::endl;
+    std::cerr << "    -k DEPTH     number of time steps a tile advances at "
+                 "once, 0 derives it from the tile size"
+              << std::endl;
+    std::cerr << "    -a SIZE      skips tiles of SIZE x SIZE cells whose "
+                 "water is at rest"
+              << std::endl;
+    std::cerr << "    -i           sweeps a single buffer of the state in "
+                 "place, halves the memory of the solver"
+              << std::endl;
+    std::cerr << "    -u           applies the x- and y-edges in a single "
+                 "traversal instead of two sweeps"
+              << std::endl;
+    std::cerr << "    -p           pins every thread to a CPU before the "
+                 "grids are allocated"
+              << std::endl;
+    std::cerr << "    -s           runs all steps between two outputs in a "
+                 "single parallel region"
+              << std::endl;
+    std::cerr << "    -b           distributes the rows by their number of wet "
+                 "edges, idle threads steal rows"
+              << std::endl;
+    std::cerr << "    -n NPATCHES  decomposes the domain into NPATCHES "
+                 "stripes of rows, one per thread"
+              << std::endl;
+    std::cerr << "    -l MARGIN    stores only the cells within MARGIN "
+                 "cells of water, at least one"
+              << std::endl;
+    std::cerr << "    -r PRECISION float, double, mixed (stored in float, "
+                 "computed in double), fp16 or bf16 (16-bit heights relative "
+                 "to the still water, 16-bit bathymetry)"
+              << std::endl;
+    std::cerr << "    -m MEMORY    lazy, prefault (faults the pages of the "
+                 "buffers in on allocation) or lock (locks them in memory)"
+              << std::endl;
+    std::cerr << "    -q SLOTS     outputs queued for the writer thread, 0 "
+                 "writes them in the time loop"
+              << std::endl;
+    std::cerr << "    -c LEVEL     writes a NetCDF-4 file with shuffled chunks "
+                 "compressed at LEVEL (zstd if available, else deflate)"
+              << std::endl;
+    std::cerr << "    -d DIGITS    quantizes the output of a NetCDF-4 file to "
+                 "DIGITS significant digits"
+              << std::endl;
+    std::cerr << "    -e THRESHOLD writes the maximum amplitude, the maximum "
+                 "velocity and the arrival time of the amplitude THRESHOLD"
+              << std::endl;
+    std::cerr << "    -f           writes no frames of the heights and "
+                 "momenta, the maps of -e with every output instead"
+              << std::endl;
+    std::cerr << "    -g STATIONS  samples the stations of the file (lines "
+                 "of name x y) at every time step into stations.nc"
+              << std::endl;
     return EXIT_FAILURE;
   } else {
-    l_rescaleFactor_input = atoi(i_argv[1]);
+    char **l_args = i_argv + optind - 1;
+
+    l_rescaleFactor_input = atoi(l_args[1]);
     if (l_rescaleFactor_input < 1) {
       std::cerr << "invalid input rescaleFactor" << std::endl;
       return EXIT_FAILURE;
     }
 
-    l_rescaleFactor_output = atoi(i_argv[2]);
+    l_rescaleFactor_output = atoi(l_args[2]);
     if (l_rescaleFactor_output < 1) {
       std::cerr << "invalid output rescaleFactor" << std::endl;
       return EXIT_FAILURE;
     }
-    l_endTime = atoi(i_argv[3]);
+    l_endTime = atoi(l_args[3]);
     if (l_endTime < 1) {
       std::cerr << "invalid seconds to compute" << std::endl;
     }
-    l_computeSteps = atoi(i_argv[4]);
+    l_computeSteps = atoi(l_args[4]);
     if (l_computeSteps < 1 || l_computeSteps > l_endTime) {
       std::cerr << "invalid computesteps" << std::endl;
     }
   }
 
+  std::vector<tsunami_lab::io::Stations::Station> l_stations;
+  if (!l_stationPath.empty()) {
+    std::ifstream l_stationFile(l_stationPath);
+    if (!l_stationFile ||
+        !tsunami_lab::io::Stations::read(l_stationFile, l_stations)) {
+      std::cerr << "invalid station file " << l_stationPath << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+#ifdef USE_MPI
+  // every process reads the input and writes the output of its block, only
+  // the first one reports
+  int l_provided = 0;
+  MPI_Init_thread(&i_argc, &i_argv, MPI_THREAD_FUNNELED, &l_provided);
+  int l_rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &l_rank);
+  if (l_rank != 0) std::cout.setstate(std::ios::failbit);
+#endif
+
+  // the large buffers of the input and the solver are taken from a single
+  // reservation backed by huge pages
+  tsunami_lab::Arena *l_arena = nullptr;
+  try {
+    l_arena = new tsunami_lab::Arena(0, l_memory == "prefault",
+                                     l_memory == "lock");
+    tsunami_lab::Arena::setGlobal(l_arena);
+  } catch (std::bad_alloc const &) {
+    std::cout << "  the arena cannot be reserved, the buffers are allocated "
+                 "separately"
+              << std::endl;
+  }
+
   // construct NetCdf-reader
   tsunami_lab::io::NetCdf_Read *l_netcdf_read;
   l_netcdf_read = new tsunami_lab::io::NetCdf_Read(
@@ -103,38 +475,166 @@ int main(int i_argc, char *i_argv[]) {
   std::cout << "  number of cells in y-direction: " << l_ny << std::endl;
   std::cout << "  cell size:                      " << l_dxy << std::endl;
 
-  tsunami_lab::io::NetCdf_Write *l_netcdf_write;
-  l_netcdf_write = new tsunami_lab::io::NetCdf_Write(
-      l_nx, l_ny, l_rescaleFactor_output, l_dxy);
-
   // construct setup
   tsunami_lab::setups::Setup *l_setup;
   // l_setup = new tsunami_lab::setups::TsunamiEvent(l_nx, l_netcdf_read);
   l_setup = new tsunami_lab::setups::ArtificialTsunami();
 
-  // construct solver
+  // pin the threads before the solver's grids are touched first
+  if (l_pin && !tsunami_lab::Affinity::pinThreads()) {
+    std::cout << "  threads are not pinned, the OpenMP binding is used"
+              << std::endl;
+  }
+  std::cout << "  thread placement (thread->cpu): "
+            << tsunami_lab::Affinity::describePlacement() << std::endl;
+
+  // construct solver, the modes of a single patch are set through the
+  // interface of its precision policies
   tsunami_lab::patches::WavePropagation *l_waveProp;
-  l_waveProp = new tsunami_lab::patches::WavePropagation2d(l_nx, l_ny);
+  tsunami_lab::patches::WavePropagation2dBase *l_waveProp2d = nullptr;
+
+  // block of the cells set up and written by this process
+  tsunami_lab::t_idx l_xFirst = 0;
+  tsunami_lab::t_idx l_yFirst = 0;
+  tsunami_lab::t_idx l_nxBlock = l_nx;
+  tsunami_lab::t_idx l_nyBlock = l_ny;
+  std::string l_outputPath = "solver.nc";
+
+#ifdef USE_MPI
+  tsunami_lab::patches::mpi_WavePropagation2d *l_waveProp2dMpi =
+      new tsunami_lab::patches::mpi_WavePropagation2d(l_nx, l_ny,
+                                                      MPI_COMM_WORLD);
+  l_waveProp = l_waveProp2dMpi;
+  l_xFirst = l_waveProp2dMpi->getXFirst();
+  l_yFirst = l_waveProp2dMpi->getYFirst();
+  l_nxBlock = l_waveProp2dMpi->getNx();
+  l_nyBlock = l_waveProp2dMpi->getNy();
+  l_outputPath =
+      "solver_" + std::to_string(l_waveProp2dMpi->getRank()) + ".nc";
+
+  int l_nRanks = 1;
+  MPI_Comm_size(MPI_COMM_WORLD, &l_nRanks);
+  std::cout << "  MPI processes:                  " << l_nRanks << std::endl;
+
+  // the processes advance their blocks with the split scheme
+  // the tiles were rejected with MPI
+  (void)l_tileSize;
+  (void)l_tileDepth;
+#else
+  if (l_nPatches > 0) {
+    // the patches are advanced with the plain sweeps or the unsplit scheme
+    tsunami_lab::patches::PatchedDomain *l_domain =
+        new tsunami_lab::patches::PatchedDomain(l_nx, l_ny, l_nPatches);
+    for (tsunami_lab::t_idx l_pa = 0; l_pa < l_domain->getNumPatches();
+         l_pa++) {
+      l_domain->getPatch(l_pa).setUnsplit(l_unsplit);
+    }
+    l_waveProp = l_domain;
+    std::cout << "  patches:                        "
+              << l_domain->getNumPatches() << std::endl;
+    if (l_unsplit) {
+      std::cout << "  scheme:                         unsplit" << std::endl;
+    }
+  } else if (l_margin >= 0) {
+    // the land cells far from water are dropped by the plain sweeps
+    tsunami_lab::patches::SparseWavePropagation2d *l_sparse =
+        new tsunami_lab::patches::SparseWavePropagation2d(l_nx, l_ny,
+                                                          *l_setup, l_margin);
+    l_waveProp = l_sparse;
+    std::cout << "  stored cells:                   "
+              << l_sparse->getNumCells() << " of "
+              << (l_nx + 2) * (l_ny + 2) << " in "
+              << l_sparse->getNumSpans() << " spans" << std::endl;
+  } else {
+    // the quantized bathymetry covers the range of the setup
+    tsunami_lab::t_real l_bathMin = -11000;
+    tsunami_lab::t_real l_bathMax = 11000;
+    if (l_compact) {
+      l_bathMin = l_bathMax = l_setup->getBathymetry(0, 0);
+#pragma omp parallel for reduction(min : l_bathMin) reduction(max : l_bathMax)
+      for (tsunami_lab::t_idx l_cy = 0; l_cy < l_ny; l_cy++) {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nx; l_cx++) {
+          tsunami_lab::t_real l_b = l_setup->getBathymetry(l_cx, l_cy);
+          l_bathMin = std::min(l_bathMin, l_b);
+          l_bathMax = std::max(l_bathMax, l_b);
+        }
+      }
+    }
 
-  // maximum observed height in the setup
-  tsunami_lab::t_real l_hMax =
-      std::numeric_limits<tsunami_lab::t_real>::lowest();
+    l_waveProp2d = constructPatch(
+        l_precision, l_nx, l_ny, l_computeSteps, l_inPlace, l_unsplit,
+        l_tiled, l_tileSize, l_tileDepth, l_balanced, l_persistent,
+        l_activityTileSize, l_bathMin, l_bathMax);
+    l_waveProp = l_waveProp2d;
+  }
+#endif
+  std::cout << "  precision:                      " << l_precision
+            << std::endl;
+
+  // the solver accumulates the extremes after every time step
+  if (l_threshold > 0) {
+    if (l_waveProp->setExtremes(true, l_threshold, l_dxy)) {
+      std::cout << "  arrival threshold:              " << l_threshold
+                << std::endl;
+    } else {
+      std::cout << "  -e is not supported by the solver, ignored"
+                << std::endl;
+      l_threshold = 0;
+    }
+  }
+
+  // the stations are mapped once to the cells of a single patch, the
+  // ones outside of the grid are dropped
+  std::vector<tsunami_lab::t_idx> l_stationX;
+  std::vector<tsunami_lab::t_idx> l_stationY;
+  if (!l_stationPath.empty()) {
+    std::vector<tsunami_lab::io::Stations::Station> l_inside;
+    for (tsunami_lab::io::Stations::Station const &l_station : l_stations) {
+      tsunami_lab::t_idx l_ix = 0;
+      tsunami_lab::t_idx l_iy = 0;
+      if (tsunami_lab::io::Stations::locate(
+              l_station, l_netcdf_read->get_x_min(),
+              l_netcdf_read->get_y_min(), l_dxy, l_nx, l_ny, l_ix, l_iy)) {
+        l_inside.push_back(l_station);
+        l_stationX.push_back(l_ix);
+        l_stationY.push_back(l_iy);
+      } else {
+        std::cout << "  station " << l_station.m_name
+                  << " is outside of the grid, ignored" << std::endl;
+      }
+    }
+    l_stations.swap(l_inside);
+
+    l_waveProp2d->setStations(l_stations.size(), l_stationX.data(),
+                              l_stationY.data(), l_computeSteps);
+    std::cout << "  stations:                       " << l_stations.size()
+              << std::endl;
+  }
+
+  tsunami_lab::io::NetCdf_Write *l_netcdf_write;
+  l_netcdf_write = new tsunami_lab::io::NetCdf_Write(
+      l_nxBlock, l_nyBlock, l_rescaleFactor_output, l_dxy,
+      l_outputPath.c_str(), l_xFirst, l_yFirst, l_level, l_digits,
+      l_threshold > 0);
 
   std::cout << "start reading setup values " << std::endl;
 
   using namespace std::chrono;
 
   // set up solver
-#pragma omp parallel for simd schedule(static, 4)
-  for (tsunami_lab::t_idx l_cy = 0; l_cy < l_ny; l_cy++) {
+  l_waveProp->setReflection(0, false, false);
+
+#pragma omp parallel for schedule(static, 4)
+  for (tsunami_lab::t_idx l_cy = l_yFirst; l_cy < l_yFirst + l_nyBlock;
+       l_cy++) {
     // tsunami_lab::t_real l_y = l_cy * l_dxy;
 
-    for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nx; l_cx++) {
+    for (tsunami_lab::t_idx l_cx = l_xFirst; l_cx < l_xFirst + l_nxBlock;
+         l_cx++) {
       // tsunami_lab::t_real l_x = l_cx * l_dxy;
 
       // get initial values of the setup
       tsunami_lab::t_real l_h = l_setup->getHeight(l_cx, l_cy);
-      l_hMax = std::max(l_h, l_hMax);
 
       tsunami_lab::t_real l_hu = l_setup->getMomentumX(l_cx, l_cy);
       tsunami_lab::t_real l_hv = l_setup->getMomentumY(l_cx, l_cy);
@@ -149,10 +649,9 @@ int main(int i_argc, char *i_argv[]) {
       l_waveProp->setMomentumY(l_cx, l_cy, l_hv);
 
       l_waveProp->setBathymetry(l_cx, l_cy, l_b);
-
-      l_waveProp->setReflection(0, false, false);
     }
   }
+  l_waveProp->finishSetup();
 
   l_waveProp->MemTransfer();
 
@@ -161,19 +660,45 @@ int main(int i_argc, char *i_argv[]) {
 
   tsunami_lab::t_real l_simTime = 0;
 
-  std::cout << "l_hMax " << l_hMax << std::endl;
-  // initialize the timescaling the momentum is ignored in the first step
-  tsunami_lab::t_real l_speedMax = std::sqrt(9.81 * l_hMax);
+  // write bathymetry data
+  l_netcdf_write->writeBathymetry(rowSource(l_waveProp, 3));
+
+  // footprint of the buffers allocated so far
+  if (l_arena != nullptr) {
+    double l_mib = 1 << 20;
+    std::cout << "  memory footprint:               "
+              << l_arena->getFootprint() / l_mib << " MiB (peak "
+              << l_arena->getPeak() / l_mib << " MiB)" << std::endl;
+    std::cout << "  huge pages:                     "
+              << (l_arena->usesHugePages() ? "transparent" : "unavailable")
+              << std::endl;
+    std::cout << "  pages:                          " << l_memory
+              << (l_arena->lockFailed() ? ", locking failed" : "")
+              << std::endl;
+  }
 
-  // derive constant time step; changes at simulation time are ignored
-  tsunami_lab::t_real l_dt = 0.5 * l_dxy / l_speedMax;
-  std::cout << "l_dt " << l_dt << std::endl;
-  // derive scaling for a time step
-  tsunami_lab::t_real l_scaling = l_dt / l_dxy;
+  // time series of the stations with the bathymetry of their cells
+  tsunami_lab::io::NetCdf_Stations *l_stationWrite = nullptr;
+  std::vector<tsunami_lab::t_real> l_stationRecords;
+  tsunami_lab::t_idx l_stationsDropped = 0;
+  if (!l_stationPath.empty()) {
+    std::vector<tsunami_lab::t_real> l_stationB(l_stations.size());
+    std::vector<tsunami_lab::t_real> l_row(l_nxBlock);
+    for (tsunami_lab::t_idx l_st = 0; l_st < l_stations.size(); l_st++) {
+      l_stationB[l_st] = l_waveProp->getRow(3, l_stationY[l_st],
+                                            l_row.data())[l_stationX[l_st]];
+    }
+    l_stationWrite = new tsunami_lab::io::NetCdf_Stations(
+        "stations.nc", l_stations, l_stationB);
+  }
 
-  // write bathymetry data
-  l_netcdf_write->writeBathymetry(l_waveProp->getStride(),
-                                  l_waveProp->getBathymetry());
+  // the writer thread overlaps the outputs with the time steps
+  tsunami_lab::io::AsyncWriter *l_asyncWrite = nullptr;
+  if (l_nSlots > 0 && l_frames) {
+    l_asyncWrite = new tsunami_lab::io::AsyncWriter(*l_netcdf_write, l_nSlots);
+    std::cout << "  output:                         writer thread, "
+              << l_nSlots << " slots" << std::endl;
+  }
 
   std::cout << "entering time loop" << std::endl;
   // iterate over time
@@ -181,20 +706,82 @@ int main(int i_argc, char *i_argv[]) {
     std::cout << "  simulation time / #time steps: " << l_simTime << " / "
               << l_timeStep << std::endl;
 
-    l_netcdf_write->write(l_waveProp->getStride(), l_waveProp->getHeight(),
-                          l_waveProp->getMomentumX(),
-                          l_waveProp->getMomentumY(), l_timeStep, l_simTime);
+    if (!l_frames) {
+      // periodic maps of the extremes, the last ones are written at the end
+      if (l_threshold > 0) writeExtremes(l_waveProp, *l_netcdf_write);
+    } else if (l_asyncWrite != nullptr) {
+      l_asyncWrite->write(rowSource(l_waveProp, 0), rowSource(l_waveProp, 1),
+                          rowSource(l_waveProp, 2), l_timeStep, l_simTime);
+    } else {
+      l_netcdf_write->write(rowSource(l_waveProp, 0), rowSource(l_waveProp, 1),
+                            rowSource(l_waveProp, 2), l_timeStep, l_simTime);
+    }
+
+    // the solver derives the largest stable time step of each step
+    tsunami_lab::t_real l_time =
+        l_waveProp->timeStepAdaptive(l_dxy, l_computeSteps);
+    std::cout << "  mean time step:                 "
+              << l_time / l_computeSteps << std::endl;
+
+    // the records of the steps are appended by the writer thread if it
+    // is active, the NetCDF library is not thread-safe
+    if (l_stationWrite != nullptr) {
+      l_stationRecords.clear();
+      l_waveProp2d->getStationRecords(l_stationRecords);
+      l_stationsDropped = l_waveProp2d->getStationsDropped();
+      tsunami_lab::t_idx l_nRecords =
+          l_stationRecords.size() / (1 + 3 * l_stations.size());
+      if (l_asyncWrite != nullptr) {
+        l_asyncWrite->post([l_stationWrite, l_nRecords, l_stationRecords]() {
+          l_stationWrite->write(l_nRecords, l_stationRecords.data());
+        });
+      } else {
+        l_stationWrite->write(l_nRecords, l_stationRecords.data());
+      }
+    }
+    if (l_waveProp2d != nullptr) {
+      if (l_activityTileSize > 0) {
+        std::cout << "  fraction of active tiles:       "
+                  << l_waveProp2d->getActiveFraction() << std::endl;
+      }
+      std::cout << "  load imbalance of the sweeps:   "
+                << l_waveProp2d->getLoadImbalance() << std::endl;
+    }
 
-    l_waveProp->timeStep(l_scaling, l_computeSteps);
     l_timeStep++;
-    l_simTime += l_dt * l_computeSteps;
+    l_simTime += l_time;
+  }
+  std::cout << "  number of time steps:           "
+            << l_timeStep * l_computeSteps << std::endl;
+  if (l_asyncWrite != nullptr) {
+    l_asyncWrite->flush();
+    std::cout << "  outputs waiting for a slot:     "
+              << l_asyncWrite->getNumStalls() << " of "
+              << l_asyncWrite->getNumWrites() << ", "
+              << l_asyncWrite->getStallTime() << " s" << std::endl;
+    std::cout << "  time of the writer thread:      "
+              << l_asyncWrite->getWriteTime() << " s" << std::endl;
+  }
+  if (l_threshold > 0) writeExtremes(l_waveProp, *l_netcdf_write);
+  if (l_stationWrite != nullptr) {
+    std::cout << "  records of the stations:        "
+              << l_stationWrite->getNumRecords() << ", " << l_stationsDropped
+              << " dropped" << std::endl;
   }
+  l_netcdf_write->printStatistics(std::cout);
 
   // free memory
   std::cout << "freeing memory" << std::endl;
   delete l_setup;
   delete l_waveProp;
+  delete l_asyncWrite;
+  delete l_stationWrite;
   delete l_netcdf_write;
+  delete l_netcdf_read;
+  delete l_arena;
+#ifdef USE_MPI
+  MPI_Finalize();
+#endif
 
   std::cout << "finished, exiting" << std::endl;
   return EXIT_SUCCESS;
@@ -0,0 +1,231 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Domain decomposed into patches of rows which exchange halos.
+ **/
+#include "PatchedDomain.h"
+
+#include <algorithm>
+
+tsunami_lab::patches::PatchedDomain::PatchedDomain(t_idx i_xCells,
+                                                   t_idx i_yCells,
+                                                   t_idx i_nPatches) {
+  m_xCells = i_xCells;
+  m_yCells = i_yCells;
+
+  // every patch has at least one row
+  t_idx l_nPatches = std::max(std::min(i_nPatches, m_yCells), (t_idx)1);
+  m_rowFirst.resize(l_nPatches + 1);
+  for (t_idx l_pa = 0; l_pa <= l_nPatches; l_pa++) {
+    m_rowFirst[l_pa] = (m_yCells * l_pa) / l_nPatches;
+  }
+
+  // the patches are allocated by the threads working on them
+  m_patches.resize(l_nPatches, nullptr);
+#pragma omp parallel for schedule(static)
+  for (t_idx l_pa = 0; l_pa < l_nPatches; l_pa++) {
+    m_patches[l_pa] = new WavePropagation2d<>(
+        m_xCells, m_rowFirst[l_pa + 1] - m_rowFirst[l_pa]);
+  }
+
+  m_h = Grid2d<t_real>(m_xCells, m_yCells);
+  m_hu = Grid2d<t_real>(m_xCells, m_yCells, 1, m_h.getStride());
+  m_hv = Grid2d<t_real>(m_xCells, m_yCells, 1, m_h.getStride());
+  m_b = Grid2d<t_real>(m_xCells, m_yCells, 1, m_h.getStride());
+}
+
+tsunami_lab::patches::PatchedDomain::~PatchedDomain() {
+  for (t_idx l_pa = 0; l_pa < m_patches.size(); l_pa++) {
+    delete m_patches[l_pa];
+  }
+}
+
+tsunami_lab::t_idx tsunami_lab::patches::PatchedDomain::findPatch(
+    t_idx i_iy) const {
+  return std::upper_bound(m_rowFirst.begin(), m_rowFirst.end(), i_iy) -
+         m_rowFirst.begin() - 1;
+}
+
+void tsunami_lab::patches::PatchedDomain::exchangeHalos(t_idx i_pa) {
+  WavePropagation2d<> &l_patch = *m_patches[i_pa];
+  t_idx l_nRows = m_rowFirst[i_pa + 1] - m_rowFirst[i_pa];
+
+  // last row of the patch below and first row of the patch above
+  if (i_pa > 0) {
+    t_idx l_nRowsB = m_rowFirst[i_pa] - m_rowFirst[i_pa - 1];
+    m_patches[i_pa - 1]->copyRowTo(l_nRowsB, l_patch, 0,
+                                   !m_halosBathymetryValid);
+  }
+  if (i_pa + 1 < m_patches.size()) {
+    m_patches[i_pa + 1]->copyRowTo(1, l_patch, l_nRows + 1,
+                                   !m_halosBathymetryValid);
+  }
+}
+
+void tsunami_lab::patches::PatchedDomain::initOutflow(t_idx i_pa,
+                                                      bool i_first) {
+  bool l_bottom = i_first && i_pa == 0;
+  bool l_top = i_first && i_pa + 1 == m_patches.size();
+
+  m_patches[i_pa]->setOutflow(i_first, i_first, l_bottom, l_top);
+}
+
+tsunami_lab::t_real tsunami_lab::patches::PatchedDomain::patchStep(
+    t_real i_scaling, bool i_first) {
+  t_idx l_nPatches = m_patches.size();
+  t_real l_speedMax = 0;
+
+  // the same static schedule keeps every patch on the thread which touched
+  // it first, the halos are complete before any patch is advanced
+#pragma omp parallel
+  {
+#pragma omp for schedule(static)
+    for (t_idx l_pa = 0; l_pa < l_nPatches; l_pa++) exchangeHalos(l_pa);
+
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+    for (t_idx l_pa = 0; l_pa < l_nPatches; l_pa++) {
+      initOutflow(l_pa, i_first);
+      m_patches[l_pa]->timeStep(i_scaling, 1);
+      l_speedMax = std::max(l_speedMax, m_patches[l_pa]->getSpeedMax());
+    }
+  }
+  m_halosBathymetryValid = true;
+
+  return l_speedMax;
+}
+
+void tsunami_lab::patches::PatchedDomain::timeStep(t_real i_scaling,
+                                                   t_idx i_computeSteps) {
+  for (t_idx l_st = 0; l_st < i_computeSteps; l_st++) {
+    m_speedMax = patchStep(i_scaling, l_st == 0);
+  }
+}
+
+tsunami_lab::t_real tsunami_lab::patches::PatchedDomain::timeStepAdaptive(
+    t_real i_dxy, t_idx i_computeSteps) {
+  t_idx l_nPatches = m_patches.size();
+
+  // the first time step has no wave speeds of a previous one
+  if (m_speedMax <= 0) {
+    t_real l_speedMax = 0;
+#pragma omp parallel
+    {
+#pragma omp for schedule(static)
+      for (t_idx l_pa = 0; l_pa < l_nPatches; l_pa++) exchangeHalos(l_pa);
+
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+      for (t_idx l_pa = 0; l_pa < l_nPatches; l_pa++) {
+        initOutflow(l_pa, true);
+        l_speedMax =
+            std::max(l_speedMax, m_patches[l_pa]->deriveSpeedMax());
+      }
+    }
+    m_halosBathymetryValid = true;
+    m_speedMax = l_speedMax;
+  }
+
+  t_real l_time = 0;
+  for (t_idx l_st = 0; l_st < i_computeSteps; l_st++) {
+    // largest stable time step for the fastest wave of the previous step,
+    // domains without water do not restrict the time step
+    t_real l_speedMax = (m_speedMax > 0) ? m_speedMax : 1;
+    t_real l_dt = m_cfl * i_dxy / l_speedMax;
+
+    m_speedMax = patchStep(l_dt / i_dxy, l_st == 0);
+    l_time += l_dt;
+  }
+
+  return l_time;
+}
+
+tsunami_lab::t_real const *tsunami_lab::patches::PatchedDomain::gather(
+    unsigned short i_quantity, Grid2d<t_real> &o_grid) {
+  t_idx l_nPatches = m_patches.size();
+
+#pragma omp parallel for schedule(static)
+  for (t_idx l_pa = 0; l_pa < l_nPatches; l_pa++) {
+    WavePropagation2d<> &l_patch = *m_patches[l_pa];
+    t_real const *l_q = nullptr;
+    if (i_quantity == 0) l_q = l_patch.getHeight();
+    if (i_quantity == 1) l_q = l_patch.getMomentumX();
+    if (i_quantity == 2) l_q = l_patch.getMomentumY();
+    if (i_quantity == 3) l_q = l_patch.getBathymetry();
+    t_idx l_stride = l_patch.getStride();
+
+    for (t_idx l_iy = m_rowFirst[l_pa]; l_iy < m_rowFirst[l_pa + 1]; l_iy++) {
+      t_real const *l_row = l_q + (l_iy - m_rowFirst[l_pa]) * l_stride;
+      t_real *l_rowGlobal = o_grid.interior() + l_iy * o_grid.getStride();
+      std::copy(l_row, l_row + m_xCells, l_rowGlobal);
+    }
+  }
+
+  return o_grid.interior();
+}
+
+void tsunami_lab::patches::PatchedDomain::setHeight(t_idx i_ix, t_idx i_iy,
+                                                    t_real i_h) {
+  t_idx l_pa = findPatch(i_iy);
+  m_patches[l_pa]->setHeight(i_ix, i_iy - m_rowFirst[l_pa], i_h);
+}
+
+void tsunami_lab::patches::PatchedDomain::setMomentumX(t_idx i_ix,
+                                                       t_idx i_iy,
+                                                       t_real i_hu) {
+  t_idx l_pa = findPatch(i_iy);
+  m_patches[l_pa]->setMomentumX(i_ix, i_iy - m_rowFirst[l_pa], i_hu);
+}
+
+void tsunami_lab::patches::PatchedDomain::setMomentumY(t_idx i_ix,
+                                                       t_idx i_iy,
+                                                       t_real i_hv) {
+  t_idx l_pa = findPatch(i_iy);
+  m_patches[l_pa]->setMomentumY(i_ix, i_iy - m_rowFirst[l_pa], i_hv);
+}
+
+void tsunami_lab::patches::PatchedDomain::setBathymetry(t_idx i_ix,
+                                                        t_idx i_iy,
+                                                        t_real i_b) {
+  t_idx l_pa = findPatch(i_iy);
+  m_patches[l_pa]->setBathymetry(i_ix, i_iy - m_rowFirst[l_pa], i_b);
+}
+
+void tsunami_lab::patches::PatchedDomain::finishSetup() {
+  for (t_idx l_pa = 0; l_pa < m_patches.size(); l_pa++) {
+    m_patches[l_pa]->finishSetup();
+  }
+  m_speedMax = 0;
+  m_halosBathymetryValid = false;
+}
+
+void tsunami_lab::patches::PatchedDomain::setReflection(t_idx i_iy,
+                                                        bool i_reflL,
+                                                        bool i_reflR) {
+  for (t_idx l_pa = 0; l_pa < m_patches.size(); l_pa++) {
+    m_patches[l_pa]->setReflection(i_iy, i_reflL, i_reflR);
+  }
+}
@@ -0,0 +1,306 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Domain decomposed into patches of rows which exchange halos.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_PATCHED_DOMAIN
+#define TSUNAMI_LAB_PATCHES_PATCHED_DOMAIN
+
+#include <vector>
+
+#include "../Grid2d.h"
+#include "WavePropagation.h"
+#include "WavePropagation2d.h"
+
+namespace tsunami_lab {
+namespace patches {
+class PatchedDomain;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Splits the domain into patches of consecutive rows. Every patch is a
+ *WavePropagation2d with its own grids and ghost layer, the ghost rows between
+ *two patches are halos which receive the neighbours' rows before every time
+ *step. A patch advances its halos as well, thus the split and the unsplit
+ *scheme give the same result as a single patch. The patches are processed by
+ *the threads in a static schedule, every patch is allocated and first touched
+ *by the thread working on it.
+ **/
+class tsunami_lab::patches::PatchedDomain : public WavePropagation {
+ private:
+  //! number of cells discretizing the computational domain in x-direction
+  t_idx m_xCells = 0;
+
+  //! number of cells discretizing the computational domain in y-direction
+  t_idx m_yCells = 0;
+
+  //! patches of rows, bottom to top
+  std::vector<WavePropagation2d<> *> m_patches;
+
+  //! first rows of the patches and the number of rows
+  std::vector<t_idx> m_rowFirst;
+
+  //! true if the halos hold the bathymetry of the neighbours
+  bool m_halosBathymetryValid = false;
+
+  //! maximum absolute wave speed of the last time step, 0 if none was done
+  //! since the quantities were set
+  t_real m_speedMax = 0;
+
+  //! CFL number of the time steps, the same as the one of the patches
+  t_real m_cfl = 0.5;
+
+  //! water heights gathered from the patches
+  Grid2d<t_real> m_h;
+
+  //! momenta in x-direction gathered from the patches
+  Grid2d<t_real> m_hu;
+
+  //! momenta in y-direction gathered from the patches
+  Grid2d<t_real> m_hv;
+
+  //! bathymetry gathered from the patches
+  Grid2d<t_real> m_b;
+
+  /**
+   * Gets the patch which contains a row.
+   *
+   * @param i_iy id of the row.
+   * @return id of the patch.
+   **/
+  t_idx findPatch(t_idx i_iy) const;
+
+  /**
+   * Copies the neighbours' rows next to a patch to its halos.
+   *
+   * @param i_pa id of the patch.
+   **/
+  void exchangeHalos(t_idx i_pa);
+
+  /**
+   * Selects the ghost cells of a patch which are set to outflow. Only the
+   *sides at the boundary of the domain are outflow and the ghost cells are
+   *set once per call, like the ones of a single patch.
+   *
+   * @param i_pa id of the patch.
+   * @param i_first true for the first time step of a call.
+   **/
+  void initOutflow(t_idx i_pa, bool i_first);
+
+  /**
+   * Exchanges the halos and advances all patches by a time step.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_first true for the first time step of a call.
+   * @return maximum absolute wave speed of the time step.
+   **/
+  t_real patchStep(t_real i_scaling, bool i_first);
+
+  /**
+   * Copies a quantity of all patches to a grid of the whole domain.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry.
+   * @param o_grid will be set to the quantity.
+   * @return interior cells of the grid.
+   **/
+  t_real const *gather(unsigned short i_quantity, Grid2d<t_real> &o_grid);
+
+ public:
+  /**
+   * Constructs the domain.
+   *
+   * @param i_xCells number of cells in x-direction.
+   * @param i_yCells number of cells in y-direction.
+   * @param i_nPatches number of patches, at most one per row.
+   **/
+  PatchedDomain(t_idx i_xCells, t_idx i_yCells, t_idx i_nPatches);
+
+  /**
+   * Destructor which frees the patches.
+   **/
+  ~PatchedDomain();
+
+  /**
+   * Performs time steps.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_computeSteps number of time steps.
+   **/
+  void timeStep(t_real i_scaling, t_idx i_computeSteps);
+
+  /**
+   * Performs time steps with the largest stable time step of each step, which
+   *is derived from the fastest wave of all patches.
+   *
+   * @param i_dxy cell size.
+   * @param i_computeSteps number of time steps.
+   * @return simulated time of all time steps.
+   **/
+  t_real timeStepAdaptive(t_real i_dxy, t_idx i_computeSteps);
+
+  /**
+   * Gets the number of patches.
+   *
+   * @return number of patches.
+   **/
+  t_idx getNumPatches() const { return m_patches.size(); }
+
+  /**
+   * Gets a patch, e.g., to select its scheme.
+   *
+   * @param i_pa id of the patch.
+   * @return patch.
+   **/
+  WavePropagation2d<> &getPatch(t_idx i_pa) { return *m_patches[i_pa]; }
+
+  /**
+   * Gets the stride in y-direction of the gathered quantities.
+   *
+   * @return stride in y-direction.
+   **/
+  t_idx getStride() { return m_b.getStride(); }
+
+  /**
+   * Gets the cells' water heights gathered from the patches.
+   *
+   * @return water heights.
+   **/
+  t_real const *getHeight() { return gather(0, m_h); }
+
+  /**
+   * Gets the cells' momenta in x-direction gathered from the patches.
+   *
+   * @return momenta in x-direction.
+   **/
+  t_real const *getMomentumX() { return gather(1, m_hu); }
+
+  /**
+   * Gets the cells' momenta in y-direction gathered from the patches.
+   *
+   * @return momenta in y-direction.
+   **/
+  t_real const *getMomentumY() { return gather(2, m_hv); }
+
+  /**
+   * Gets the cells' bathymetry gathered from the patches.
+   *
+   * @return bathymetry.
+   **/
+  t_real const *getBathymetry() { return gather(3, m_b); }
+
+  /**
+   * Enables or disables the accumulation of the extremes of all patches,
+   *each patch accumulates the ones of its interior rows.
+   *
+   * @param i_enabled true if the extremes are accumulated.
+   * @param i_threshold amplitude of the sea surface from which on a wave has
+   *arrived at a cell.
+   * @param i_dxy cell width, converts the scaling of the time steps to the
+   *simulated time.
+   * @return true.
+   **/
+  bool setExtremes(bool i_enabled, t_real i_threshold = 0.01,
+                   t_real i_dxy = 1) {
+    for (t_idx l_pa = 0; l_pa < m_patches.size(); l_pa++) {
+      m_patches[l_pa]->setExtremes(i_enabled, i_threshold, i_dxy);
+    }
+    return true;
+  }
+
+  /**
+   * Gets the interior cells of a row of a quantity from its patch.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry, 4-6: extremes, see setExtremes.
+   * @param i_iy id of the row.
+   * @param io_row buffer of a row.
+   * @return values of the row's interior cells.
+   **/
+  t_real const *getRow(unsigned short i_quantity, t_idx i_iy,
+                       t_real *io_row) {
+    t_idx l_pa = findPatch(i_iy);
+    return m_patches[l_pa]->getRow(i_quantity, i_iy - m_rowFirst[l_pa],
+                                   io_row);
+  }
+
+  /**
+   * Sets the height of the cell to the given value.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_h water height.
+   **/
+  void setHeight(t_idx i_ix, t_idx i_iy, t_real i_h);
+
+  /**
+   * Sets the momentum in x-direction to the given value.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_hu momentum in x-direction.
+   **/
+  void setMomentumX(t_idx i_ix, t_idx i_iy, t_real i_hu);
+
+  /**
+   * Sets the momentum in y-direction to the given value.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_hv momentum in y-direction.
+   **/
+  void setMomentumY(t_idx i_ix, t_idx i_iy, t_real i_hv);
+
+  /**
+   * Sets the bathymetry value to the cell given it's id.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_b bathymetry value of the cell.
+   **/
+  void setBathymetry(t_idx i_ix, t_idx i_iy, t_real i_b);
+
+  /**
+   * Finishes the setup of the patches and invalidates the halos.
+   **/
+  void finishSetup();
+
+  /**
+   * Sets the ghost cells in row y to reflecting or not.
+   *
+   * @param i_iy row in which the ghost cells are set.
+   * @param i_reflL reflection of the left ghost cell.
+   * @param i_reflR reflection of the right ghost cell.
+   **/
+  void setReflection(t_idx i_iy, bool i_reflL, bool i_reflR);
+
+  void MemTransfer() {}
+};
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the domain decomposed into patches.
+ **/
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include "PatchedDomain.h"
+#include "WavePropagation2d.h"
+
+/**
+ * Sets up a hump next to a sloped beach with dry cells.
+ *
+ * @param io_waveProp solver.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ **/
+static void setupBeach(tsunami_lab::patches::WavePropagation &io_waveProp,
+                       std::size_t i_nx, std::size_t i_ny) {
+  for (std::size_t l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+      float l_dX = l_ceX - 7.0f;
+      float l_dY = l_ceY - 11.0f;
+      float l_b = -12 + (float)l_ceX * 0.5f + (float)(l_ceY % 3);
+      io_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      io_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 5) : 0);
+      io_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      io_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  io_waveProp.finishSetup();
+}
+
+TEST_CASE("Test the domain decomposed into patches.", "[PatchedDomain]") {
+  /*
+   * Test case:
+   *
+   *   The patches advance their halos, the result is bitwise identical to a
+   *   single patch for the split and the unsplit scheme, constant and
+   *   adaptive time steps, patches of a single row and more patches than
+   *   rows. So are the extremes accumulated by the patches.
+   */
+  std::size_t l_nx = 27;
+  std::size_t l_ny = 19;
+  std::size_t l_nPatches[4] = {1, 3, 19, 40};
+
+  for (int l_un = 0; l_un < 2; l_un++) {
+    tsunami_lab::patches::WavePropagation2d<> l_single(l_nx, l_ny);
+    setupBeach(l_single, l_nx, l_ny);
+    l_single.setUnsplit(l_un == 1);
+    l_single.setExtremes(true, 0.05f, 1);
+
+    l_single.timeStep(0.05, 3);
+    float l_timeSingle = l_single.timeStepAdaptive(1, 5);
+    l_timeSingle += l_single.timeStepAdaptive(1, 4);
+
+    for (int l_np = 0; l_np < 4; l_np++) {
+      tsunami_lab::patches::PatchedDomain l_domain(l_nx, l_ny,
+                                                   l_nPatches[l_np]);
+      REQUIRE(l_domain.getNumPatches() == std::min(l_nPatches[l_np], l_ny));
+      setupBeach(l_domain, l_nx, l_ny);
+      for (std::size_t l_pa = 0; l_pa < l_domain.getNumPatches(); l_pa++) {
+        l_domain.getPatch(l_pa).setUnsplit(l_un == 1);
+      }
+      REQUIRE(l_domain.setExtremes(true, 0.05f, 1));
+
+      l_domain.timeStep(0.05, 3);
+      float l_time = l_domain.timeStepAdaptive(1, 5);
+      l_time += l_domain.timeStepAdaptive(1, 4);
+      REQUIRE(l_time == l_timeSingle);
+
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          std::size_t l_ce = l_ceX + l_ceY * l_single.getStride();
+          std::size_t l_ceDomain = l_ceX + l_ceY * l_domain.getStride();
+          REQUIRE(l_domain.getHeight()[l_ceDomain] ==
+                  l_single.getHeight()[l_ce]);
+          REQUIRE(l_domain.getMomentumX()[l_ceDomain] ==
+                  l_single.getMomentumX()[l_ce]);
+          REQUIRE(l_domain.getMomentumY()[l_ceDomain] ==
+                  l_single.getMomentumY()[l_ce]);
+          REQUIRE(l_domain.getBathymetry()[l_ceDomain] ==
+                  l_single.getBathymetry()[l_ce]);
+        }
+      }
+
+      std::vector<float> l_row(l_nx);
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        float const *l_extremes[3] = {l_single.getMaxAmplitude(),
+                                      l_single.getMaxVelocity(),
+                                      l_single.getArrivalTime()};
+        for (unsigned short l_ex = 0; l_ex < 3; l_ex++) {
+          float const *l_values =
+              l_domain.getRow(4 + l_ex, l_ceY, l_row.data());
+          for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+            REQUIRE(l_values[l_ceX] ==
+                    l_extremes[l_ex][l_ceX + l_ceY * l_single.getStride()]);
+          }
+        }
+      }
+    }
+  }
+}
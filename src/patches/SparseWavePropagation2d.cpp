@@ -0,0 +1,573 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Wave propagation patch which only stores the cells near water.
+ **/
+#include "SparseWavePropagation2d.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../solvers/fwave.h"
+
+tsunami_lab::patches::SparseWavePropagation2d::SparseWavePropagation2d(
+    t_idx i_xCells, t_idx i_yCells, setups::Setup const &i_setup,
+    t_idx i_margin) {
+  m_xCells = i_xCells;
+  m_yCells = i_yCells;
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_margin = std::max(i_margin, (t_idx)1);
+
+  // the bathymetry of the setup is queried for the output of the dropped
+  // cells, no grid of the whole domain is kept
+  m_setup = &i_setup;
+
+  // cells whose distance to water in x-direction is within the margin
+  std::vector<unsigned char> l_near(l_nCols * l_nRows, 0);
+#pragma omp parallel
+  {
+    // water cells of a row
+    std::vector<unsigned char> l_water(l_nCols, 0);
+
+#pragma omp for schedule(static)
+    for (t_idx l_ceY = 1; l_ceY <= m_yCells; l_ceY++) {
+      for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+        l_water[l_ceX] = i_setup.getBathymetry(l_ceX - 1, l_ceY - 1) < 0;
+      }
+
+      // distances to the closest water on the left and on the right
+      t_idx l_dist = l_margin + 1;
+      for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+        l_dist = l_water[l_ceX] ? 0 : l_dist + 1;
+        if (l_dist <= l_margin) l_near[l_ceX + l_ceY * l_nCols] = 1;
+      }
+      l_dist = l_margin + 1;
+      for (t_idx l_ceX = m_xCells; l_ceX >= 1; l_ceX--) {
+        l_dist = l_water[l_ceX] ? 0 : l_dist + 1;
+        if (l_dist <= l_margin) l_near[l_ceX + l_ceY * l_nCols] = 1;
+      }
+    }
+  }
+
+  // cells whose distance to water is within the margin in both directions
+  std::vector<unsigned char> l_keep(l_nCols * l_nRows, 0);
+#pragma omp parallel for schedule(static)
+  for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+    t_idx l_dist = l_margin + 1;
+    for (t_idx l_ceY = 1; l_ceY <= m_yCells; l_ceY++) {
+      l_dist = l_near[l_ceX + l_ceY * l_nCols] ? 0 : l_dist + 1;
+      if (l_dist <= l_margin) l_keep[l_ceX + l_ceY * l_nCols] = 1;
+    }
+    l_dist = l_margin + 1;
+    for (t_idx l_ceY = m_yCells; l_ceY >= 1; l_ceY--) {
+      l_dist = l_near[l_ceX + l_ceY * l_nCols] ? 0 : l_dist + 1;
+      if (l_dist <= l_margin) l_keep[l_ceX + l_ceY * l_nCols] = 1;
+    }
+  }
+
+  // ghost cells are kept with the cells they copy, the corners copy the
+  // ghost rows
+  for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+    l_keep[l_ceX] = l_keep[l_ceX + l_nCols];
+    l_keep[l_ceX + (l_nRows - 1) * l_nCols] =
+        l_keep[l_ceX + m_yCells * l_nCols];
+  }
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+    l_keep[l_ceY * l_nCols] = l_keep[1 + l_ceY * l_nCols];
+    l_keep[l_nCols - 1 + l_ceY * l_nCols] =
+        l_keep[m_xCells + l_ceY * l_nCols];
+  }
+
+  // row-compressed index of the spans
+  t_idx l_nCells = 0;
+  m_rowSpans.resize(l_nRows + 1);
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+    m_rowSpans[l_ceY] = m_spans.size();
+
+    t_idx l_ceX = 0;
+    while (l_ceX < l_nCols) {
+      while (l_ceX < l_nCols && !l_keep[l_ceX + l_ceY * l_nCols]) l_ceX++;
+      if (l_ceX == l_nCols) break;
+
+      Span l_span;
+      l_span.m_first = l_ceX;
+      while (l_ceX < l_nCols && l_keep[l_ceX + l_ceY * l_nCols]) l_ceX++;
+      l_span.m_last = l_ceX;
+      l_span.m_cell = l_nCells;
+
+      l_nCells += l_span.m_last - l_span.m_first;
+      m_spanMax = std::max(m_spanMax, l_span.m_last - l_span.m_first);
+      m_spans.push_back(l_span);
+    }
+  }
+  m_rowSpans[l_nRows] = m_spans.size();
+
+  // overlaps of the spans of neighbouring rows, the ghost columns have no
+  // y-edges
+  t_idx l_nEdgesY = 0;
+  m_rowOverlaps.resize(l_nRows);
+  for (t_idx l_ceY = 0; l_ceY + 1 < l_nRows; l_ceY++) {
+    m_rowOverlaps[l_ceY] = m_overlaps.size();
+
+    t_idx l_spB = m_rowSpans[l_ceY];
+    t_idx l_spT = m_rowSpans[l_ceY + 1];
+    while (l_spB < m_rowSpans[l_ceY + 1] && l_spT < m_rowSpans[l_ceY + 2]) {
+      Span const &l_spanB = m_spans[l_spB];
+      Span const &l_spanT = m_spans[l_spT];
+
+      t_idx l_first = std::max(std::max(l_spanB.m_first, l_spanT.m_first),
+                               (t_idx)1);
+      t_idx l_last = std::min(std::min(l_spanB.m_last, l_spanT.m_last),
+                              l_nCols - 1);
+      if (l_first < l_last) {
+        Overlap l_overlap;
+        l_overlap.m_cellB = l_spanB.m_cell + l_first - l_spanB.m_first;
+        l_overlap.m_cellT = l_spanT.m_cell + l_first - l_spanT.m_first;
+        l_overlap.m_nEdges = l_last - l_first;
+        l_overlap.m_edge = l_nEdgesY;
+
+        l_nEdgesY += l_overlap.m_nEdges;
+        m_overlaps.push_back(l_overlap);
+      }
+
+      // the span which ends first has no further overlaps
+      if (l_spanB.m_last < l_spanT.m_last) {
+        l_spB++;
+      } else {
+        l_spT++;
+      }
+    }
+  }
+  m_rowOverlaps[l_nRows - 1] = m_overlaps.size();
+
+  for (unsigned short l_st = 0; l_st < 2; l_st++) {
+    m_h[l_st].resize(l_nCells, 0);
+    m_hu[l_st].resize(l_nCells, 0);
+    m_hv[l_st].resize(l_nCells, 0);
+  }
+  m_b.resize(l_nCells, 0);
+  m_edgeTypeX.resize(l_nCells);
+  m_bathJumpX.resize(l_nCells);
+  m_edgeTypeY.resize(l_nEdgesY);
+  m_bathJumpY.resize(l_nEdgesY);
+
+  // interior bathymetry of the setup
+  for (t_idx l_ceY = 1; l_ceY <= m_yCells; l_ceY++) {
+    for (t_idx l_sp = m_rowSpans[l_ceY]; l_sp < m_rowSpans[l_ceY + 1];
+         l_sp++) {
+      Span const &l_span = m_spans[l_sp];
+      for (t_idx l_ceX = l_span.m_first; l_ceX < l_span.m_last; l_ceX++) {
+        m_b[l_span.m_cell + l_ceX - l_span.m_first] =
+            i_setup.getBathymetry(l_ceX - 1, l_ceY - 1);
+      }
+    }
+  }
+
+  // ghost cells in the order of the dense patch: bottom and top rows first,
+  // then the left and right columns including the corners
+  for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+    t_idx l_ghosts[2][2] = {{findCell(l_ceX, 0), findCell(l_ceX, 1)},
+                            {findCell(l_ceX, l_nRows - 1),
+                             findCell(l_ceX, m_yCells)}};
+    for (unsigned short l_gh = 0; l_gh < 2; l_gh++) {
+      if (l_ghosts[l_gh][0] == l_nCells) continue;
+      m_ghosts[0].push_back(l_ghosts[l_gh][0]);
+      m_ghosts[1].push_back(l_ghosts[l_gh][1]);
+    }
+  }
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+    t_idx l_ghosts[2][2] = {{findCell(0, l_ceY), findCell(1, l_ceY)},
+                            {findCell(l_nCols - 1, l_ceY),
+                             findCell(m_xCells, l_ceY)}};
+    for (unsigned short l_gh = 0; l_gh < 2; l_gh++) {
+      if (l_ghosts[l_gh][0] == l_nCells) continue;
+      m_ghosts[0].push_back(l_ghosts[l_gh][0]);
+      m_ghosts[1].push_back(l_ghosts[l_gh][1]);
+    }
+  }
+}
+
+tsunami_lab::t_idx tsunami_lab::patches::SparseWavePropagation2d::findCell(
+    t_idx i_x, t_idx i_y) const {
+  // last span of the row which starts at or before the column
+  t_idx l_sp = std::upper_bound(m_spans.begin() + m_rowSpans[i_y],
+                                m_spans.begin() + m_rowSpans[i_y + 1], i_x,
+                                [](t_idx i_col, Span const &i_span) {
+                                  return i_col < i_span.m_first;
+                                }) -
+               m_spans.begin();
+  if (l_sp == m_rowSpans[i_y]) return getNumCells();
+
+  Span const &l_span = m_spans[l_sp - 1];
+  if (i_x >= l_span.m_last) return getNumCells();
+  return l_span.m_cell + i_x - l_span.m_first;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::initEdges() {
+  t_idx l_nRows = m_yCells + 2;
+  setGhostOutflow(m_b);
+
+#pragma omp parallel for schedule(dynamic, 16)
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+    // edges in x-direction, the last cell of a span has none
+    for (t_idx l_sp = m_rowSpans[l_ceY]; l_sp < m_rowSpans[l_ceY + 1];
+         l_sp++) {
+      t_idx l_ce = m_spans[l_sp].m_cell;
+      t_idx l_nCells = m_spans[l_sp].m_last - m_spans[l_sp].m_first;
+
+      solvers::fwave::classifyEdges(l_nCells - 1, m_b.data() + l_ce,
+                                    m_b.data() + l_ce + 1,
+                                    m_edgeTypeX.data() + l_ce,
+                                    m_bathJumpX.data() + l_ce);
+      m_edgeTypeX[l_ce + l_nCells - 1] = solvers::fwave::m_dryDry;
+      m_bathJumpX[l_ce + l_nCells - 1] = 0;
+    }
+
+    // edges in y-direction
+    if (l_ceY + 1 == l_nRows) continue;
+    for (t_idx l_ov = m_rowOverlaps[l_ceY]; l_ov < m_rowOverlaps[l_ceY + 1];
+         l_ov++) {
+      Overlap const &l_overlap = m_overlaps[l_ov];
+      solvers::fwave::classifyEdges(
+          l_overlap.m_nEdges, m_b.data() + l_overlap.m_cellB,
+          m_b.data() + l_overlap.m_cellT,
+          m_edgeTypeY.data() + l_overlap.m_edge,
+          m_bathJumpY.data() + l_overlap.m_edge);
+    }
+  }
+
+  m_edgesValid = true;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::setGhostOutflow(
+    t_array<t_real> &io_q) {
+  for (t_idx l_gh = 0; l_gh < m_ghosts[0].size(); l_gh++) {
+    io_q[m_ghosts[0][l_gh]] = io_q[m_ghosts[1][l_gh]];
+  }
+}
+
+tsunami_lab::t_real tsunami_lab::patches::SparseWavePropagation2d::xSweep(
+    t_real i_scaling) {
+  t_idx l_nRows = m_yCells + 2;
+  t_real l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    // thread-private edge-flux buffers of a span
+    std::vector<t_real> l_netUpdates(4 * m_spanMax);
+    t_real *l_netUpdatesHL = l_netUpdates.data();
+    t_real *l_netUpdatesHuL = l_netUpdatesHL + m_spanMax;
+    t_real *l_netUpdatesHR = l_netUpdatesHL + 2 * m_spanMax;
+    t_real *l_netUpdatesHuR = l_netUpdatesHL + 3 * m_spanMax;
+
+#pragma omp for schedule(dynamic, 16)
+    for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+      for (t_idx l_sp = m_rowSpans[l_ceY]; l_sp < m_rowSpans[l_ceY + 1];
+           l_sp++) {
+        t_idx l_ce = m_spans[l_sp].m_cell;
+        t_idx l_nCells = m_spans[l_sp].m_last - m_spans[l_sp].m_first;
+        t_real const *l_h = m_h[0].data() + l_ce;
+        t_real const *l_hu = m_hu[0].data() + l_ce;
+        t_real *l_hNew = m_h[1].data() + l_ce;
+        t_real *l_huNew = m_hu[1].data() + l_ce;
+
+        if (l_nCells == 1) {
+          l_hNew[0] = l_h[0];
+          l_huNew[0] = l_hu[0];
+          continue;
+        }
+
+        t_real l_speed = solvers::fwave::netUpdatesBatch(
+            l_nCells - 1, l_h, l_h + 1, l_hu, l_hu + 1,
+            m_edgeTypeX.data() + l_ce, m_bathJumpX.data() + l_ce,
+            l_netUpdatesHL, l_netUpdatesHuL, l_netUpdatesHR, l_netUpdatesHuR);
+        l_speedMax = std::max(l_speedMax, l_speed);
+
+        // write the new cells' quantities, the outermost cells of a span
+        // only have one edge
+        l_hNew[0] = l_h[0] - i_scaling * l_netUpdatesHL[0];
+        l_huNew[0] = l_hu[0] - i_scaling * l_netUpdatesHuL[0];
+#pragma omp simd
+        for (t_idx l_ceX = 1; l_ceX < l_nCells - 1; l_ceX++) {
+          l_hNew[l_ceX] = l_h[l_ceX] - i_scaling * l_netUpdatesHR[l_ceX - 1] -
+                          i_scaling * l_netUpdatesHL[l_ceX];
+          l_huNew[l_ceX] = l_hu[l_ceX] -
+                           i_scaling * l_netUpdatesHuR[l_ceX - 1] -
+                           i_scaling * l_netUpdatesHuL[l_ceX];
+        }
+        t_idx l_ceR = l_nCells - 1;
+        l_hNew[l_ceR] = l_h[l_ceR] - i_scaling * l_netUpdatesHR[l_ceR - 1];
+        l_huNew[l_ceR] =
+            l_hu[l_ceR] - i_scaling * l_netUpdatesHuR[l_ceR - 1];
+      }
+    }
+  }
+
+  // the new heights and momenta in x-direction are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hu[0], m_hu[1]);
+
+  return l_speedMax;
+}
+
+tsunami_lab::t_real tsunami_lab::patches::SparseWavePropagation2d::ySweep(
+    t_real i_scaling) {
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_nCells = getNumCells();
+  t_real l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    // thread-private edge-flux buffers of an overlap
+    std::vector<t_real> l_netUpdates(4 * m_spanMax);
+    t_real *l_netUpdatesHB = l_netUpdates.data();
+    t_real *l_netUpdatesHvB = l_netUpdatesHB + m_spanMax;
+    t_real *l_netUpdatesHT = l_netUpdatesHB + 2 * m_spanMax;
+    t_real *l_netUpdatesHvT = l_netUpdatesHB + 3 * m_spanMax;
+
+    // the updates are subtracted from the old quantities
+#pragma omp for schedule(static)
+    for (t_idx l_ce = 0; l_ce < l_nCells; l_ce++) {
+      m_h[1][l_ce] = m_h[0][l_ce];
+      m_hv[1][l_ce] = m_hv[0][l_ce];
+    }
+
+    // the overlaps of a row update the row and the row above, thus the rows
+    // with even and odd ids are handled one after another
+    for (t_idx l_pa = 0; l_pa < 2; l_pa++) {
+#pragma omp for schedule(dynamic, 8)
+      for (t_idx l_ceY = l_pa; l_ceY < l_nRows - 1; l_ceY += 2) {
+        for (t_idx l_ov = m_rowOverlaps[l_ceY];
+             l_ov < m_rowOverlaps[l_ceY + 1]; l_ov++) {
+          Overlap const &l_overlap = m_overlaps[l_ov];
+          t_idx l_ceB = l_overlap.m_cellB;
+          t_idx l_ceT = l_overlap.m_cellT;
+
+          t_real l_speed = solvers::fwave::netUpdatesBatch(
+              l_overlap.m_nEdges, m_h[0].data() + l_ceB,
+              m_h[0].data() + l_ceT, m_hv[0].data() + l_ceB,
+              m_hv[0].data() + l_ceT, m_edgeTypeY.data() + l_overlap.m_edge,
+              m_bathJumpY.data() + l_overlap.m_edge, l_netUpdatesHB,
+              l_netUpdatesHvB, l_netUpdatesHT, l_netUpdatesHvT);
+          l_speedMax = std::max(l_speedMax, l_speed);
+
+          t_real *l_hB = m_h[1].data() + l_ceB;
+          t_real *l_hvB = m_hv[1].data() + l_ceB;
+          t_real *l_hT = m_h[1].data() + l_ceT;
+          t_real *l_hvT = m_hv[1].data() + l_ceT;
+#pragma omp simd
+          for (t_idx l_ed = 0; l_ed < l_overlap.m_nEdges; l_ed++) {
+            l_hB[l_ed] -= i_scaling * l_netUpdatesHB[l_ed];
+            l_hvB[l_ed] -= i_scaling * l_netUpdatesHvB[l_ed];
+            l_hT[l_ed] -= i_scaling * l_netUpdatesHT[l_ed];
+            l_hvT[l_ed] -= i_scaling * l_netUpdatesHvT[l_ed];
+          }
+        }
+      }
+    }
+  }
+
+  // the new heights and momenta in y-direction are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hv[0], m_hv[1]);
+
+  return l_speedMax;
+}
+
+tsunami_lab::t_real tsunami_lab::patches::SparseWavePropagation2d::step(
+    t_real i_scaling) {
+  t_real l_speedMax = xSweep(i_scaling);
+  return std::max(l_speedMax, ySweep(i_scaling));
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::timeStep(
+    t_real i_scaling, t_idx i_computeSteps) {
+  setGhostOutflow(m_h[0]);
+  setGhostOutflow(m_hu[0]);
+  setGhostOutflow(m_hv[0]);
+  if (!m_edgesValid) initEdges();
+
+  for (t_idx l_st = 0; l_st < i_computeSteps; l_st++) {
+    m_speedMax = step(i_scaling);
+    m_time += i_scaling * m_dxy;
+    if (m_extremes) extremesCells();
+  }
+}
+
+tsunami_lab::t_real
+tsunami_lab::patches::SparseWavePropagation2d::timeStepAdaptive(
+    t_real i_dxy, t_idx i_computeSteps) {
+  setGhostOutflow(m_h[0]);
+  setGhostOutflow(m_hu[0]);
+  setGhostOutflow(m_hv[0]);
+  if (!m_edgesValid) initEdges();
+
+  // the first time step has no wave speeds of a previous one
+  if (m_speedMax <= 0) m_speedMax = step(0);
+
+  t_real l_time = 0;
+  for (t_idx l_st = 0; l_st < i_computeSteps; l_st++) {
+    // largest stable time step for the fastest wave of the previous step,
+    // domains without water do not restrict the time step
+    t_real l_speedMax = (m_speedMax > 0) ? m_speedMax : 1;
+    t_real l_dt = m_cfl * i_dxy / l_speedMax;
+
+    m_speedMax = step(l_dt / i_dxy);
+    l_time += l_dt;
+    m_time += l_dt;
+    if (m_extremes) extremesCells();
+  }
+
+  return l_time;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::extremesCells() {
+  t_idx l_nCells = getNumCells();
+  t_real l_time = m_time;
+  t_real const *l_h = m_h[0].data();
+  t_real const *l_hu = m_hu[0].data();
+  t_real const *l_hv = m_hv[0].data();
+  t_real const *l_b = m_b.data();
+  t_real *l_ampMax = m_extremesCells[0].data();
+  t_real *l_velMax = m_extremesCells[1].data();
+  t_real *l_arrival = m_extremesCells[2].data();
+
+  // branch-free, dry cells have neither an amplitude nor a velocity; the
+  // ghost cells are accumulated as well but never output
+#pragma omp parallel for simd schedule(static)
+  for (t_idx l_ce = 0; l_ce < l_nCells; l_ce++) {
+    bool l_wet = l_h[l_ce] >= m_wetHeight;
+    t_real l_amp = l_wet ? std::abs(l_h[l_ce] + l_b[l_ce]) : 0;
+    t_real l_vel = l_wet ? std::sqrt(l_hu[l_ce] * l_hu[l_ce] +
+                                     l_hv[l_ce] * l_hv[l_ce]) /
+                               l_h[l_ce]
+                         : t_real(0);
+
+    l_ampMax[l_ce] = std::max(l_ampMax[l_ce], l_amp);
+    l_velMax[l_ce] = std::max(l_velMax[l_ce], l_vel);
+    bool l_arrived = l_arrival[l_ce] < 0 && l_amp >= m_arrivalThreshold;
+    l_arrival[l_ce] = l_arrived ? l_time : l_arrival[l_ce];
+  }
+}
+
+bool tsunami_lab::patches::SparseWavePropagation2d::setExtremes(
+    bool i_enabled, t_real i_threshold, t_real i_dxy) {
+  m_extremes = i_enabled;
+  m_arrivalThreshold = i_threshold;
+  m_dxy = i_dxy;
+
+  t_idx l_nCells = i_enabled ? getNumCells() : 0;
+  m_extremesCells[0].assign(l_nCells, 0);
+  m_extremesCells[1].assign(l_nCells, 0);
+  m_extremesCells[2].assign(l_nCells, -1);
+  return true;
+}
+
+tsunami_lab::t_real const *
+tsunami_lab::patches::SparseWavePropagation2d::gather(
+    unsigned short i_quantity) {
+  Grid2d<t_real> &l_grid = m_output[i_quantity];
+  if (l_grid.getSize() == 0) {
+    l_grid = Grid2d<t_real>(m_xCells, m_yCells, 1, getStride());
+  }
+
+#pragma omp parallel for schedule(static)
+  for (t_idx l_ceY = 1; l_ceY <= m_yCells; l_ceY++) {
+    getRow(i_quantity, l_ceY - 1, l_grid.row(l_ceY) + 1);
+  }
+
+  return l_grid.interior();
+}
+
+tsunami_lab::t_real const *
+tsunami_lab::patches::SparseWavePropagation2d::getRow(
+    unsigned short i_quantity, t_idx i_iy, t_real *io_row) {
+  t_idx l_ceY = i_iy + 1;
+
+  // the water of the dropped cells is at rest and zero, the wave never
+  // arrives
+  if (i_quantity == 3) {
+    for (t_idx l_ceX = 0; l_ceX < m_xCells; l_ceX++) {
+      io_row[l_ceX] = m_setup->getBathymetry(l_ceX, i_iy);
+    }
+  } else {
+    std::fill(io_row, io_row + m_xCells, t_real(i_quantity == 6 ? -1 : 0));
+  }
+
+  t_array<t_real> const *l_q[7] = {&m_h[0], &m_hu[0], &m_hv[0], &m_b,
+                                   &m_extremesCells[0], &m_extremesCells[1],
+                                   &m_extremesCells[2]};
+  for (t_idx l_sp = m_rowSpans[l_ceY]; l_sp < m_rowSpans[l_ceY + 1]; l_sp++) {
+    Span const &l_span = m_spans[l_sp];
+
+    // the ghost columns are skipped
+    t_idx l_first = std::max(l_span.m_first, t_idx(1));
+    t_idx l_last = std::min(l_span.m_last, m_xCells + 1);
+    if (l_first >= l_last) continue;
+    t_real const *l_src =
+        l_q[i_quantity]->data() + l_span.m_cell + l_first - l_span.m_first;
+    std::copy(l_src, l_src + l_last - l_first, io_row + l_first - 1);
+  }
+
+  return io_row;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::setHeight(t_idx i_ix,
+                                                              t_idx i_iy,
+                                                              t_real i_h) {
+  t_idx l_ce = findCell(i_ix + 1, i_iy + 1);
+  if (l_ce == getNumCells()) return;
+  m_h[0][l_ce] = i_h;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::setMomentumX(
+    t_idx i_ix, t_idx i_iy, t_real i_hu) {
+  t_idx l_ce = findCell(i_ix + 1, i_iy + 1);
+  if (l_ce == getNumCells()) return;
+  m_hu[0][l_ce] = i_hu;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::setMomentumY(
+    t_idx i_ix, t_idx i_iy, t_real i_hv) {
+  t_idx l_ce = findCell(i_ix + 1, i_iy + 1);
+  if (l_ce == getNumCells()) return;
+  m_hv[0][l_ce] = i_hv;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::setBathymetry(
+    t_idx i_ix, t_idx i_iy, t_real i_b) {
+  t_idx l_ce = findCell(i_ix + 1, i_iy + 1);
+  if (l_ce == getNumCells()) return;
+  m_b[l_ce] = i_b;
+}
+
+void tsunami_lab::patches::SparseWavePropagation2d::finishSetup() {
+  m_speedMax = 0;
+  m_edgesValid = false;
+}
@@ -0,0 +1,417 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Wave propagation patch which only stores the cells near water.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_SPARSE_WAVE_PROPAGATION_2D
+#define TSUNAMI_LAB_PATCHES_SPARSE_WAVE_PROPAGATION_2D
+
+#include <vector>
+
+#include "../Arena.h"
+#include "../Grid2d.h"
+#include "../setups/Setup.h"
+#include "WavePropagation.h"
+
+namespace tsunami_lab {
+namespace patches {
+class SparseWavePropagation2d;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Two-dimensional wave propagation patch which drops the land cells farther
+ *than a margin from the water. The kept cells of a row form spans of
+ *consecutive cells, which are stored one after another; a row-compressed
+ *index gives the spans of every row. The x-sweep advances span by span, the
+ *y-sweep the overlaps of the spans of two neighbouring rows.
+ *
+ * The margin is at least one cell, thus the cells next to dropped cells are
+ *dry and the skipped edges towards them would not have net-updates. Ghost
+ *cells are kept next to kept boundary cells and are set to outflow. The
+ *quantities are single precision and gathered row by row for the output, the
+ *water of the dropped cells is at rest and zero and their bathymetry is
+ *queried from the setup.
+ **/
+class tsunami_lab::patches::SparseWavePropagation2d : public WavePropagation {
+ private:
+  /**
+   * Consecutive kept cells of a row.
+   **/
+  struct Span {
+    //! first column including the ghost columns
+    t_idx m_first;
+
+    //! column after the last one
+    t_idx m_last;
+
+    //! position of the first cell in the stored quantities
+    t_idx m_cell;
+  };
+
+  /**
+   * Overlap of two spans of neighbouring rows, whose cells share y-edges.
+   **/
+  struct Overlap {
+    //! position of the first cell of the lower row in the stored quantities
+    t_idx m_cellB;
+
+    //! position of the first cell of the upper row in the stored quantities
+    t_idx m_cellT;
+
+    //! number of edges
+    t_idx m_nEdges;
+
+    //! position of the first edge in the y-edge properties
+    t_idx m_edge;
+  };
+
+  //! array of the kept cells or edges, which is taken from the global arena
+  template <typename T>
+  using t_array = std::vector<T, ArenaAllocator<T> >;
+
+  //! number of cells discretizing the computational domain in x-direction
+  t_idx m_xCells = 0;
+
+  //! number of cells discretizing the computational domain in y-direction
+  t_idx m_yCells = 0;
+
+  //! spans of all rows including the ghost rows, bottom to top
+  std::vector<Span> m_spans;
+
+  //! first span of every row and the number of spans
+  std::vector<t_idx> m_rowSpans;
+
+  //! overlaps of the rows and the rows above, bottom to top
+  std::vector<Overlap> m_overlaps;
+
+  //! first overlap of every row and the number of overlaps
+  std::vector<t_idx> m_rowOverlaps;
+
+  //! 0: positions of the kept ghost cells, 1: positions of the boundary cells
+  //! whose values they copy
+  std::vector<t_idx> m_ghosts[2];
+
+  //! water heights of the kept cells; 0: current values, 1: written by the
+  //! sweeps
+  t_array<t_real> m_h[2];
+
+  //! momenta in x-direction of the kept cells
+  t_array<t_real> m_hu[2];
+
+  //! momenta in y-direction of the kept cells
+  t_array<t_real> m_hv[2];
+
+  //! bathymetry of the kept cells
+  t_array<t_real> m_b;
+
+  //! types of the x-edges on the right of the kept cells
+  t_array<unsigned char> m_edgeTypeX;
+
+  //! bathymetry jumps of the x-edges on the right of the kept cells
+  t_array<t_real> m_bathJumpX;
+
+  //! types of the y-edges of the overlaps
+  t_array<unsigned char> m_edgeTypeY;
+
+  //! bathymetry jumps of the y-edges of the overlaps
+  t_array<t_real> m_bathJumpY;
+
+  //! true if the edge types and bathymetry jumps match the bathymetry
+  bool m_edgesValid = false;
+
+  //! number of cells of the longest span
+  t_idx m_spanMax = 0;
+
+  //! maximum absolute wave speed of the last time step, 0 if none was done
+  //! since the quantities were set
+  t_real m_speedMax = 0;
+
+  //! CFL number of the time steps
+  t_real m_cfl = 0.5;
+
+  //! true if the extremes of the kept cells are accumulated after every time
+  //! step
+  bool m_extremes = false;
+
+  //! amplitude of the sea surface from which on a wave has arrived at a cell
+  t_real m_arrivalThreshold = 0;
+
+  //! cell width converting the constant time steps to the simulated time
+  t_real m_dxy = 1;
+
+  //! simulated time of the time steps since the construction
+  double m_time = 0;
+
+  //! minimum height of a wet cell of the extremes, shallower cells have no
+  //! meaningful velocity
+  static t_real constexpr m_wetHeight = 0.01;
+
+  //! extremes of the kept cells; 0: maximum absolute sea surface height of
+  //! the wet cells, 1: maximum velocity, 2: arrival time, -1 if none
+  t_array<t_real> m_extremesCells[3];
+
+  //! setup whose bathymetry is output for the dropped cells
+  setups::Setup const *m_setup = nullptr;
+
+  //! quantities of the getters of whole grids, allocated by the first call;
+  //! the output gathers the rows instead, see getRow; 0: heights, 1: momenta
+  //! in x-direction, 2: momenta in y-direction, 3: bathymetry
+  Grid2d<t_real> m_output[4];
+
+  /**
+   * Gets the position of a cell in the stored quantities.
+   *
+   * @param i_x column of the cell including the ghost columns.
+   * @param i_y row of the cell including the ghost rows.
+   * @return position, getNumCells() if the cell is dropped.
+   **/
+  t_idx findCell(t_idx i_x, t_idx i_y) const;
+
+  /**
+   * Derives the types and bathymetry jumps of all edges.
+   **/
+  void initEdges();
+
+  /**
+   * Copies the values of the boundary cells to the kept ghost cells.
+   *
+   * @param io_q values of the kept cells.
+   **/
+  void setGhostOutflow(t_array<t_real> &io_q);
+
+  /**
+   * Performs a time step with the dimensionally split scheme.
+   *
+   * @param i_scaling scaling of the time step (dt / dx), see xSweep.
+   * @return maximum absolute wave speed of the time step.
+   **/
+  t_real step(t_real i_scaling);
+
+  /**
+   * Updates the heights and momenta in x-direction with the net-updates of
+   *the x-edges of all spans.
+   *
+   * @param i_scaling scaling of the time step (dt / dx), 0 leaves the
+   *quantities unchanged and only derives the wave speeds.
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_real xSweep(t_real i_scaling);
+
+  /**
+   * Updates the heights and momenta in y-direction with the net-updates of
+   *the y-edges of all overlaps. The overlaps of every other row are handled
+   *at once, such that no cell is updated by two threads.
+   *
+   * @param i_scaling scaling of the time step (dt / dy), 0 leaves the
+   *quantities unchanged and only derives the wave speeds.
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_real ySweep(t_real i_scaling);
+
+  /**
+   * Accumulates the extremes of the kept cells from the current quantities.
+   **/
+  void extremesCells();
+
+  /**
+   * Gathers a quantity to a grid of the whole domain, which is allocated by
+   *the first call.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry.
+   * @return interior cells of the grid.
+   **/
+  t_real const *gather(unsigned short i_quantity);
+
+ public:
+  /**
+   * Constructs the solver and keeps the cells of the setup which are water,
+   *i.e., whose bathymetry is negative, or whose distance to water is not
+   *larger than the margin in both directions.
+   *
+   * @param i_xCells number of cells in x-direction.
+   * @param i_yCells number of cells in y-direction.
+   * @param i_setup setup whose bathymetry is queried, which has to outlive the
+   *output of the solver.
+   * @param i_margin number of land cells kept next to the water, at least
+   *one.
+   **/
+  SparseWavePropagation2d(t_idx i_xCells, t_idx i_yCells,
+                          setups::Setup const &i_setup, t_idx i_margin);
+
+  /**
+   * Gets the number of kept cells including the ghost cells.
+   *
+   * @return number of cells.
+   **/
+  t_idx getNumCells() const { return m_b.size(); }
+
+  /**
+   * Gets the number of spans of all rows.
+   *
+   * @return number of spans.
+   **/
+  t_idx getNumSpans() const { return m_spans.size(); }
+
+  /**
+   * Performs time steps.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_computeSteps number of time steps.
+   **/
+  void timeStep(t_real i_scaling, t_idx i_computeSteps);
+
+  /**
+   * Performs time steps with the largest stable time step, which is derived
+   *from the maximum wave speed of the previous step.
+   *
+   * @param i_dxy cell size.
+   * @param i_computeSteps number of time steps.
+   * @return simulated time of all time steps.
+   **/
+  t_real timeStepAdaptive(t_real i_dxy, t_idx i_computeSteps);
+
+  /**
+   * Enables or disables the accumulation of the maximum absolute sea surface
+   *height, the maximum velocity and the arrival time of the kept cells after
+   *every time step and resets them. The dropped cells stay dry.
+   *
+   * @param i_enabled true if the extremes are accumulated.
+   * @param i_threshold amplitude of the sea surface from which on a wave has
+   *arrived at a cell.
+   * @param i_dxy cell width, converts the scaling of timeStep to the
+   *simulated time. timeStepAdaptive uses its own.
+   * @return true.
+   **/
+  bool setExtremes(bool i_enabled, t_real i_threshold = 0.01,
+                   t_real i_dxy = 1);
+
+  /**
+   * Gets the stride in y-direction of the gathered quantities.
+   *
+   * @return stride in y-direction.
+   **/
+  t_idx getStride() { return Grid2d<t_real>::paddedStride(m_xCells + 2); }
+
+  /**
+   * Gets the cells' water heights, 0 for the dropped cells.
+   *
+   * @return water heights.
+   **/
+  t_real const *getHeight() { return gather(0); }
+
+  /**
+   * Gets the cells' momenta in x-direction, 0 for the dropped cells.
+   *
+   * @return momenta in x-direction.
+   **/
+  t_real const *getMomentumX() { return gather(1); }
+
+  /**
+   * Gets the cells' momenta in y-direction, 0 for the dropped cells.
+   *
+   * @return momenta in y-direction.
+   **/
+  t_real const *getMomentumY() { return gather(2); }
+
+  /**
+   * Gets the cells' bathymetry, the one of the setup for the dropped cells.
+   *
+   * @return bathymetry.
+   **/
+  t_real const *getBathymetry() { return gather(3); }
+
+  /**
+   * Gets the interior cells of a row of a quantity, the values of the kept
+   *cells are copied into the buffer and the ones of the dropped cells are
+   *filled in.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry, 4-6: extremes, see setExtremes, which are 0
+   *and -1 for the arrival times of the dropped cells.
+   * @param i_iy id of the row.
+   * @param io_row buffer of a row.
+   * @return values of the row's interior cells.
+   **/
+  t_real const *getRow(unsigned short i_quantity, t_idx i_iy,
+                       t_real *io_row);
+
+  /**
+   * Sets the height of a kept cell, dropped cells are ignored.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_h water height.
+   **/
+  void setHeight(t_idx i_ix, t_idx i_iy, t_real i_h);
+
+  /**
+   * Sets the momentum in x-direction of a kept cell, dropped cells are
+   *ignored.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_hu momentum in x-direction.
+   **/
+  void setMomentumX(t_idx i_ix, t_idx i_iy, t_real i_hu);
+
+  /**
+   * Sets the momentum in y-direction of a kept cell, dropped cells are
+   *ignored.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_hv momentum in y-direction.
+   **/
+  void setMomentumY(t_idx i_ix, t_idx i_iy, t_real i_hv);
+
+  /**
+   * Sets the bathymetry of a kept cell, dropped cells keep the one of the
+   *setup.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @param i_b bathymetry value of the cell.
+   **/
+  void setBathymetry(t_idx i_ix, t_idx i_iy, t_real i_b);
+
+  /**
+   * Invalidates the wave speed and the edges derived from the cells.
+   **/
+  void finishSetup();
+
+  /**
+   * The boundaries are outflow, reflecting ones are not supported.
+   **/
+  void setReflection(t_idx, bool, bool) {}
+
+  void MemTransfer() {}
+};
+
+#endif
@@ -0,0 +1,282 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the wave propagation patch which only stores the cells near
+ * water.
+ **/
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include "../Arena.h"
+#include "SparseWavePropagation2d.h"
+#include "WavePropagation2d.h"
+
+/**
+ * Basin with a hump next to the left boundary, an island and a coast on the
+ *right.
+ **/
+class Basin : public tsunami_lab::setups::Setup {
+ public:
+  tsunami_lab::t_real getHeight(tsunami_lab::t_idx i_x,
+                                tsunami_lab::t_idx i_y) const {
+    float l_b = getBathymetry(i_x, i_y);
+    float l_dX = i_x - 4.0f;
+    float l_dY = i_y - 12.0f;
+    return l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 5) : 0;
+  }
+
+  tsunami_lab::t_real getMomentumX(tsunami_lab::t_idx,
+                                   tsunami_lab::t_idx) const {
+    return 0;
+  }
+
+  tsunami_lab::t_real getMomentumY(tsunami_lab::t_idx,
+                                   tsunami_lab::t_idx) const {
+    return 0;
+  }
+
+  tsunami_lab::t_real getBathymetry(tsunami_lab::t_idx i_x,
+                                    tsunami_lab::t_idx i_y) const {
+    if (i_x >= 14 && i_x <= 20 && i_y >= 3 && i_y <= 7) return 2;
+    return -10 + 0.3f * i_x + (float)(i_y % 3);
+  }
+};
+
+/**
+ * Basin whose water is the left third of the domain.
+ **/
+class Strip : public tsunami_lab::setups::Setup {
+ public:
+  tsunami_lab::t_real getHeight(tsunami_lab::t_idx i_x,
+                                tsunami_lab::t_idx) const {
+    return i_x < 10 ? 5 : 0;
+  }
+
+  tsunami_lab::t_real getMomentumX(tsunami_lab::t_idx,
+                                   tsunami_lab::t_idx) const {
+    return 0;
+  }
+
+  tsunami_lab::t_real getMomentumY(tsunami_lab::t_idx,
+                                   tsunami_lab::t_idx) const {
+    return 0;
+  }
+
+  tsunami_lab::t_real getBathymetry(tsunami_lab::t_idx i_x,
+                                    tsunami_lab::t_idx) const {
+    return i_x < 10 ? -5 : 5;
+  }
+};
+
+/**
+ * Sets the quantities of a setup.
+ *
+ * @param i_setup setup.
+ * @param io_waveProp solver.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ **/
+static void setup(tsunami_lab::setups::Setup const &i_setup,
+                  tsunami_lab::patches::WavePropagation &io_waveProp,
+                  std::size_t i_nx, std::size_t i_ny) {
+  for (std::size_t l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+      io_waveProp.setHeight(l_ceX, l_ceY, i_setup.getHeight(l_ceX, l_ceY));
+      io_waveProp.setMomentumX(l_ceX, l_ceY,
+                               i_setup.getMomentumX(l_ceX, l_ceY));
+      io_waveProp.setMomentumY(l_ceX, l_ceY,
+                               i_setup.getMomentumY(l_ceX, l_ceY));
+      io_waveProp.setBathymetry(l_ceX, l_ceY,
+                                i_setup.getBathymetry(l_ceX, l_ceY));
+    }
+  }
+  io_waveProp.finishSetup();
+}
+
+TEST_CASE("Test the sparse storage of the cells near water.",
+          "[SparseWaveProp2d]") {
+  /*
+   * Test case:
+   *
+   *   Water is the left 10 of 30 columns, a margin of 2 keeps 12 columns and
+   *   the ghost cells next to them:
+   *
+   *     8 * 12 interior cells + 2 * 12 ghost row cells + 10 left ghost cells
+   *
+   *   One span per row including the ghost rows.
+   */
+  Strip l_strip;
+  tsunami_lab::patches::SparseWavePropagation2d l_stripProp(30, 8, l_strip,
+                                                            2);
+  REQUIRE(l_stripProp.getNumCells() == 130);
+  REQUIRE(l_stripProp.getNumSpans() == 10);
+
+  // the margin is at least one cell
+  tsunami_lab::patches::SparseWavePropagation2d l_stripProp0(30, 8, l_strip,
+                                                             0);
+  REQUIRE(l_stripProp0.getNumCells() == 8 * 11 + 2 * 11 + 10);
+
+  /*
+   * Test case:
+   *
+   *   A hump spreads in a basin with an island and a coast on the right. The
+   *   centers of the island and the coast are dropped. The kept cells match
+   *   those of the full grid for constant and adaptive time steps, the
+   *   dropped ones are zero.
+   */
+  std::size_t l_nx = 40;
+  std::size_t l_ny = 25;
+  Basin l_basin;
+
+  tsunami_lab::patches::WavePropagation2d<> l_dense(l_nx, l_ny);
+  setup(l_basin, l_dense, l_nx, l_ny);
+  l_dense.timeStep(0.02, 3);
+  float l_timeDense = l_dense.timeStepAdaptive(1, 5);
+  l_timeDense += l_dense.timeStepAdaptive(1, 4);
+
+  for (std::size_t l_ma = 1; l_ma < 4; l_ma++) {
+    tsunami_lab::patches::SparseWavePropagation2d l_sparse(l_nx, l_ny,
+                                                           l_basin, l_ma);
+    REQUIRE(l_sparse.getNumCells() < (l_nx + 2) * (l_ny + 2));
+    setup(l_basin, l_sparse, l_nx, l_ny);
+
+    l_sparse.timeStep(0.02, 3);
+    float l_time = l_sparse.timeStepAdaptive(1, 5);
+    l_time += l_sparse.timeStepAdaptive(1, 4);
+    REQUIRE(l_time == Approx(l_timeDense));
+
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_dense.getStride();
+        std::size_t l_ceSparse = l_ceX + l_ceY * l_sparse.getStride();
+        REQUIRE(l_sparse.getBathymetry()[l_ceSparse] ==
+                l_dense.getBathymetry()[l_ce]);
+
+        // the dropped cells are land whose water is at rest
+        REQUIRE(l_sparse.getHeight()[l_ceSparse] ==
+                Approx(l_dense.getHeight()[l_ce]).margin(1E-5));
+        REQUIRE(l_sparse.getMomentumX()[l_ceSparse] ==
+                Approx(l_dense.getMomentumX()[l_ce]).margin(1E-5));
+        REQUIRE(l_sparse.getMomentumY()[l_ceSparse] ==
+                Approx(l_dense.getMomentumY()[l_ce]).margin(1E-5));
+      }
+    }
+  }
+}
+
+TEST_CASE("Test the rows of the output of the sparse storage.",
+          "[SparseWaveProp2dRows]") {
+  /*
+   * Test case:
+   *
+   *   Water is the left 10 of 300 columns. The rows of the output are
+   *   gathered into the buffer of a row, thus the kept cells and their edges
+   *   are the only allocations of the setup, the time steps and the output:
+   *   at most 38 bytes per kept cell, while four float grids of the whole
+   *   domain would be about 12 times as large. The dropped cells are output
+   *   with the bathymetry of the setup.
+   */
+  std::size_t l_nx = 300;
+  std::size_t l_ny = 80;
+  Strip l_strip;
+
+  tsunami_lab::Arena l_arena(64 << 20);
+  tsunami_lab::Arena::setGlobal(&l_arena);
+  {
+    tsunami_lab::patches::SparseWavePropagation2d l_sparse(l_nx, l_ny,
+                                                           l_strip, 2);
+    setup(l_strip, l_sparse, l_nx, l_ny);
+    l_sparse.timeStepAdaptive(1, 4);
+
+    std::vector<float> l_row(l_nx);
+    for (unsigned short l_qu = 0; l_qu < 4; l_qu++) {
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        float const *l_values = l_sparse.getRow(l_qu, l_ceY, l_row.data());
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          if (l_qu == 3) {
+            REQUIRE(l_values[l_ceX] == l_strip.getBathymetry(l_ceX, l_ceY));
+          } else if (l_ceX >= 12) {
+            REQUIRE(l_values[l_ceX] == 0);
+          }
+        }
+      }
+    }
+
+    // the arrays of the kept cells are aligned to 64 bytes
+    REQUIRE(l_arena.getPeak() <= 38 * l_sparse.getNumCells() + 13 * 64);
+  }
+  tsunami_lab::Arena::setGlobal(nullptr);
+}
+
+TEST_CASE("Test the extremes of the sparse storage.",
+          "[SparseWaveProp2dExtremes]") {
+  /*
+   * Test case:
+   *
+   *   A hump spreads in the basin with the island and the coast. The extremes
+   *   of the kept cells match those of the full grid for constant and
+   *   adaptive time steps, the dropped cells stay dry and the wave never
+   *   arrives.
+   */
+  std::size_t l_nx = 40;
+  std::size_t l_ny = 25;
+  Basin l_basin;
+
+  tsunami_lab::patches::WavePropagation2d<> l_dense(l_nx, l_ny);
+  setup(l_basin, l_dense, l_nx, l_ny);
+  l_dense.setExtremes(true, 0.05f, 1);
+  l_dense.timeStep(0.02, 3);
+  l_dense.timeStepAdaptive(1, 5);
+  l_dense.timeStepAdaptive(1, 4);
+
+  tsunami_lab::patches::SparseWavePropagation2d l_sparse(l_nx, l_ny, l_basin,
+                                                         2);
+  setup(l_basin, l_sparse, l_nx, l_ny);
+  REQUIRE(l_sparse.setExtremes(true, 0.05f, 1));
+  l_sparse.timeStep(0.02, 3);
+  l_sparse.timeStepAdaptive(1, 5);
+  l_sparse.timeStepAdaptive(1, 4);
+
+  std::vector<float> l_row(l_nx);
+  std::size_t l_nArrived = 0;
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    float const *l_extremes[3] = {l_dense.getMaxAmplitude(),
+                                  l_dense.getMaxVelocity(),
+                                  l_dense.getArrivalTime()};
+    for (unsigned short l_ex = 0; l_ex < 3; l_ex++) {
+      float const *l_values = l_sparse.getRow(4 + l_ex, l_ceY, l_row.data());
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        float l_value = l_extremes[l_ex][l_ceX + l_ceY * l_dense.getStride()];
+        REQUIRE(l_values[l_ceX] == Approx(l_value).margin(1E-4));
+        if (l_ex == 2 && l_values[l_ceX] >= 0) l_nArrived++;
+      }
+    }
+  }
+  REQUIRE(l_nArrived > 0);
+}
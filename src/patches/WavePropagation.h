@@ -53,6 +53,15 @@ class tsunami_lab::patches::WavePropagation {
    **/
   virtual void timeStep(t_real i_scaling, t_idx i_computeSteps) = 0;
 
+  /**
+   * Performs time steps with the largest stable time step of each step.
+   *
+   * @param i_dxy cell size.
+   * @param i_computeSteps number of time steps.
+   * @return simulated time of all time steps.
+   **/
+  virtual t_real timeStepAdaptive(t_real i_dxy, t_idx i_computeSteps) = 0;
+
 
   /**
    * Gets the stride in y-direction. x-direction is stride-1.
@@ -89,6 +98,50 @@ class tsunami_lab::patches::WavePropagation {
    **/
   virtual t_real const *getBathymetry() = 0;
 
+  /**
+   * Gets the interior cells of a row of a quantity, e.g., for the output.
+   *The rows may be gathered by several threads at once. By default, the row
+   *is taken from the getter of the whole grid.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry; the extremes of setExtremes if it accumulates
+   *them, 4: maximum absolute sea surface heights, 5: maximum velocities, 6:
+   *arrival times.
+   * @param i_iy id of the row.
+   * @param io_row buffer of a row, which patches may convert the row into.
+   * @return values of the row's interior cells.
+   **/
+  virtual t_real const *getRow(unsigned short i_quantity, t_idx i_iy,
+                               t_real *io_row) {
+    (void)io_row;
+    t_real const *l_q = (i_quantity == 0)   ? getHeight()
+                        : (i_quantity == 1) ? getMomentumX()
+                        : (i_quantity == 2) ? getMomentumY()
+                                            : getBathymetry();
+    return l_q + i_iy * getStride();
+  }
+
+  /**
+   * Enables or disables the accumulation of the maximum absolute sea surface
+   *height, the maximum velocity and the arrival time of every interior cell
+   *after every time step and resets them. The extremes are gathered by
+   *getRow. By default, the patch does not accumulate them.
+   *
+   * @param i_enabled true if the extremes are accumulated.
+   * @param i_threshold amplitude of the sea surface from which on a wave has
+   *arrived at a cell.
+   * @param i_dxy cell width, converts the scaling of timeStep to the
+   *simulated time.
+   * @return true if the patch accumulates the extremes.
+   **/
+  virtual bool setExtremes(bool i_enabled, t_real i_threshold = 0.01,
+                           t_real i_dxy = 1) {
+    (void)i_enabled;
+    (void)i_threshold;
+    (void)i_dxy;
+    return false;
+  }
+
   /**
    * Sets the height of the cell to the given value.
    *
@@ -126,6 +179,13 @@ class tsunami_lab::patches::WavePropagation {
 
   virtual void setBathymetry(t_idx i_ix, t_idx i_y, t_real i_b) = 0;
 
+  /**
+   * Finishes the setup of the cells. The setters only write their cell and
+   *may be called concurrently for distinct cells, thus state derived from
+   *the cells is invalidated once by this call after all cells were set.
+   **/
+  virtual void finishSetup() {}
+
   /**
    * Sets the ghost cells in row y to reflecting or not.
    * @param i_iy row in which the ghost cells are set.
@@ -32,179 +32,2099 @@
 #include "WavePropagation2d.h"
 
 #include <omp.h>
+#include <unistd.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "../solvers/fwave.h"
 
-tsunami_lab::patches::WavePropagation2d::WavePropagation2d(t_idx i_xCells,
-                                                           t_idx i_yCells) {
+template <typename T_precision>
+tsunami_lab::patches::WavePropagation2d<T_precision>::WavePropagation2d(
+    t_idx i_xCells, t_idx i_yCells, bool i_inPlace) {
   m_xCells = i_xCells;
   m_yCells = i_yCells;
+  m_inPlace = i_inPlace;
 
-  // allocate memory including ghostcells on each side.
-  for (unsigned short l_st = 0; l_st < 2; l_st++) {
-    m_h[l_st] = new t_real[(m_xCells + 2) * (m_yCells + 2)];
-    m_hu[l_st] = new t_real[(m_xCells + 2) * (m_yCells + 2)];
-    m_hv[l_st] = new t_real[(m_xCells + 2) * (m_yCells + 2)];
+  // allocate memory including ghostcells on each side, the grids share the
+  // stride of the bathymetry; the in-place mode has no second buffer
+  unsigned short l_nBuffers = m_inPlace ? 1 : 2;
+  m_b = Grid2d<t_bath>(m_xCells, m_yCells, 1, 0, false);
+  for (unsigned short l_st = 0; l_st < l_nBuffers; l_st++) {
+    m_h[l_st] = Grid2d<t_store>(m_xCells, m_yCells, 1, getStride(), false);
+    m_hu[l_st] = Grid2d<t_store>(m_xCells, m_yCells, 1, getStride(), false);
+    m_hv[l_st] = Grid2d<t_store>(m_xCells, m_yCells, 1, getStride(), false);
   }
-  m_b = new t_real[(m_xCells + 2) * (m_yCells + 2)];
+  m_edgeTypeX =
+      Grid2d<unsigned char>(m_xCells, m_yCells, 1, getStride(), false);
+  m_edgeTypeY =
+      Grid2d<unsigned char>(m_xCells, m_yCells, 1, getStride(), false);
+  m_bathJumpX = Grid2d<t_jump>(m_xCells, m_yCells, 1, getStride(), false);
+  m_bathJumpY = Grid2d<t_jump>(m_xCells, m_yCells, 1, getStride(), false);
 
-// init to zero
-#pragma omp parallel for simd schedule(static, 4)
-  for (unsigned long l_ceY = 0; l_ceY < (m_yCells + 2); l_ceY++) {
-    for (unsigned long l_ceX = 0; l_ceX < (m_xCells + 2); l_ceX++) {
-      unsigned long l_ce = l_ceX + l_ceY * (m_xCells + 2);
-      m_b[l_ce] = 0;
-      for (unsigned short l_st = 0; l_st < 2; l_st++) {
-        m_h[l_st][l_ce] = 0;
-        m_hu[l_st][l_ce] = 0;
-        m_hv[l_st][l_ce] = 0;
+  // init to zero; the first touch places the pages on the NUMA node of the
+  // thread, thus every thread touches the block of rows it sweeps later
+#pragma omp parallel
+  {
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(m_yCells + 2, l_first, l_last);
+
+    m_b.fillRows(l_first, l_last, 0);
+    for (unsigned short l_st = 0; l_st < l_nBuffers; l_st++) {
+      m_h[l_st].fillRows(l_first, l_last, 0);
+      m_hu[l_st].fillRows(l_first, l_last, 0);
+      m_hv[l_st].fillRows(l_first, l_last, 0);
+    }
+    m_edgeTypeX.fillRows(l_first, l_last, 0);
+    m_edgeTypeY.fillRows(l_first, l_last, 0);
+    m_bathJumpX.fillRows(l_first, l_last, 0);
+    m_bathJumpY.fillRows(l_first, l_last, 0);
+  }
+
+  // the rows and edge fluxes of a strip of the y-sweep fit into half of the
+  // L2 cache; two rows of heights and momenta are read and one is written,
+  // six edge fluxes are carried and the edges are read
+  long l_cacheSize = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (l_cacheSize <= 0) l_cacheSize = 1024 * 1024;
+  m_yStripWidth = std::max((t_idx)(l_cacheSize / 2) /
+                               (13 * sizeof(t_store) + sizeof(unsigned char)),
+                           (t_idx)64);
+
+  // quantized bathymetry covers the depth of the oceans by default
+  if (std::is_integral<t_bath>::value) setBathymetryRange(-11000, 11000);
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::rowBlock(
+    t_idx i_nRows, t_idx &o_first, t_idx &o_last) {
+  t_idx l_nThreads = omp_get_num_threads();
+  t_idx l_thread = omp_get_thread_num();
+
+  o_first = (i_nRows * l_thread) / l_nThreads;
+  o_last = (i_nRows * (l_thread + 1)) / l_nThreads;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::initEdges() {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+
+  // the classification overwrites the staged cells
+  if (m_staging) encodeStaged();
+
+#pragma omp parallel
+  {
+    // decoded bathymetry of a row and the row above
+    std::vector<t_jump> l_b(2 * l_nCols);
+
+#pragma omp for schedule(static)
+    for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+      t_idx l_ce = calculateArrayPosition(0, l_ceY);
+      t_idx l_nDecoded = (l_ceY < l_nRows - 1) ? 2 * l_nCols : l_nCols;
+      for (t_idx l_ceX = 0; l_ceX < l_nDecoded; l_ceX++) {
+        t_idx l_ceB = l_ce + (l_ceX / l_nCols) * getStride() + l_ceX % l_nCols;
+        l_b[l_ceX] = m_coding.decodeBathymetry(m_b[l_ceB]);
+      }
+
+      // edges in x-direction
+      solvers::fwave::classifyEdges<t_compute>(
+          l_nCols - 1, l_b.data(), l_b.data() + 1, m_edgeTypeX.data() + l_ce,
+          m_bathJumpX.data() + l_ce);
+      m_edgeTypeX[l_ce + l_nCols - 1] = solvers::fwave::m_dryDry;
+      m_bathJumpX[l_ce + l_nCols - 1] = 0;
+
+      // edges in y-direction
+      if (l_ceY < l_nRows - 1) {
+        solvers::fwave::classifyEdges<t_compute>(
+            l_nCols, l_b.data(), l_b.data() + l_nCols,
+            m_edgeTypeY.data() + l_ce, m_bathJumpY.data() + l_ce);
+      } else {
+        for (t_idx l_ceX = 0; l_ceX < l_nCols; l_ceX++) {
+          m_edgeTypeY[l_ce + l_ceX] = solvers::fwave::m_dryDry;
+          m_bathJumpY[l_ce + l_ceX] = 0;
+        }
       }
     }
   }
+
+  // the cost of the rows depends on the edges
+  m_nQueues = 0;
+  m_edgesValid = true;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::initBalancing() {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_nQueues = omp_get_max_threads();
+  t_idx l_nChunks = l_nQueues * m_chunksPerQueue;
+
+  std::vector<double> l_cost(l_nRows);
+#pragma omp parallel for schedule(static)
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+    t_idx l_ce = calculateArrayPosition(0, l_ceY);
+    t_idx l_nWet = 0;
+    for (t_idx l_ceX = 0; l_ceX < l_nCols; l_ceX++) {
+      l_nWet += m_edgeTypeX[l_ce + l_ceX] != solvers::fwave::m_dryDry;
+      l_nWet += m_edgeTypeY[l_ce + l_ceX] != solvers::fwave::m_dryDry;
+    }
+    l_cost[l_ceY] = l_nCols + m_wetEdgeCost * l_nWet;
+  }
+
+  double l_costTotal = 0;
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) l_costTotal += l_cost[l_ceY];
+
+  // a chunk ends at the first row whose prefix sum reaches its share
+  m_chunkRows.assign(l_nChunks + 1, l_nRows);
+  m_chunkRows[0] = 0;
+  double l_costSum = 0;
+  t_idx l_ch = 1;
+  for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+    l_costSum += l_cost[l_ceY];
+    while (l_ch < l_nChunks && l_costSum >= l_costTotal * l_ch / l_nChunks) {
+      m_chunkRows[l_ch++] = l_ceY + 1;
+    }
+  }
+
+  m_nQueues = l_nQueues;
 }
 
-tsunami_lab::patches::WavePropagation2d::~WavePropagation2d() {
-  delete[] m_b;
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::initQueues(
+    std::vector<RowQueue> &o_queues) const {
+  std::vector<RowQueue> l_queues(m_balanced ? m_nQueues : 0);
+  o_queues.swap(l_queues);
 
-  for (unsigned short l_st = 0; l_st < 2; l_st++) {
-    delete[] m_h[l_st];
-    delete[] m_hu[l_st];
-    delete[] m_hv[l_st];
+  for (t_idx l_qu = 0; l_qu < o_queues.size(); l_qu++) {
+    o_queues[l_qu].m_next.store(l_qu * m_chunksPerQueue,
+                                std::memory_order_relaxed);
+    o_queues[l_qu].m_end = (l_qu + 1) * m_chunksPerQueue;
   }
 }
 
-void tsunami_lab::patches::WavePropagation2d::timeStep(t_real i_scaling,
-                                                       t_idx computeSteps) {
-  setGhostOutflow();
+template <typename T_precision>
+bool tsunami_lab::patches::WavePropagation2d<T_precision>::claimRows(
+    std::vector<RowQueue> &io_queues, t_idx &io_visited, t_idx &o_first,
+    t_idx &o_last) const {
+  if (io_queues.empty()) {
+    if (io_visited > 0) return false;
+    io_visited = 1;
+    rowBlock(m_yCells + 2, o_first, o_last);
+    return true;
+  }
+
+  // own queue first, the queues of the following threads hold the rows
+  // next to the own ones
+  t_idx l_nQueues = io_queues.size();
+  t_idx l_thread = omp_get_thread_num();
+  while (io_visited < l_nQueues) {
+    RowQueue &l_queue = io_queues[(l_thread + io_visited) % l_nQueues];
+    t_idx l_chunk = l_queue.m_next.fetch_add(1, std::memory_order_relaxed);
+    if (l_chunk < l_queue.m_end) {
+      o_first = m_chunkRows[l_chunk];
+      o_last = m_chunkRows[l_chunk + 1];
+      return true;
+    }
+    io_visited++;
+  }
+
+  return false;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::addBusyTimes(
+    std::vector<double> const &i_busy) {
+  double l_max = 0;
+  double l_sum = 0;
+  for (t_idx l_th = 0; l_th < i_busy.size(); l_th++) {
+    l_max = std::max(l_max, i_busy[l_th]);
+    l_sum += i_busy[l_th];
+  }
+
+  m_busyMax += l_max;
+  m_busyMean += l_sum / i_busy.size();
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::netUpdatesRow(
+    t_idx i_nEdges, t_store const *i_hL, t_store const *i_hR,
+    t_store const *i_huL, t_store const *i_huR, t_bath const *i_bL,
+    t_bath const *i_bR, Coding const &i_coding, unsigned char const *i_edgeType,
+    t_jump const *i_bathJump, t_compute *o_netUpdateHL,
+    t_compute *o_netUpdateHuL, t_compute *o_netUpdateHR,
+    t_compute *o_netUpdateHuR) {
+  t_compute l_speedMax = 0;
+
+  t_idx l_ed = 0;
+  while (l_ed < i_nEdges) {
+    // edges between two dry cells have no net-updates
+    while (l_ed < i_nEdges && i_edgeType[l_ed] == solvers::fwave::m_dryDry) {
+      o_netUpdateHL[l_ed] = 0;
+      o_netUpdateHuL[l_ed] = 0;
+      o_netUpdateHR[l_ed] = 0;
+      o_netUpdateHuR[l_ed] = 0;
+      l_ed++;
+    }
+
+    // the remaining edges are passed to the solver run by run
+    t_idx l_edEnd = l_ed;
+    while (l_edEnd < i_nEdges &&
+           i_edgeType[l_edEnd] != solvers::fwave::m_dryDry) {
+      l_edEnd++;
+    }
+    if (l_edEnd > l_ed) {
+      t_compute l_speed = netUpdatesRun(
+          std::integral_constant<bool, T_precision::m_relative>(),
+          l_edEnd - l_ed, i_hL + l_ed, i_hR + l_ed, i_huL + l_ed, i_huR + l_ed,
+          i_bL + l_ed, i_bR + l_ed, i_coding, i_edgeType + l_ed,
+          i_bathJump + l_ed, o_netUpdateHL + l_ed, o_netUpdateHuL + l_ed,
+          o_netUpdateHR + l_ed, o_netUpdateHuR + l_ed);
+      l_speedMax = std::max(l_speedMax, l_speed);
+    }
+    l_ed = l_edEnd;
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+template <typename T>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::netUpdatesRun(
+    std::false_type, t_idx i_nEdges, T const *i_hL, T const *i_hR,
+    T const *i_huL, T const *i_huR, t_bath const *, t_bath const *,
+    Coding const &, unsigned char const *i_edgeType, T const *i_bathJump,
+    t_compute *o_netUpdateHL, t_compute *o_netUpdateHuL,
+    t_compute *o_netUpdateHR, t_compute *o_netUpdateHuR) {
+  return solvers::fwave::netUpdatesBatch(
+      i_nEdges, i_hL, i_hR, i_huL, i_huR, i_edgeType, i_bathJump,
+      o_netUpdateHL, o_netUpdateHuL, o_netUpdateHR, o_netUpdateHuR);
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::netUpdatesRun(
+    std::true_type, t_idx i_nEdges, t_store const *i_hL, t_store const *i_hR,
+    t_store const *i_huL, t_store const *i_huR, t_bath const *i_bL,
+    t_bath const *i_bR, Coding const &i_coding, unsigned char const *i_edgeType,
+    t_jump const *i_bathJump, t_compute *o_netUpdateHL,
+    t_compute *o_netUpdateHuL, t_compute *o_netUpdateHR,
+    t_compute *o_netUpdateHuR) {
+  // decoded heights and momenta of a chunk, which stays in the L1 cache
+  t_idx const l_nChunk = 256;
+  t_jump l_q[4][l_nChunk];
+  t_compute l_speedMax = 0;
+
+  for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed += l_nChunk) {
+    t_idx l_nEdges = std::min(l_nChunk, i_nEdges - l_ed);
+    for (t_idx l_ch = 0; l_ch < l_nEdges; l_ch++) {
+      l_q[0][l_ch] =
+          i_coding.decodeHeight(i_hL[l_ed + l_ch], i_bL[l_ed + l_ch]);
+      l_q[1][l_ch] =
+          i_coding.decodeHeight(i_hR[l_ed + l_ch], i_bR[l_ed + l_ch]);
+      l_q[2][l_ch] = i_huL[l_ed + l_ch];
+      l_q[3][l_ch] = i_huR[l_ed + l_ch];
+    }
+
+    t_compute l_speed = solvers::fwave::netUpdatesBatch(
+        l_nEdges, l_q[0], l_q[1], l_q[2], l_q[3], i_edgeType + l_ed,
+        i_bathJump + l_ed, o_netUpdateHL + l_ed, o_netUpdateHuL + l_ed,
+        o_netUpdateHR + l_ed, o_netUpdateHuR + l_ed);
+    l_speedMax = std::max(l_speedMax, l_speed);
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::xSweepRows(
+    t_idx i_stride, t_idx i_nCols, t_idx i_rowFirst, t_idx i_rowLast,
+    t_idx i_colFirst, t_idx i_colLast, t_compute i_scaling, t_store const *i_h,
+    t_store const *i_hu, t_bath const *i_b, Coding const &i_coding,
+    unsigned char const *i_edgeType, t_jump const *i_bathJump, t_store *o_h,
+    t_store *o_hu, t_compute *o_netUpdates) {
+  // edges adjacent to the updated cells
+  t_idx l_edFirst = (i_colFirst > 0) ? i_colFirst - 1 : 0;
+  t_idx l_edLast = std::min(i_colLast, i_nCols - 1);
+
+  // the outermost cells of a row only have one edge
+  t_idx l_ceFirst = std::max(i_colFirst, (t_idx)1);
+  t_idx l_ceLast = std::min(i_colLast, i_nCols - 1);
+
+  t_compute *l_netUpdatesHL = o_netUpdates;
+  t_compute *l_netUpdatesHuL = o_netUpdates + i_nCols;
+  t_compute *l_netUpdatesHR = o_netUpdates + 2 * i_nCols;
+  t_compute *l_netUpdatesHuR = o_netUpdates + 3 * i_nCols;
+
+  t_compute l_speedMax = 0;
+
+  for (t_idx l_ceY = i_rowFirst; l_ceY < i_rowLast; l_ceY++) {
+    t_idx l_row = l_ceY * i_stride;
+    t_idx l_ce = l_row + l_edFirst;
+
+    // compute net-updates of all edges in the row
+    t_compute l_speed = netUpdatesRow(
+        l_edLast - l_edFirst, i_h + l_ce, i_h + l_ce + 1, i_hu + l_ce,
+        i_hu + l_ce + 1, i_b + l_ce, i_b + l_ce + 1, i_coding,
+        i_edgeType + l_ce, i_bathJump + l_ce, l_netUpdatesHL, l_netUpdatesHuL,
+        l_netUpdatesHR, l_netUpdatesHuR);
+    l_speedMax = std::max(l_speedMax, l_speed);
+
+    // write the new cells' quantities, left edge first
+    if (i_colFirst == 0) {
+      o_h[l_row] = i_h[l_row] - i_scaling * l_netUpdatesHL[0];
+      o_hu[l_row] = i_hu[l_row] - i_scaling * l_netUpdatesHuL[0];
+    }
+#pragma omp simd
+    for (t_idx l_ceX = l_ceFirst; l_ceX < l_ceLast; l_ceX++) {
+      t_idx l_edL = l_ceX - 1 - l_edFirst;
+      t_idx l_edR = l_ceX - l_edFirst;
+
+      o_h[l_row + l_ceX] = i_h[l_row + l_ceX] -
+                           i_scaling * l_netUpdatesHR[l_edL] -
+                           i_scaling * l_netUpdatesHL[l_edR];
+      o_hu[l_row + l_ceX] = i_hu[l_row + l_ceX] -
+                            i_scaling * l_netUpdatesHuR[l_edL] -
+                            i_scaling * l_netUpdatesHuL[l_edR];
+    }
+    if (i_colLast == i_nCols) {
+      t_idx l_ceR = l_row + i_nCols - 1;
+      t_idx l_edL = i_nCols - 2 - l_edFirst;
+
+      o_h[l_ceR] = i_h[l_ceR] - i_scaling * l_netUpdatesHR[l_edL];
+      o_hu[l_ceR] = i_hu[l_ceR] - i_scaling * l_netUpdatesHuR[l_edL];
+    }
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::ySweepRows(
+    t_idx i_stride, t_idx i_nRows, t_idx i_rowFirst, t_idx i_rowLast,
+    t_idx i_colFirst, t_idx i_colLast, t_compute i_scaling, t_store const *i_h,
+    t_store const *i_hv, t_bath const *i_b, Coding const &i_coding,
+    unsigned char const *i_edgeType, t_jump const *i_bathJump, t_store *o_h,
+    t_store *o_hv, t_compute *o_netUpdates) {
+  t_idx l_nCells = i_colLast - i_colFirst;
+
+  // edge-flux buffers of the edges below and above a row, the updates for
+  // the row above are carried over to the next row. The fluxes only depend
+  // on the old values, thus the result does not depend on the first row.
+  t_compute *l_netUpdatesHB = o_netUpdates;
+  t_compute *l_netUpdatesHvB = o_netUpdates + l_nCells;
+  t_compute *l_netUpdatesHT = o_netUpdates + 2 * l_nCells;
+  t_compute *l_netUpdatesHvT = o_netUpdates + 3 * l_nCells;
+  t_compute *l_netUpdatesHNext = o_netUpdates + 4 * l_nCells;
+  t_compute *l_netUpdatesHvNext = o_netUpdates + 5 * l_nCells;
+
+  t_compute l_speedMax = 0;
+
+  // net-updates of the edges below the first row, the bottom row has no
+  // edges below
+  if (i_rowFirst > 0 && i_rowFirst < i_rowLast) {
+    t_idx l_ce = i_rowFirst * i_stride + i_colFirst;
+    t_idx l_ceB = l_ce - i_stride;
+
+    l_speedMax = netUpdatesRow(
+        l_nCells, i_h + l_ceB, i_h + l_ce, i_hv + l_ceB, i_hv + l_ce,
+        i_b + l_ceB, i_b + l_ce, i_coding, i_edgeType + l_ceB,
+        i_bathJump + l_ceB, l_netUpdatesHT, l_netUpdatesHvT, l_netUpdatesHB,
+        l_netUpdatesHvB);
+  } else {
+    for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+      l_netUpdatesHB[l_ed] = 0;
+      l_netUpdatesHvB[l_ed] = 0;
+    }
+  }
+
+  for (t_idx l_ceY = i_rowFirst; l_ceY < i_rowLast; l_ceY++) {
+    // first updated cell in the row and in the row above
+    t_idx l_ce = l_ceY * i_stride + i_colFirst;
+    t_idx l_ceT = l_ce + i_stride;
+
+    // net-updates of the edges above the row, the top row has no edges above
+    if (l_ceY < i_nRows - 1) {
+      t_compute l_speed = netUpdatesRow(
+          l_nCells, i_h + l_ce, i_h + l_ceT, i_hv + l_ce, i_hv + l_ceT,
+          i_b + l_ce, i_b + l_ceT, i_coding, i_edgeType + l_ce,
+          i_bathJump + l_ce, l_netUpdatesHT, l_netUpdatesHvT,
+          l_netUpdatesHNext, l_netUpdatesHvNext);
+      l_speedMax = std::max(l_speedMax, l_speed);
+    } else {
+      for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+        l_netUpdatesHT[l_ed] = 0;
+        l_netUpdatesHvT[l_ed] = 0;
+      }
+    }
+
+    // write the new cells' quantities, bottom edge first
+#pragma omp simd
+    for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+      o_h[l_ce + l_ed] = i_h[l_ce + l_ed] - i_scaling * l_netUpdatesHB[l_ed] -
+                         i_scaling * l_netUpdatesHT[l_ed];
+      o_hv[l_ce + l_ed] = i_hv[l_ce + l_ed] -
+                          i_scaling * l_netUpdatesHvB[l_ed] -
+                          i_scaling * l_netUpdatesHvT[l_ed];
+    }
+
+    // the edges above are the edges below of the next row
+    std::swap(l_netUpdatesHB, l_netUpdatesHNext);
+    std::swap(l_netUpdatesHvB, l_netUpdatesHvNext);
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::unsplitRows(
+    t_idx i_stride, t_idx i_nCols, t_idx i_nRows, t_idx i_rowFirst,
+    t_idx i_rowLast, t_compute i_scaling, t_store const *i_h,
+    t_store const *i_hu, t_store const *i_hv, t_bath const *i_b,
+    Coding const &i_coding, unsigned char const *i_edgeTypeX,
+    t_jump const *i_bathJumpX, unsigned char const *i_edgeTypeY,
+    t_jump const *i_bathJumpY, t_store *o_h, t_store *o_hu, t_store *o_hv,
+    t_compute *o_netUpdates) {
+  // the y-edges of the ghost columns are not evaluated
+  t_idx l_nCells = i_nCols - 2;
+
+  // edge-flux buffers of the x-edges of a row
+  t_compute *l_netUpdatesHL = o_netUpdates;
+  t_compute *l_netUpdatesHuL = o_netUpdates + i_nCols;
+  t_compute *l_netUpdatesHR = o_netUpdates + 2 * i_nCols;
+  t_compute *l_netUpdatesHuR = o_netUpdates + 3 * i_nCols;
+
+  // rolling window of the y-edges below and above a row
+  t_compute *l_netUpdatesY = o_netUpdates + 4 * i_nCols;
+  t_compute *l_netUpdatesHB = l_netUpdatesY;
+  t_compute *l_netUpdatesHvB = l_netUpdatesY + l_nCells;
+  t_compute *l_netUpdatesHT = l_netUpdatesY + 2 * l_nCells;
+  t_compute *l_netUpdatesHvT = l_netUpdatesY + 3 * l_nCells;
+  t_compute *l_netUpdatesHNext = l_netUpdatesY + 4 * l_nCells;
+  t_compute *l_netUpdatesHvNext = l_netUpdatesY + 5 * l_nCells;
+
+  t_compute l_speedMax = 0;
+
+  // y-edges below the first row, the bottom row has no edges below
+  if (i_rowFirst > 0 && i_rowFirst < i_rowLast) {
+    t_idx l_ce = i_rowFirst * i_stride + 1;
+    t_idx l_ceB = l_ce - i_stride;
+
+    l_speedMax = netUpdatesRow(
+        l_nCells, i_h + l_ceB, i_h + l_ce, i_hv + l_ceB, i_hv + l_ce,
+        i_b + l_ceB, i_b + l_ce, i_coding, i_edgeTypeY + l_ceB,
+        i_bathJumpY + l_ceB, l_netUpdatesHT, l_netUpdatesHvT, l_netUpdatesHB,
+        l_netUpdatesHvB);
+  } else {
+    for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+      l_netUpdatesHB[l_ed] = 0;
+      l_netUpdatesHvB[l_ed] = 0;
+    }
+  }
+
+  for (t_idx l_ceY = i_rowFirst; l_ceY < i_rowLast; l_ceY++) {
+    t_idx l_row = l_ceY * i_stride;
+    t_idx l_ce = l_row + 1;
+    t_idx l_ceT = l_ce + i_stride;
+
+    // x-edges of the row
+    t_compute l_speed = netUpdatesRow(
+        i_nCols - 1, i_h + l_row, i_h + l_row + 1, i_hu + l_row,
+        i_hu + l_row + 1, i_b + l_row, i_b + l_row + 1, i_coding,
+        i_edgeTypeX + l_row, i_bathJumpX + l_row, l_netUpdatesHL,
+        l_netUpdatesHuL, l_netUpdatesHR, l_netUpdatesHuR);
+    l_speedMax = std::max(l_speedMax, l_speed);
+
+    // y-edges above the row, the top row has no edges above
+    if (l_ceY < i_nRows - 1) {
+      l_speed = netUpdatesRow(
+          l_nCells, i_h + l_ce, i_h + l_ceT, i_hv + l_ce, i_hv + l_ceT,
+          i_b + l_ce, i_b + l_ceT, i_coding, i_edgeTypeY + l_ce,
+          i_bathJumpY + l_ce, l_netUpdatesHT, l_netUpdatesHvT,
+          l_netUpdatesHNext, l_netUpdatesHvNext);
+      l_speedMax = std::max(l_speedMax, l_speed);
+    } else {
+      for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+        l_netUpdatesHT[l_ed] = 0;
+        l_netUpdatesHvT[l_ed] = 0;
+      }
+    }
+
+    // write the new cells' quantities, the ghost columns first
+    t_idx l_ceR = l_row + i_nCols - 1;
+
+    o_h[l_row] = i_h[l_row] - i_scaling * l_netUpdatesHL[0];
+    o_hu[l_row] = i_hu[l_row] - i_scaling * l_netUpdatesHuL[0];
+    o_hv[l_row] = i_hv[l_row];
+    o_h[l_ceR] = i_h[l_ceR] - i_scaling * l_netUpdatesHR[i_nCols - 2];
+    o_hu[l_ceR] = i_hu[l_ceR] - i_scaling * l_netUpdatesHuR[i_nCols - 2];
+    o_hv[l_ceR] = i_hv[l_ceR];
+
+#pragma omp simd
+    for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+      // x-edges left and right of the cell
+      t_idx l_edL = l_ed;
+      t_idx l_edR = l_ed + 1;
+
+      o_h[l_ce + l_ed] =
+          i_h[l_ce + l_ed] - i_scaling * l_netUpdatesHR[l_edL] -
+          i_scaling * l_netUpdatesHL[l_edR] - i_scaling * l_netUpdatesHB[l_ed] -
+          i_scaling * l_netUpdatesHT[l_ed];
+      o_hu[l_ce + l_ed] = i_hu[l_ce + l_ed] -
+                          i_scaling * l_netUpdatesHuR[l_edL] -
+                          i_scaling * l_netUpdatesHuL[l_edR];
+      o_hv[l_ce + l_ed] = i_hv[l_ce + l_ed] -
+                          i_scaling * l_netUpdatesHvB[l_ed] -
+                          i_scaling * l_netUpdatesHvT[l_ed];
+    }
+
+    // the edges above are the edges below of the next row
+    std::swap(l_netUpdatesHB, l_netUpdatesHNext);
+    std::swap(l_netUpdatesHvB, l_netUpdatesHvNext);
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::unsplitStep(
+    t_compute i_scaling) {
+  t_compute l_speedMax = 0;
+  std::vector<RowQueue> l_queues;
+  initQueues(l_queues);
+  std::vector<double> l_busy(omp_get_max_threads(), 0);
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    double l_start = omp_get_wtime();
+
+    // thread-private edge-flux buffers
+    t_compute *l_netUpdates = new t_compute[10 * (m_xCells + 2)];
+
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    t_idx l_visited = 0;
+    while (claimRows(l_queues, l_visited, l_first, l_last)) {
+      t_compute l_speed = unsplitRows(
+          getStride(), m_xCells + 2, m_yCells + 2, l_first, l_last, i_scaling,
+          m_h[0].data(), m_hu[0].data(), m_hv[0].data(), m_b.data(), m_coding,
+          m_edgeTypeX.data(), m_bathJumpX.data(), m_edgeTypeY.data(),
+          m_bathJumpY.data(), m_h[1].data(), m_hu[1].data(), m_hv[1].data(),
+          l_netUpdates);
+      l_speedMax = std::max(l_speedMax, l_speed);
+    }
+
+    delete[] l_netUpdates;
+    l_busy[omp_get_thread_num()] = omp_get_wtime() - l_start;
+  }
+  addBusyTimes(l_busy);
+
+  // the new quantities are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hu[0], m_hu[1]);
+  std::swap(m_hv[0], m_hv[1]);
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::waitForStripe(
+    Stripe const &i_stripe, t_idx i_nSweeps) {
+  while (i_stripe.m_sweeps.load(std::memory_order_acquire) < i_nSweeps) {
+    std::this_thread::yield();
+  }
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::persistentSteps(
+    t_idx i_nSteps, t_compute i_scaling, t_compute i_dxy, t_compute &o_time) {
+  t_idx l_nRows = m_yCells + 2;
+
+  // every stripe has at least one row, thus the neighbours of a stripe own
+  // the rows next to it
+  t_idx l_nThreads = std::min((t_idx)omp_get_max_threads(), l_nRows);
+  std::vector<Stripe> l_stripes(l_nThreads);
+  for (t_idx l_th = 0; l_th < l_nThreads; l_th++) {
+    l_stripes[l_th].m_sweeps.store(0, std::memory_order_relaxed);
+  }
+
+  t_compute l_speedMax = 0;
+  double l_simTimeLast = m_time;
+  t_idx l_nStations = m_stationCells.size();
+  t_idx l_recordSize = 1 + 3 * l_nStations;
+
+#pragma omp parallel num_threads(l_nThreads) reduction(max : l_speedMax)
+  {
+    // every thread derives the same time steps and simulated time
+    t_compute l_time = 0;
+    double l_simTime = m_time;
+    t_idx l_thread = omp_get_thread_num();
+    t_idx l_nStripes = omp_get_num_threads();
+    Stripe &l_stripe = l_stripes[l_thread];
+    Stripe const *l_stripeB = (l_thread > 0) ? &l_stripes[l_thread - 1]
+                                             : nullptr;
+    Stripe const *l_stripeT =
+        (l_thread + 1 < l_nStripes) ? &l_stripes[l_thread + 1] : nullptr;
+
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(l_nRows, l_first, l_last);
+
+    // every thread swaps its own pointers to the buffers
+    t_store *l_h[2] = {m_h[0].data(), m_h[1].data()};
+    t_store *l_hu[2] = {m_hu[0].data(), m_hu[1].data()};
+    t_store *l_hv[2] = {m_hv[0].data(), m_hv[1].data()};
+
+    ghostOutflowRows(l_first, l_last, l_h[0]);
+    ghostOutflowRows(l_first, l_last, l_hu[0]);
+    ghostOutflowRows(l_first, l_last, l_hv[0]);
+
+    // thread-private edge-flux buffers of both sweeps
+    t_compute *l_netUpdates =
+        new t_compute[std::max(4 * (m_xCells + 2),
+                            6 * std::min(m_yStripWidth, m_xCells))];
+
+    for (t_idx l_st = 0; l_st < i_nSteps; l_st++) {
+      // largest stable time step for the fastest wave of the previous step
+      t_compute l_scaling = i_scaling;
+      if (i_dxy > 0) {
+        t_compute l_speedPrev = m_speedMax;
+        if (l_st > 0) {
+#pragma omp barrier
+          l_speedPrev = 0;
+          for (t_idx l_th = 0; l_th < l_nStripes; l_th++) {
+            l_speedPrev =
+                std::max(l_speedPrev, l_stripes[l_th].m_speed[(l_st - 1) % 2]);
+          }
+        }
+        if (l_speedPrev <= 0) l_speedPrev = 1;
+        t_compute l_dt = m_cfl * i_dxy / l_speedPrev;
+        l_scaling = l_dt / i_dxy;
+        l_time += l_dt;
+      }
+      l_simTime += l_scaling * m_dxy;
+
+      // the x-sweep overwrites the rows the neighbours' previous y-sweeps read
+      if (l_stripeB != nullptr) waitForStripe(*l_stripeB, 2 * l_st);
+      if (l_stripeT != nullptr) waitForStripe(*l_stripeT, 2 * l_st);
+
+      t_compute l_speed =
+          xSweepRows(getStride(), m_xCells + 2, l_first, l_last, 0,
+                     m_xCells + 2, l_scaling, l_h[0], l_hu[0], m_b.data(),
+                     m_coding, m_edgeTypeX.data(), m_bathJumpX.data(), l_h[1],
+                     l_hu[1], l_netUpdates);
+      std::swap(l_h[0], l_h[1]);
+      std::swap(l_hu[0], l_hu[1]);
+      l_stripe.m_sweeps.store(2 * l_st + 1, std::memory_order_release);
+
+      // the y-sweep reads the neighbours' rows next to the stripe
+      if (l_stripeB != nullptr) waitForStripe(*l_stripeB, 2 * l_st + 1);
+      if (l_stripeT != nullptr) waitForStripe(*l_stripeT, 2 * l_st + 1);
+
+      for (t_idx l_col = 1; l_col < m_xCells + 1; l_col += m_yStripWidth) {
+        t_idx l_colLast = std::min(l_col + m_yStripWidth, m_xCells + 1);
+        l_speed = std::max(
+            l_speed,
+            ySweepRows(getStride(), l_nRows, l_first, l_last, l_col,
+                       l_colLast, l_scaling, l_h[0], l_hv[0], m_b.data(),
+                       m_coding, m_edgeTypeY.data(), m_bathJumpY.data(),
+                       l_h[1], l_hv[1], l_netUpdates));
+      }
+      for (t_idx l_ceY = l_first; l_ceY < l_last; l_ceY++) {
+        t_idx l_ceL = calculateArrayPosition(0, l_ceY);
+        t_idx l_ceR = calculateArrayPosition(m_xCells + 1, l_ceY);
+
+        l_h[1][l_ceL] = l_h[0][l_ceL];
+        l_hv[1][l_ceL] = l_hv[0][l_ceL];
+        l_h[1][l_ceR] = l_h[0][l_ceR];
+        l_hv[1][l_ceR] = l_hv[0][l_ceR];
+      }
+      if (m_extremes) {
+        extremesRows(l_first, l_last, l_h[1], l_hu[0], l_hv[1], l_simTime);
+      }
+
+      // the records of steps which would be dropped are not sampled, thus
+      // no slot is written by the threads of different steps
+      if (l_nStations > 0 && l_st + m_stationCapacity >= i_nSteps) {
+        t_idx l_slot = (m_stationHead + l_st) % m_stationCapacity;
+        if (l_thread == 0) m_stationRing[l_slot * l_recordSize] = l_simTime;
+        stationsRows(l_first, l_last, l_slot, l_h[1], l_hu[0], l_hv[1]);
+      }
+      std::swap(l_h[0], l_h[1]);
+      std::swap(l_hv[0], l_hv[1]);
+
+      l_stripe.m_speed[l_st % 2] = l_speed;
+      l_stripe.m_sweeps.store(2 * l_st + 2, std::memory_order_release);
+      l_speedMax = l_speed;
+    }
+
+    delete[] l_netUpdates;
+
+#pragma omp master
+    {
+      o_time = l_time;
+      l_simTimeLast = l_simTime;
+    }
+  }
+  m_time = l_simTimeLast;
+  if (l_nStations > 0) advanceStations(i_nSteps);
+
+  // the heights are swapped twice per time step, the momenta once
+  if (i_nSteps % 2 == 1) {
+    std::swap(m_hu[0], m_hu[1]);
+    std::swap(m_hv[0], m_hv[1]);
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::steps(
+    t_compute i_scaling, t_idx i_nSteps, t_idx i_tileSize,
+    t_compute i_speedLimit) {
+  if (m_tiled) {
+    t_compute l_speedMax =
+        tiledSteps(i_scaling, i_nSteps, i_tileSize, i_speedLimit);
+    if (i_speedLimit > 0 && l_speedMax > i_speedLimit) return l_speedMax;
+
+    m_time += i_nSteps * i_scaling * m_dxy;
+    if (m_extremes) extremesAll();
+    if (!m_stationCells.empty()) sampleStations();
+    return l_speedMax;
+  }
+
+  t_compute l_speedMax = 0;
+  for (t_idx l_st = 0; l_st < i_nSteps; l_st++) {
+    m_time += i_scaling * m_dxy;
+
+    // the split schemes have to do the x-sweep first
+    if (m_inPlace) {
+      l_speedMax = xSweepInPlace(i_scaling);
+      l_speedMax = std::max(l_speedMax, ySweepInPlace(i_scaling));
+    } else if (m_unsplit) {
+      l_speedMax = unsplitStep(i_scaling);
+    } else if (m_activity) {
+      if (!m_activityValid) initActivity();
+
+      l_speedMax = sweepActive(i_scaling, true);
+      l_speedMax = std::max(l_speedMax, sweepActive(i_scaling, false));
+
+      growActivity();
+    } else {
+      l_speedMax = xSweep(i_scaling);
+      l_speedMax = std::max(l_speedMax, ySweep(i_scaling));
+    }
+
+    // the y-sweep of the split scheme accumulates the extremes of its rows
+    if (m_extremes && (m_inPlace || m_unsplit || m_activity)) extremesAll();
+    if (!m_stationCells.empty()) sampleStations();
+  }
+  return l_speedMax;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::timeStep(
+    t_real i_scaling, t_idx computeSteps) {
+  // the stripes of the persistent region set their ghost cells themselves
+  if (!usePersistent() || !m_edgesValid) setGhostOutflow();
+  if (!m_edgesValid) initEdges();
+  if (m_balanced && m_nQueues != (t_idx)omp_get_max_threads()) {
+    initBalancing();
+  }
+  m_busyMax = 0;
+  m_busyMean = 0;
+
+  if (usePersistent()) {
+    t_compute l_time = 0;
+    m_speedMax = persistentSteps(computeSteps, i_scaling, 0, l_time);
+    return;
+  }
+
+  // tiles advance by several time steps at once
+  t_idx l_tileSize = 0;
+  t_idx l_depth = 1;
+  if (m_tiled) {
+    deriveTiling(computeSteps, l_tileSize, l_depth);
+  }
+
+  for (t_idx l_st = 0; l_st < computeSteps; l_st += l_depth) {
+    t_idx l_nSteps = std::min(l_depth, computeSteps - l_st);
+    m_speedMax = steps(i_scaling, l_nSteps, l_tileSize);
+  }
+}
+
+template <typename T_precision>
+tsunami_lab::t_real
+tsunami_lab::patches::WavePropagation2d<T_precision>::timeStepAdaptive(
+    t_real i_dxy, t_idx i_computeSteps) {
+  m_dxy = i_dxy;
+  if (!usePersistent() || !m_edgesValid || m_speedMax <= 0) setGhostOutflow();
+  if (!m_edgesValid) initEdges();
+  if (m_balanced && m_nQueues != (t_idx)omp_get_max_threads()) {
+    initBalancing();
+  }
+  m_busyMax = 0;
+  m_busyMean = 0;
+
+  // the first time step has no wave speeds of a previous one
+  if (m_speedMax <= 0) m_speedMax = edgeSpeedMax();
+
+  if (usePersistent()) {
+    t_compute l_time = 0;
+    m_speedMax = persistentSteps(i_computeSteps, 0, i_dxy, l_time);
+    return l_time;
+  }
+
+  t_idx l_tileSize = 0;
+  t_idx l_depth = 1;
+  if (m_tiled) {
+    deriveTiling(i_computeSteps, l_tileSize, l_depth);
+  }
+
+  t_compute l_time = 0;
+  t_idx l_st = 0;
+  while (l_st < i_computeSteps) {
+    t_idx l_nSteps = std::min(l_depth, i_computeSteps - l_st);
+
+    // largest stable time step for the fastest wave of the previous step,
+    // domains without water do not restrict the time step
+    t_compute l_speedMax = (m_speedMax > 0) ? m_speedMax : 1;
+    t_compute l_dt = m_cfl * i_dxy / l_speedMax;
+
+    // the time step of a temporal block is fixed by the speed at its start,
+    // a block in which the waves become too fast for it is discarded and the
+    // remaining steps are taken one by one
+    t_compute l_speedLimit = (l_nSteps > 1) ? i_dxy / l_dt : 0;
+    t_compute l_speed =
+        steps(l_dt / i_dxy, l_nSteps, l_tileSize, l_speedLimit);
+    if (l_speedLimit > 0 && l_speed > l_speedLimit) {
+      l_depth = 1;
+      continue;
+    }
+
+    m_speedMax = l_speed;
+    l_time += l_dt * l_nSteps;
+    l_st += l_nSteps;
+  }
+
+  return l_time;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::edgeSpeedMax() {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+  t_store const *l_h = m_h[0].data();
+  t_store const *l_hu = m_hu[0].data();
+  t_store const *l_hv = m_hv[0].data();
+  t_bath const *l_b = m_b.data();
+  t_compute l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    // the net-updates are discarded
+    t_compute *l_netUpdates = new t_compute[4 * l_nCols];
+
+#pragma omp for schedule(static)
+    for (t_idx l_ceY = 0; l_ceY < l_nRows; l_ceY++) {
+      t_idx l_ce = calculateArrayPosition(0, l_ceY);
+
+      // edges in x-direction
+      t_compute l_speed = netUpdatesRow(
+          l_nCols - 1, l_h + l_ce, l_h + l_ce + 1, l_hu + l_ce,
+          l_hu + l_ce + 1, l_b + l_ce, l_b + l_ce + 1, m_coding,
+          m_edgeTypeX.data() + l_ce, m_bathJumpX.data() + l_ce, l_netUpdates,
+          l_netUpdates + l_nCols, l_netUpdates + 2 * l_nCols,
+          l_netUpdates + 3 * l_nCols);
+      l_speedMax = std::max(l_speedMax, l_speed);
+
+      // edges in y-direction
+      if (l_ceY < l_nRows - 1) {
+        t_idx l_ceT = l_ce + getStride();
+        l_speed = netUpdatesRow(
+            l_nCols, l_h + l_ce, l_h + l_ceT, l_hv + l_ce, l_hv + l_ceT,
+            l_b + l_ce, l_b + l_ceT, m_coding, m_edgeTypeY.data() + l_ce,
+            m_bathJumpY.data() + l_ce, l_netUpdates,
+            l_netUpdates + l_nCols, l_netUpdates + 2 * l_nCols,
+            l_netUpdates + 3 * l_nCols);
+        l_speedMax = std::max(l_speedMax, l_speed);
+      }
+    }
+
+    delete[] l_netUpdates;
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::xSweep(
+    t_compute i_scaling) {
+  t_compute l_speedMax = 0;
+  std::vector<RowQueue> l_queues;
+  initQueues(l_queues);
+  std::vector<double> l_busy(omp_get_max_threads(), 0);
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    double l_start = omp_get_wtime();
+
+    // thread-private edge-flux buffers of a row of edges
+    t_compute *l_netUpdates = new t_compute[4 * (m_xCells + 2)];
+
+    // contiguous blocks of rows (with ghost cells) claimed by this thread
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    t_idx l_visited = 0;
+    while (claimRows(l_queues, l_visited, l_first, l_last)) {
+      t_compute l_speed = xSweepRows(
+          getStride(), m_xCells + 2, l_first, l_last, 0, m_xCells + 2,
+          i_scaling, m_h[0].data(), m_hu[0].data(), m_b.data(), m_coding,
+          m_edgeTypeX.data(), m_bathJumpX.data(), m_h[1].data(),
+          m_hu[1].data(), l_netUpdates);
+      l_speedMax = std::max(l_speedMax, l_speed);
+    }
+
+    delete[] l_netUpdates;
+    l_busy[omp_get_thread_num()] = omp_get_wtime() - l_start;
+  }
+  addBusyTimes(l_busy);
+
+  // the new heights and momenta in x-direction are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hu[0], m_hu[1]);
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::ySweep(
+    t_compute i_scaling) {
+  t_compute l_speedMax = 0;
+  std::vector<RowQueue> l_queues;
+  initQueues(l_queues);
+  std::vector<double> l_busy(omp_get_max_threads(), 0);
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    double l_start = omp_get_wtime();
+
+    // thread-private edge-flux buffers of a strip
+    t_compute *l_netUpdates =
+        new t_compute[6 * std::min(m_yStripWidth, m_xCells)];
+
+    // contiguous blocks of rows (with ghost cells) claimed by this thread,
+    // every cell has exactly one writer
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    t_idx l_visited = 0;
+    while (claimRows(l_queues, l_visited, l_first, l_last)) {
+      // strips of columns keep the rows and the carried edge fluxes of wide
+      // grids in cache
+      for (t_idx l_col = 1; l_col < m_xCells + 1; l_col += m_yStripWidth) {
+        t_idx l_colLast = std::min(l_col + m_yStripWidth, m_xCells + 1);
+
+        t_compute l_speed = ySweepRows(
+            getStride(), m_yCells + 2, l_first, l_last, l_col, l_colLast,
+            i_scaling, m_h[0].data(), m_hv[0].data(), m_b.data(), m_coding,
+            m_edgeTypeY.data(), m_bathJumpY.data(), m_h[1].data(),
+            m_hv[1].data(), l_netUpdates);
+        l_speedMax = std::max(l_speedMax, l_speed);
+      }
+
+      // ghost cells in x-direction are not touched by the y-sweep
+      for (t_idx l_ceY = l_first; l_ceY < l_last; l_ceY++) {
+        t_idx l_ceL = calculateArrayPosition(0, l_ceY);
+        t_idx l_ceR = calculateArrayPosition(m_xCells + 1, l_ceY);
+
+        m_h[1][l_ceL] = m_h[0][l_ceL];
+        m_hv[1][l_ceL] = m_hv[0][l_ceL];
+        m_h[1][l_ceR] = m_h[0][l_ceR];
+        m_hv[1][l_ceR] = m_hv[0][l_ceR];
+      }
 
-  for (t_idx l_computations = 0; l_computations < computeSteps;
-       l_computations++) {
-    // pointers to old and new data
-    t_real *l_hOld = m_h[m_step];
-    t_real *l_huOld = m_hu[m_step];
-    t_real *l_hvOld = m_hv[m_step];
+      // the rows of the block are still in cache
+      if (m_extremes) {
+        extremesRows(l_first, l_last, m_h[1].data(), m_hu[0].data(),
+                     m_hv[1].data(), m_time);
+      }
+    }
+
+    delete[] l_netUpdates;
+    l_busy[omp_get_thread_num()] = omp_get_wtime() - l_start;
+  }
+  addBusyTimes(l_busy);
+
+  // the new heights and momenta in y-direction are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hv[0], m_hv[1]);
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::xSweepInPlace(
+    t_compute i_scaling) {
+  t_compute l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    // thread-private edge-flux buffers of a row of edges
+    t_compute *l_netUpdates = new t_compute[4 * (m_xCells + 2)];
+
+    // the rows only depend on themselves
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(m_yCells + 2, l_first, l_last);
+    l_speedMax = xSweepRows(
+        getStride(), m_xCells + 2, l_first, l_last, 0, m_xCells + 2,
+        i_scaling, m_h[0].data(), m_hu[0].data(), m_b.data(), m_coding,
+        m_edgeTypeX.data(), m_bathJumpX.data(), m_h[0].data(),
+        m_hu[0].data(), l_netUpdates);
+
+    delete[] l_netUpdates;
+  }
+
+  return l_speedMax;
+}
 
-    m_step = (m_step + 1) % 2;
-    t_real *l_hNew = m_h[m_step];
-    t_real *l_huNew = m_hu[m_step];
-    t_real *l_hvNew = m_hv[m_step];
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::ySweepInPlace(
+    t_compute i_scaling) {
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_nCells = m_xCells;
+  t_compute l_speedMax = 0;
 
-// init new cell quantities
-#pragma omp parallel for simd schedule(static, 4)
-    for (unsigned long l_ceY = 0; l_ceY < (m_yCells + 2); l_ceY++) {
-      for (unsigned long l_ceX = 0; l_ceX < (m_xCells + 2); l_ceX++) {
-        unsigned long l_ce = l_ceX + l_ceY * (m_xCells + 2);
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(l_nRows, l_first, l_last);
 
-        l_hNew[l_ce] = l_hOld[l_ce];
-        l_huNew[l_ce] = l_huOld[l_ce];
-        l_hvNew[l_ce] = l_hvOld[l_ce];
+    // thread-private edge-flux buffers and the rolling buffer of the new
+    // heights and momenta of the first and the last row of the block
+    t_compute *l_netUpdates = new t_compute[6 * l_nCells];
+    t_compute *l_netUpdatesHB = l_netUpdates;
+    t_compute *l_netUpdatesHvB = l_netUpdates + l_nCells;
+    t_compute *l_netUpdatesHT = l_netUpdates + 2 * l_nCells;
+    t_compute *l_netUpdatesHvT = l_netUpdates + 3 * l_nCells;
+    t_compute *l_netUpdatesHNext = l_netUpdates + 4 * l_nCells;
+    t_compute *l_netUpdatesHvNext = l_netUpdates + 5 * l_nCells;
+    t_store *l_rows = new t_store[4 * l_nCells];
+
+    t_idx l_border[2] = {l_first, (l_last > 0) ? l_last - 1 : 0};
+    unsigned short l_nBorders = (l_last - l_first > 1) ? 2 : 1;
+    if (l_last == l_first) l_nBorders = 0;
+
+    for (unsigned short l_bo = 0; l_bo < l_nBorders; l_bo++) {
+      t_idx l_ce = calculateArrayPosition(1, l_border[l_bo]);
+      t_idx l_ceB = l_ce - getStride();
+      t_idx l_ceT = l_ce + getStride();
+
+      // edges below and above the row, the outermost rows have one edge
+      for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+        l_netUpdatesHB[l_ed] = 0;
+        l_netUpdatesHvB[l_ed] = 0;
+        l_netUpdatesHT[l_ed] = 0;
+        l_netUpdatesHvT[l_ed] = 0;
+      }
+      if (l_border[l_bo] > 0) {
+        t_compute l_speed = netUpdatesRow(
+            l_nCells, m_h[0].data() + l_ceB, m_h[0].data() + l_ce,
+            m_hv[0].data() + l_ceB, m_hv[0].data() + l_ce, m_b.data() + l_ceB,
+            m_b.data() + l_ce, m_coding, m_edgeTypeY.data() + l_ceB,
+            m_bathJumpY.data() + l_ceB, l_netUpdatesHNext, l_netUpdatesHvNext,
+            l_netUpdatesHB, l_netUpdatesHvB);
+        l_speedMax = std::max(l_speedMax, l_speed);
+      }
+      if (l_border[l_bo] < l_nRows - 1) {
+        t_compute l_speed = netUpdatesRow(
+            l_nCells, m_h[0].data() + l_ce, m_h[0].data() + l_ceT,
+            m_hv[0].data() + l_ce, m_hv[0].data() + l_ceT, m_b.data() + l_ce,
+            m_b.data() + l_ceT, m_coding, m_edgeTypeY.data() + l_ce,
+            m_bathJumpY.data() + l_ce, l_netUpdatesHT, l_netUpdatesHvT,
+            l_netUpdatesHNext, l_netUpdatesHvNext);
+        l_speedMax = std::max(l_speedMax, l_speed);
+      }
+
+      // same arithmetic as the sweep of the inner rows
+      t_store *l_h = l_rows + 2 * l_bo * l_nCells;
+      t_store *l_hv = l_h + l_nCells;
+#pragma omp simd
+      for (t_idx l_ed = 0; l_ed < l_nCells; l_ed++) {
+        l_h[l_ed] = m_h[0][l_ce + l_ed] - i_scaling * l_netUpdatesHB[l_ed] -
+                    i_scaling * l_netUpdatesHT[l_ed];
+        l_hv[l_ed] = m_hv[0][l_ce + l_ed] -
+                     i_scaling * l_netUpdatesHvB[l_ed] -
+                     i_scaling * l_netUpdatesHvT[l_ed];
       }
     }
 
-// iterate over all collums in x direction with ghost cells
-#pragma omp parallel for simd schedule(static, 4)
-    for (t_idx l_ceY = 0; l_ceY < (m_yCells + 2); l_ceY++) {
-      // iterate over edges in x direction and update with Riemann solutions
-      for (t_idx l_ceX = 0; l_ceX < (m_xCells + 1); l_ceX++) {
-        // determine left and right cell-id
-        t_idx l_ceL = calculateArrayPosition(l_ceX, l_ceY);
-        t_idx l_ceR = calculateArrayPosition(l_ceX + 1, l_ceY);
+    // the neighbours have read the borders of the block
+#pragma omp barrier
+
+    // the inner rows read the unchanged borders
+    if (l_last - l_first > 2) {
+      for (t_idx l_col = 1; l_col < m_xCells + 1; l_col += m_yStripWidth) {
+        t_idx l_colLast = std::min(l_col + m_yStripWidth, m_xCells + 1);
+
+        t_compute l_speed = ySweepRows(
+            getStride(), l_nRows, l_first + 1, l_last - 1, l_col, l_colLast,
+            i_scaling, m_h[0].data(), m_hv[0].data(), m_b.data(), m_coding,
+            m_edgeTypeY.data(), m_bathJumpY.data(), m_h[0].data(),
+            m_hv[0].data(), l_netUpdates);
+        l_speedMax = std::max(l_speedMax, l_speed);
+      }
+    }
+
+    for (unsigned short l_bo = 0; l_bo < l_nBorders; l_bo++) {
+      t_idx l_ce = calculateArrayPosition(1, l_border[l_bo]);
+      std::copy(l_rows + 2 * l_bo * l_nCells,
+                l_rows + (2 * l_bo + 1) * l_nCells, m_h[0].data() + l_ce);
+      std::copy(l_rows + (2 * l_bo + 1) * l_nCells,
+                l_rows + (2 * l_bo + 2) * l_nCells, m_hv[0].data() + l_ce);
+    }
+
+    delete[] l_netUpdates;
+    delete[] l_rows;
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::extremesRows(
+    t_idx i_rowFirst, t_idx i_rowLast, t_store const *i_h, t_store const *i_hu,
+    t_store const *i_hv, double i_time) {
+  // the ghost cells are not accumulated
+  t_idx l_first = std::max(i_rowFirst, t_idx(1));
+  t_idx l_last = std::min(i_rowLast, m_yCells + 1);
+  t_real l_time = i_time;
+  t_bath const *l_b = m_b.data();
+  t_real *l_ampMax = m_extremesGrid[0].data();
+  t_real *l_velMax = m_extremesGrid[1].data();
+  t_real *l_arrival = m_extremesGrid[2].data();
+
+  for (t_idx l_ceY = l_first; l_ceY < l_last; l_ceY++) {
+    t_idx l_row = calculateArrayPosition(0, l_ceY);
+
+    // branch-free, dry cells have neither an amplitude nor a velocity
+#pragma omp simd
+    for (t_idx l_ceX = l_row + 1; l_ceX < l_row + m_xCells + 1; l_ceX++) {
+      t_compute l_h = m_coding.decodeHeight(i_h[l_ceX], l_b[l_ceX]);
+      t_compute l_hu = i_hu[l_ceX];
+      t_compute l_hv = i_hv[l_ceX];
+      bool l_wet = l_h >= m_wetHeight;
+
+      t_compute l_eta = l_h + m_coding.decodeBathymetry(l_b[l_ceX]);
+      t_real l_amp = l_wet ? std::abs(l_eta) : 0;
+      t_real l_vel =
+          l_wet ? std::sqrt(l_hu * l_hu + l_hv * l_hv) / l_h : t_compute(0);
+
+      l_ampMax[l_ceX] = std::max(l_ampMax[l_ceX], l_amp);
+      l_velMax[l_ceX] = std::max(l_velMax[l_ceX], l_vel);
+      bool l_arrived = l_arrival[l_ceX] < 0 && l_amp >= m_arrivalThreshold;
+      l_arrival[l_ceX] = l_arrived ? l_time : l_arrival[l_ceX];
+    }
+  }
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::extremesAll() {
+#pragma omp parallel
+  {
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(m_yCells + 2, l_first, l_last);
+    extremesRows(l_first, l_last, m_h[0].data(), m_hu[0].data(),
+                 m_hv[0].data(), m_time);
+  }
+}
+
+template <typename T_precision>
+bool tsunami_lab::patches::WavePropagation2d<T_precision>::setExtremes(
+    bool i_enabled, t_real i_threshold, t_real i_dxy) {
+  m_extremes = i_enabled;
+  m_arrivalThreshold = i_threshold;
+  m_dxy = i_dxy;
+
+  for (unsigned short l_ex = 0; l_ex < 3; l_ex++) {
+    m_extremesGrid[l_ex] =
+        i_enabled ? Grid2d<t_real>(m_xCells, m_yCells, 1, getStride(), false)
+                  : Grid2d<t_real>();
+  }
+  if (!m_extremes) return true;
+
+  // first touch by the threads owning the rows
+#pragma omp parallel
+  {
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(m_yCells + 2, l_first, l_last);
+    m_extremesGrid[0].fillRows(l_first, l_last, 0);
+    m_extremesGrid[1].fillRows(l_first, l_last, 0);
+    m_extremesGrid[2].fillRows(l_first, l_last, -1);
+  }
+  return true;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::stationsRows(
+    t_idx i_rowFirst, t_idx i_rowLast, t_idx i_slot, t_store const *i_h,
+    t_store const *i_hu, t_store const *i_hv) {
+  t_idx l_nStations = m_stationCells.size();
+  t_real *l_record = m_stationRing.data() + i_slot * (1 + 3 * l_nStations);
+  t_idx l_ceFirst = calculateArrayPosition(0, i_rowFirst);
+  t_idx l_ceLast = calculateArrayPosition(0, i_rowLast);
+
+  for (t_idx l_st = 0; l_st < l_nStations; l_st++) {
+    t_idx l_ce = m_stationCells[l_st];
+    if (l_ce < l_ceFirst || l_ce >= l_ceLast) continue;
+
+    l_record[1 + l_st] = m_coding.decodeHeight(i_h[l_ce], m_b[l_ce]);
+    l_record[1 + l_nStations + l_st] = t_compute(i_hu[l_ce]);
+    l_record[1 + 2 * l_nStations + l_st] = t_compute(i_hv[l_ce]);
+  }
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::sampleStations() {
+  t_idx l_slot = m_stationHead;
+  m_stationRing[l_slot * (1 + 3 * m_stationCells.size())] = m_time;
+  stationsRows(0, m_yCells + 2, l_slot, m_h[0].data(), m_hu[0].data(),
+               m_hv[0].data());
+  advanceStations(1);
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::advanceStations(
+    t_idx i_nRecords) {
+  m_stationHead = (m_stationHead + i_nRecords) % m_stationCapacity;
+  m_stationCount += i_nRecords;
+  if (m_stationCount > m_stationCapacity) {
+    m_stationDropped += m_stationCount - m_stationCapacity;
+    m_stationCount = m_stationCapacity;
+  }
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::setStations(
+    t_idx i_nStations, t_idx const *i_ix, t_idx const *i_iy,
+    t_idx i_capacity) {
+  m_stationCells.resize(i_nStations);
+  for (t_idx l_st = 0; l_st < i_nStations; l_st++) {
+    m_stationCells[l_st] = calculateArrayPosition(i_ix[l_st] + 1,
+                                                  i_iy[l_st] + 1);
+  }
+
+  m_stationCapacity = std::max(i_capacity, t_idx(1));
+  m_stationRing.assign(m_stationCapacity * (1 + 3 * i_nStations), 0);
+  m_stationHead = 0;
+  m_stationCount = 0;
+  m_stationDropped = 0;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::getStationRecords(
+    std::vector<t_real> &io_records) {
+  t_idx l_recordSize = 1 + 3 * m_stationCells.size();
+  t_idx l_first = (m_stationHead + m_stationCapacity - m_stationCount) %
+                  m_stationCapacity;
+
+  // oldest record first
+  for (t_idx l_re = 0; l_re < m_stationCount; l_re++) {
+    t_idx l_slot = (l_first + l_re) % m_stationCapacity;
+    io_records.insert(io_records.end(),
+                      m_stationRing.begin() + l_slot * l_recordSize,
+                      m_stationRing.begin() + (l_slot + 1) * l_recordSize);
+  }
+  m_stationCount = 0;
+}
+
+template <typename T_precision>
+bool tsunami_lab::patches::WavePropagation2d<T_precision>::setActivityTracking(
+    bool i_enabled, t_idx i_tileSize, t_real i_tolerance) {
+  if (i_enabled &&
+      (m_inPlace || m_unsplit || m_persistent || m_tiled || m_balanced)) {
+    return false;
+  }
+  m_activity = i_enabled;
+  m_activityValid = false;
+  m_activityTileSize = i_tileSize;
+  m_activityTol = i_tolerance;
+
+  m_tileActive.clear();
+  m_tileActiveNext.clear();
+  if (m_activity) {
+    m_nActTilesX = (m_xCells + 2 + i_tileSize - 1) / i_tileSize;
+    m_nActTilesY = (m_yCells + 2 + i_tileSize - 1) / i_tileSize;
+    m_tileActive.resize(m_nActTilesX * m_nActTilesY);
+    m_tileActiveNext.resize(m_nActTilesX * m_nActTilesY);
+  }
+  return true;
+}
+
+template <typename T_precision>
+tsunami_lab::t_real
+tsunami_lab::patches::WavePropagation2d<T_precision>::getActiveFraction()
+    const {
+  if (!m_activity || !m_activityValid) return 1;
+
+  t_idx l_nActive = 0;
+  for (t_idx l_ti = 0; l_ti < m_nActTilesX * m_nActTilesY; l_ti++) {
+    l_nActive += m_tileActive[l_ti];
+  }
+  return l_nActive / t_real(m_nActTilesX * m_nActTilesY);
+}
+
+template <typename T_precision>
+bool tsunami_lab::patches::WavePropagation2d<T_precision>::edgeAtRest(
+    t_idx i_ceL, t_idx i_ceR) const {
+  t_store const *l_h = m_h[0].data();
+  t_store const *l_hu = m_hu[0].data();
+  t_store const *l_hv = m_hv[0].data();
 
-        // compute net-updates
-        t_real l_netUpdates[2][2];
+  t_compute l_bL = m_coding.decodeBathymetry(m_b[i_ceL]);
+  t_compute l_bR = m_coding.decodeBathymetry(m_b[i_ceR]);
+  bool l_dryL = l_bL >= 0;
+  bool l_dryR = l_bR >= 0;
+  if (l_dryL && l_dryR) return true;
 
-        solvers::fwave::netUpdates(l_hOld[l_ceL], l_hOld[l_ceR], l_huOld[l_ceL],
-                                   l_huOld[l_ceR], m_b[l_ceL], m_b[l_ceR],
-                                   l_netUpdates[0], l_netUpdates[1]);
+  // wet cells without momentum
+  if (!l_dryL && (std::abs(l_hu[i_ceL]) > m_activityTol ||
+                  std::abs(l_hv[i_ceL]) > m_activityTol)) {
+    return false;
+  }
+  if (!l_dryR && (std::abs(l_hu[i_ceR]) > m_activityTol ||
+                  std::abs(l_hv[i_ceR]) > m_activityTol)) {
+    return false;
+  }
+
+  // a dry side reflects the wet one, otherwise the sea surface is flat
+  if (l_dryL || l_dryR) return true;
+  t_compute l_surfaceL = m_coding.decodeHeight(l_h[i_ceL], m_b[i_ceL]) + l_bL;
+  t_compute l_surfaceR = m_coding.decodeHeight(l_h[i_ceR], m_b[i_ceR]) + l_bR;
+  return std::abs(l_surfaceL - l_surfaceR) <= m_activityTol;
+}
 
-        // update the cells' quantities
-        l_hNew[l_ceL] -= i_scaling * l_netUpdates[0][0];
-        l_huNew[l_ceL] -= i_scaling * l_netUpdates[0][1];
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::initActivity() {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_size = m_activityTileSize;
 
-        l_hNew[l_ceR] -= i_scaling * l_netUpdates[1][0];
-        l_huNew[l_ceR] -= i_scaling * l_netUpdates[1][1];
+#pragma omp parallel for schedule(dynamic)
+  for (t_idx l_ti = 0; l_ti < m_nActTilesX * m_nActTilesY; l_ti++) {
+    t_idx l_x0 = (l_ti % m_nActTilesX) * l_size;
+    t_idx l_y0 = (l_ti / m_nActTilesX) * l_size;
+    t_idx l_x1 = std::min(l_x0 + l_size, l_nCols);
+    t_idx l_y1 = std::min(l_y0 + l_size, l_nRows);
+
+    // a tile is active if any edge of its cells is disturbed
+    bool l_active = false;
+    for (t_idx l_ceY = l_y0; l_ceY < l_y1 && !l_active; l_ceY++) {
+      for (t_idx l_ceX = l_x0; l_ceX < l_x1 && !l_active; l_ceX++) {
+        t_idx l_ce = calculateArrayPosition(l_ceX, l_ceY);
+        if (l_ceX + 1 < l_nCols) l_active = !edgeAtRest(l_ce, l_ce + 1);
+        if (l_ceY + 1 < l_nRows && !l_active) {
+          l_active = !edgeAtRest(l_ce, l_ce + getStride());
+        }
       }
     }
+    m_tileActive[l_ti] = l_active;
 
-// init new cell quantities
-#pragma omp parallel for simd schedule(static, 4)
-    for (unsigned long l_ceY = 0; l_ceY < (m_yCells + 2); l_ceY++) {
-      for (unsigned long l_ceX = 0; l_ceX < (m_xCells + 2); l_ceX++) {
-        unsigned long l_ce = l_ceX + l_ceY * (m_xCells + 2);
-        l_hOld[l_ce] = l_hNew[l_ce];
-        l_huOld[l_ce] = l_huNew[l_ce];
-        l_hvOld[l_ce] = l_hvNew[l_ce];
+    // quiescent cells are not written by the sweeps, thus both buffers have
+    // to hold their values
+    for (t_idx l_ceY = l_y0; l_ceY < l_y1; l_ceY++) {
+      for (t_idx l_ceX = l_x0; l_ceX < l_x1; l_ceX++) {
+        t_idx l_ce = calculateArrayPosition(l_ceX, l_ceY);
+        m_h[1][l_ce] = m_h[0][l_ce];
+        m_hu[1][l_ce] = m_hu[0][l_ce];
+        m_hv[1][l_ce] = m_hv[0][l_ce];
       }
     }
+  }
 
-// iterate over edges in y direction and update with Riemann solutions
-#pragma omp parallel for simd schedule(static, 4)
-    for (t_idx l_ceY = 0; l_ceY < (m_yCells + 1); l_ceY++) {
-      // iterate over all rows in y direction without ghost cells
-      for (t_idx l_ceX = 1; l_ceX < (m_xCells + 1); l_ceX++) {
-        // determine left and right cell-id
-        t_idx l_ceB = calculateArrayPosition(l_ceX, l_ceY);
-        t_idx l_ceT = calculateArrayPosition(l_ceX, l_ceY + 1);
+  m_activityValid = true;
+}
 
-        // compute net-updates
-        t_real l_netUpdates[2][2];
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::growActivity() {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_size = m_activityTileSize;
+  t_idx l_nTiles = m_nActTilesX * m_nActTilesY;
 
-        solvers::fwave::netUpdates(l_hOld[l_ceB], l_hOld[l_ceT], l_hvOld[l_ceB],
-                                   l_hvOld[l_ceT], m_b[l_ceB], m_b[l_ceT],
-                                   l_netUpdates[0], l_netUpdates[1]);
+  // a disturbance travels at most one cell per sweep, bands of two cells
+  // along the borders of the active tiles activate the neighbours before it
+  // leaves the tile
+  t_idx l_band = std::min(l_size, (t_idx)2);
+  unsigned char *l_next = m_tileActiveNext.data();
 
-        // update the cells' quantities
-        l_hNew[l_ceB] -= i_scaling * l_netUpdates[0][0];
-        l_hvNew[l_ceB] -= i_scaling * l_netUpdates[0][1];
+#pragma omp parallel
+  {
+#pragma omp for schedule(static)
+    for (t_idx l_ti = 0; l_ti < l_nTiles; l_ti++) {
+      l_next[l_ti] = m_tileActive[l_ti];
+    }
+
+#pragma omp for schedule(dynamic)
+    for (t_idx l_ti = 0; l_ti < l_nTiles; l_ti++) {
+      if (!m_tileActive[l_ti]) continue;
+
+      t_idx l_tx = l_ti % m_nActTilesX;
+      t_idx l_ty = l_ti / m_nActTilesX;
+      t_idx l_x0 = l_tx * l_size;
+      t_idx l_y0 = l_ty * l_size;
+      t_idx l_x1 = std::min(l_x0 + l_size, l_nCols);
+      t_idx l_y1 = std::min(l_y0 + l_size, l_nRows);
+
+      // left and right neighbours, the band is compared to the first cell of
+      // the neighbour in each row
+      for (int l_side = 0; l_side < 2; l_side++) {
+        if (l_side == 0 && l_tx == 0) continue;
+        if (l_side == 1 && l_tx == m_nActTilesX - 1) continue;
+        t_idx l_tn = (l_side == 0) ? l_ti - 1 : l_ti + 1;
+        if (m_tileActive[l_tn]) continue;
+
+        bool l_active = false;
+        for (t_idx l_ceY = l_y0; l_ceY < l_y1 && !l_active; l_ceY++) {
+          t_idx l_ceN = (l_side == 0) ? calculateArrayPosition(l_x0 - 1, l_ceY)
+                                      : calculateArrayPosition(l_x1, l_ceY);
+          for (t_idx l_bd = 0; l_bd < l_band && !l_active; l_bd++) {
+            t_idx l_ce = (l_side == 0) ? l_ceN + 1 + l_bd : l_ceN - 1 - l_bd;
+            l_active = !edgeAtRest(l_ce, l_ceN);
+          }
+        }
+        if (l_active) {
+#pragma omp atomic write
+          l_next[l_tn] = 1;
+        }
+      }
+
+      // bottom and top neighbours
+      for (int l_side = 0; l_side < 2; l_side++) {
+        if (l_side == 0 && l_ty == 0) continue;
+        if (l_side == 1 && l_ty == m_nActTilesY - 1) continue;
+        t_idx l_tn = (l_side == 0) ? l_ti - m_nActTilesX : l_ti + m_nActTilesX;
+        if (m_tileActive[l_tn]) continue;
 
-        l_hNew[l_ceT] -= i_scaling * l_netUpdates[1][0];
-        l_hvNew[l_ceT] -= i_scaling * l_netUpdates[1][1];
+        bool l_active = false;
+        for (t_idx l_ceX = l_x0; l_ceX < l_x1 && !l_active; l_ceX++) {
+          t_idx l_ceN = (l_side == 0) ? calculateArrayPosition(l_ceX, l_y0 - 1)
+                                      : calculateArrayPosition(l_ceX, l_y1);
+          for (t_idx l_bd = 0; l_bd < l_band && !l_active; l_bd++) {
+            t_idx l_ce = (l_side == 0) ? l_ceN + (1 + l_bd) * getStride()
+                                       : l_ceN - (1 + l_bd) * getStride();
+            l_active = !edgeAtRest(l_ce, l_ceN);
+          }
+        }
+        if (l_active) {
+#pragma omp atomic write
+          l_next[l_tn] = 1;
+        }
       }
     }
   }
+
+  m_tileActive.swap(m_tileActiveNext);
 }
 
-void tsunami_lab::patches::WavePropagation2d::setGhostOutflow() {
-  t_real *l_h = m_h[m_step];
-  t_real *l_hu = m_hu[m_step];
-  t_real *l_hv = m_hv[m_step];
-  t_idx l_displacementFrom;
-  t_idx l_displacementTo;
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::sweepActive(
+    t_compute i_scaling, bool i_xSweep) {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+  t_idx l_size = m_activityTileSize;
+
+  // momenta and edges of the sweep's direction
+  Grid2d<t_store> *l_q = i_xSweep ? m_hu : m_hv;
+  unsigned char const *l_edgeType =
+      i_xSweep ? m_edgeTypeX.data() : m_edgeTypeY.data();
+  t_jump const *l_bathJump =
+      i_xSweep ? m_bathJumpX.data() : m_bathJumpY.data();
+
+  t_compute l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    // thread-private edge-flux buffers
+    t_compute *l_netUpdates = new t_compute[6 * l_nCols];
+
+    // every band of tile rows is handled by a single thread
+#pragma omp for schedule(dynamic)
+    for (t_idx l_ty = 0; l_ty < m_nActTilesY; l_ty++) {
+      t_idx l_rowFirst = l_ty * l_size;
+      t_idx l_rowLast = std::min(l_rowFirst + l_size, l_nRows);
+      unsigned char const *l_active = m_tileActive.data() + l_ty * m_nActTilesX;
+
+      // runs of neighbouring active tiles are swept at once
+      t_idx l_tx = 0;
+      while (l_tx < m_nActTilesX) {
+        if (!l_active[l_tx]) {
+          l_tx++;
+          continue;
+        }
+        t_idx l_txEnd = l_tx;
+        while (l_txEnd < m_nActTilesX && l_active[l_txEnd]) l_txEnd++;
+
+        t_idx l_colFirst = l_tx * l_size;
+        t_idx l_colLast = std::min(l_txEnd * l_size, l_nCols);
+        t_compute l_speed = 0;
 
-  // set ghost outflow for all outer cells
-  // displacement = (m_xCells+2)*(m_yCells + 1);
-  for (unsigned short l_ce = 1; l_ce <= (m_xCells); l_ce++) {
-    l_displacementFrom = calculateArrayPosition(l_ce, 1);
-    l_displacementTo = calculateArrayPosition(l_ce, 0);
-    l_h[l_displacementTo] = l_h[l_displacementFrom];
-    l_hu[l_displacementTo] = l_hu[l_displacementFrom];
-    l_hv[l_displacementTo] = l_hv[l_displacementFrom];
-    m_b[l_displacementTo] = m_b[l_displacementFrom];
+        if (i_xSweep) {
+          l_speed = xSweepRows(getStride(), l_nCols, l_rowFirst, l_rowLast,
+                               l_colFirst, l_colLast, i_scaling, m_h[0].data(),
+                               l_q[0].data(), m_b.data(), m_coding, l_edgeType,
+                               l_bathJump, m_h[1].data(), l_q[1].data(),
+                               l_netUpdates);
+        } else {
+          // ghost cells in x-direction are not touched by the y-sweep
+          l_speed = ySweepRows(getStride(), l_nRows, l_rowFirst, l_rowLast,
+                               std::max(l_colFirst, (t_idx)1),
+                               std::min(l_colLast, l_nCols - 1), i_scaling,
+                               m_h[0].data(), l_q[0].data(), m_b.data(),
+                               m_coding, l_edgeType, l_bathJump,
+                               m_h[1].data(), l_q[1].data(), l_netUpdates);
 
-    l_displacementFrom = calculateArrayPosition(l_ce, m_yCells);
-    l_displacementTo = calculateArrayPosition(l_ce, m_yCells + 1);
-    l_h[l_displacementTo] = l_h[l_displacementFrom];
-    l_hu[l_displacementTo] = l_hu[l_displacementFrom];
-    l_hv[l_displacementTo] = l_hv[l_displacementFrom];
-    m_b[l_displacementTo] = m_b[l_displacementFrom];
+          for (t_idx l_ceY = l_rowFirst; l_ceY < l_rowLast; l_ceY++) {
+            t_idx l_ceL = calculateArrayPosition(0, l_ceY);
+            t_idx l_ceR = calculateArrayPosition(l_nCols - 1, l_ceY);
+            if (l_colFirst == 0) {
+              m_h[1][l_ceL] = m_h[0][l_ceL];
+              l_q[1][l_ceL] = l_q[0][l_ceL];
+            }
+            if (l_colLast == l_nCols) {
+              m_h[1][l_ceR] = m_h[0][l_ceR];
+              l_q[1][l_ceR] = l_q[0][l_ceR];
+            }
+          }
+        }
+        l_speedMax = std::max(l_speedMax, l_speed);
+
+        l_tx = l_txEnd;
+      }
+    }
+
+    delete[] l_netUpdates;
   }
 
-  for (unsigned short l_ce = 0; l_ce <= (m_yCells + 1); l_ce++) {
-    l_displacementFrom = calculateArrayPosition(1, l_ce);
-    l_displacementTo = calculateArrayPosition(0, l_ce);
-    l_h[l_displacementTo] = l_h[l_displacementFrom];
-    l_hu[l_displacementTo] = l_hu[l_displacementFrom];
-    l_hv[l_displacementTo] = l_hv[l_displacementFrom];
-    m_b[l_displacementTo] = m_b[l_displacementFrom];
+  // the new quantities are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(l_q[0], l_q[1]);
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::deriveTiling(
+    t_idx i_computeSteps, t_idx &o_tileSize, t_idx &o_depth) const {
+  o_tileSize = m_tileSize;
+  o_depth = m_tileDepth;
+
+  // size the tiles such that the two time steps of a tile's quantities and
+  // its edges fit into three quarters of the L2 cache
+  if (o_tileSize == 0) {
+    long l_cacheSize = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l_cacheSize <= 0) l_cacheSize = 1024 * 1024;
+
+    t_idx l_patchSize =
+        std::sqrt((3 * l_cacheSize / 4) / (8 * sizeof(t_store) + 2));
+    t_idx l_depth = (o_depth == 0) ? std::max(l_patchSize / 16, (t_idx)1)
+                                   : o_depth;
+    o_tileSize = (l_patchSize > 2 * l_depth + 16) ? l_patchSize - 2 * l_depth
+                                                  : 16;
+  }
+
+  // keep the redundant work in the halos moderate
+  if (o_depth == 0) o_depth = std::max(o_tileSize / 8, (t_idx)1);
+
+  o_depth = std::min(o_depth, i_computeSteps);
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::tiledSteps(
+    t_compute i_scaling, t_idx i_nSteps, t_idx i_tileSize,
+    t_compute i_speedLimit) {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_nRows = m_yCells + 2;
+
+  t_idx l_nTilesX = (l_nCols + i_tileSize - 1) / i_tileSize;
+  t_idx l_nTilesY = (l_nRows + i_tileSize - 1) / i_tileSize;
+
+  t_compute l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    // thread-private quantities of a tile including a halo of i_nSteps
+    // cells on each side
+    t_idx l_patchSize = i_tileSize + 2 * i_nSteps;
+    t_idx l_patchCells = l_patchSize * l_patchSize;
+    t_store *l_patch = new t_store[6 * l_patchCells];
+    t_store *l_h[2] = {l_patch, l_patch + l_patchCells};
+    t_store *l_hu[2] = {l_patch + 2 * l_patchCells,
+                        l_patch + 3 * l_patchCells};
+    t_store *l_hv[2] = {l_patch + 4 * l_patchCells,
+                        l_patch + 5 * l_patchCells};
+    t_jump *l_bathJumps = new t_jump[2 * l_patchCells];
+    t_jump *l_bathJumpX = l_bathJumps;
+    t_jump *l_bathJumpY = l_bathJumps + l_patchCells;
+    t_bath *l_b = new t_bath[l_patchCells];
+    t_compute *l_netUpdates = new t_compute[6 * l_patchSize];
+    unsigned char *l_edgeTypes = new unsigned char[2 * l_patchCells];
+    unsigned char *l_edgeTypeX = l_edgeTypes;
+    unsigned char *l_edgeTypeY = l_edgeTypes + l_patchCells;
+
+#pragma omp for schedule(dynamic)
+    for (t_idx l_ti = 0; l_ti < l_nTilesX * l_nTilesY; l_ti++) {
+      // tile in global cells
+      t_idx l_x0 = (l_ti % l_nTilesX) * i_tileSize;
+      t_idx l_y0 = (l_ti / l_nTilesX) * i_tileSize;
+      t_idx l_x1 = std::min(l_x0 + i_tileSize, l_nCols);
+      t_idx l_y1 = std::min(l_y0 + i_tileSize, l_nRows);
+
+      // patch of the tile and its halo in global cells
+      t_idx l_px0 = (l_x0 > i_nSteps) ? l_x0 - i_nSteps : 0;
+      t_idx l_py0 = (l_y0 > i_nSteps) ? l_y0 - i_nSteps : 0;
+      t_idx l_px1 = std::min(l_x1 + i_nSteps, l_nCols);
+      t_idx l_py1 = std::min(l_y1 + i_nSteps, l_nRows);
+      t_idx l_nx = l_px1 - l_px0;
+      t_idx l_ny = l_py1 - l_py0;
+
+      // halos at the boundary of the domain are not required
+      bool l_haloL = l_px0 > 0;
+      bool l_haloR = l_px1 < l_nCols;
+      bool l_haloB = l_py0 > 0;
+      bool l_haloT = l_py1 < l_nRows;
+
+      for (t_idx l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        t_idx l_ce = l_ceY * l_nx;
+        t_idx l_ceGlobal = calculateArrayPosition(l_px0, l_py0 + l_ceY);
+        for (t_idx l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          l_h[0][l_ce + l_ceX] = m_h[0][l_ceGlobal + l_ceX];
+          l_hu[0][l_ce + l_ceX] = m_hu[0][l_ceGlobal + l_ceX];
+          l_hv[0][l_ce + l_ceX] = m_hv[0][l_ceGlobal + l_ceX];
+          l_edgeTypeX[l_ce + l_ceX] = m_edgeTypeX[l_ceGlobal + l_ceX];
+          l_edgeTypeY[l_ce + l_ceX] = m_edgeTypeY[l_ceGlobal + l_ceX];
+          l_bathJumpX[l_ce + l_ceX] = m_bathJumpX[l_ceGlobal + l_ceX];
+          l_bathJumpY[l_ce + l_ceX] = m_bathJumpY[l_ceGlobal + l_ceX];
+          if (T_precision::m_relative) {
+            l_b[l_ce + l_ceX] = m_b[l_ceGlobal + l_ceX];
+          }
+        }
+      }
+
+      // advance the patch, the cells with a distance of less than l_st to
+      // a halo's border are invalid after step l_st and are skipped
+      for (t_idx l_st = 1; l_st <= i_nSteps; l_st++) {
+        t_idx l_colFirst = l_haloL ? l_st : 0;
+        t_idx l_colLast = l_haloR ? l_nx - l_st : l_nx;
+
+        // the y-sweep needs the x-sweep's rows next to its rows
+        t_compute l_speed = xSweepRows(
+            l_nx, l_nx, l_haloB ? l_st - 1 : 0,
+            l_haloT ? l_ny - l_st + 1 : l_ny, l_colFirst, l_colLast,
+            i_scaling, l_h[0], l_hu[0], l_b, m_coding, l_edgeTypeX,
+            l_bathJumpX, l_h[1], l_hu[1], l_netUpdates);
+        l_speedMax = std::max(l_speedMax, l_speed);
+        std::swap(l_h[0], l_h[1]);
+        std::swap(l_hu[0], l_hu[1]);
+
+        // ghost cells in x-direction are not touched by the y-sweep
+        t_idx l_rowFirst = l_haloB ? l_st : 0;
+        t_idx l_rowLast = l_haloT ? l_ny - l_st : l_ny;
+        t_idx l_colFirstY = l_haloL ? l_colFirst : 1;
+        t_idx l_colLastY = l_haloR ? l_colLast : l_nx - 1;
+
+        l_speed = ySweepRows(l_nx, l_ny, l_rowFirst, l_rowLast, l_colFirstY,
+                             l_colLastY, i_scaling, l_h[0], l_hv[0], l_b,
+                             m_coding, l_edgeTypeY, l_bathJumpY, l_h[1],
+                             l_hv[1], l_netUpdates);
+        l_speedMax = std::max(l_speedMax, l_speed);
+
+        for (t_idx l_ceY = l_rowFirst; l_ceY < l_rowLast; l_ceY++) {
+          t_idx l_ce = l_ceY * l_nx;
+          if (!l_haloL) {
+            l_h[1][l_ce] = l_h[0][l_ce];
+            l_hv[1][l_ce] = l_hv[0][l_ce];
+          }
+          if (!l_haloR) {
+            l_h[1][l_ce + l_nx - 1] = l_h[0][l_ce + l_nx - 1];
+            l_hv[1][l_ce + l_nx - 1] = l_hv[0][l_ce + l_nx - 1];
+          }
+        }
+        std::swap(l_h[0], l_h[1]);
+        std::swap(l_hv[0], l_hv[1]);
+      }
+
+      // write the tile back
+      for (t_idx l_ceY = l_y0; l_ceY < l_y1; l_ceY++) {
+        t_idx l_ce = (l_ceY - l_py0) * l_nx - l_px0;
+        t_idx l_ceGlobal = calculateArrayPosition(0, l_ceY);
+        for (t_idx l_ceX = l_x0; l_ceX < l_x1; l_ceX++) {
+          m_h[1][l_ceGlobal + l_ceX] = l_h[0][l_ce + l_ceX];
+          m_hu[1][l_ceGlobal + l_ceX] = l_hu[0][l_ce + l_ceX];
+          m_hv[1][l_ceGlobal + l_ceX] = l_hv[0][l_ce + l_ceX];
+        }
+      }
+    }
+
+    delete[] l_patch;
+    delete[] l_bathJumps;
+    delete[] l_b;
+    delete[] l_netUpdates;
+    delete[] l_edgeTypes;
+  }
+
+  // the time step was too large for the waves, the old quantities are kept
+  if (i_speedLimit > 0 && l_speedMax > i_speedLimit) return l_speedMax;
+
+  // the new quantities are the current ones now
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hu[0], m_hu[1]);
+  std::swap(m_hv[0], m_hv[1]);
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+template <typename T>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::ghostOutflowRows(
+    t_idx i_rowFirst, t_idx i_rowLast, T *io_q) {
+  t_idx l_nRows = m_yCells + 2;
+
+  // bottom and top ghost rows
+  if (m_outflow[2] && i_rowFirst == 0 && i_rowLast > 0) {
+    for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+      io_q[calculateArrayPosition(l_ceX, 0)] =
+          io_q[calculateArrayPosition(l_ceX, 1)];
+    }
+  }
+  if (m_outflow[3] && i_rowFirst < l_nRows && i_rowLast == l_nRows) {
+    for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+      io_q[calculateArrayPosition(l_ceX, m_yCells + 1)] =
+          io_q[calculateArrayPosition(l_ceX, m_yCells)];
+    }
+  }
+
+  // left and right ghost cells of all rows
+  for (t_idx l_ceY = i_rowFirst; l_ceY < i_rowLast; l_ceY++) {
+    if (m_outflow[0]) {
+      io_q[calculateArrayPosition(0, l_ceY)] =
+          io_q[calculateArrayPosition(1, l_ceY)];
+    }
+    if (m_outflow[1]) {
+      io_q[calculateArrayPosition(m_xCells + 1, l_ceY)] =
+          io_q[calculateArrayPosition(m_xCells, l_ceY)];
+    }
+  }
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::deriveSpeedMax() {
+  setGhostOutflow();
+  if (!m_edgesValid) initEdges();
+
+  m_speedMax = edgeSpeedMax();
+  return m_speedMax;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::copyRowTo(
+    t_idx i_rowSrc, WavePropagation2d &io_dst, t_idx i_rowDst,
+    bool i_bathymetry) const {
+  t_idx l_ceSrc = calculateArrayPosition(0, i_rowSrc);
+  t_idx l_ceDst = io_dst.calculateArrayPosition(0, i_rowDst);
+
+  for (t_idx l_ceX = 0; l_ceX < m_xCells + 2; l_ceX++) {
+    io_dst.m_h[0][l_ceDst + l_ceX] = m_h[0][l_ceSrc + l_ceX];
+    io_dst.m_hu[0][l_ceDst + l_ceX] = m_hu[0][l_ceSrc + l_ceX];
+    io_dst.m_hv[0][l_ceDst + l_ceX] = m_hv[0][l_ceSrc + l_ceX];
+  }
+  io_dst.m_activityValid = false;
+
+  if (i_bathymetry) {
+    for (t_idx l_ceX = 0; l_ceX < m_xCells + 2; l_ceX++) {
+      io_dst.m_b[l_ceDst + l_ceX] = m_b[l_ceSrc + l_ceX];
+    }
+    io_dst.m_edgesValid = false;
+  }
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::packCells(
+    t_idx i_x, t_idx i_y, t_idx i_nx, t_idx i_ny,
+    unsigned short i_nQuantities, t_store *o_buffer) const {
+  t_store const *l_q[3] = {m_h[0].data(), m_hu[0].data(), m_hv[0].data()};
+
+  for (unsigned short l_qu = 0; l_qu < i_nQuantities; l_qu++) {
+    for (t_idx l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+      t_idx l_ce = calculateArrayPosition(i_x, i_y + l_ceY);
+      for (t_idx l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+        if (l_qu < 3) {
+          *o_buffer++ = l_q[l_qu][l_ce + l_ceX];
+        } else {
+          *o_buffer++ = m_coding.decodeBathymetry(m_b[l_ce + l_ceX]);
+        }
+      }
+    }
+  }
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::unpackCells(
+    t_idx i_x, t_idx i_y, t_idx i_nx, t_idx i_ny,
+    unsigned short i_nQuantities, t_store const *i_buffer) {
+  t_store *l_q[3] = {m_h[0].data(), m_hu[0].data(), m_hv[0].data()};
+
+  for (unsigned short l_qu = 0; l_qu < i_nQuantities; l_qu++) {
+    for (t_idx l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+      t_idx l_ce = calculateArrayPosition(i_x, i_y + l_ceY);
+      for (t_idx l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+        if (l_qu < 3) {
+          l_q[l_qu][l_ce + l_ceX] = *i_buffer++;
+        } else {
+          m_b[l_ce + l_ceX] = m_coding.encodeBathymetry(*i_buffer++);
+        }
+      }
+    }
+  }
+
+  m_activityValid = false;
+  if (i_nQuantities > 3) m_edgesValid = false;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::xSweepBlock(
+    t_compute i_scaling, t_idx i_rowFirst, t_idx i_rowLast) {
+  if (!m_edgesValid) initEdges();
+  t_compute l_speedMax = 0;
+
+#pragma omp parallel reduction(max : l_speedMax)
+  {
+    t_compute *l_netUpdates = new t_compute[4 * (m_xCells + 2)];
+
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(i_rowLast - i_rowFirst, l_first, l_last);
+    l_speedMax = xSweepRows(
+        getStride(), m_xCells + 2, i_rowFirst + l_first, i_rowFirst + l_last,
+        0, m_xCells + 2, i_scaling, m_h[0].data(), m_hu[0].data(), m_b.data(),
+        m_coding, m_edgeTypeX.data(), m_bathJumpX.data(), m_h[1].data(),
+        m_hu[1].data(), l_netUpdates);
+
+    delete[] l_netUpdates;
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_precision>
+typename T_precision::t_compute
+tsunami_lab::patches::WavePropagation2d<T_precision>::completeStep(
+    t_compute i_scaling) {
+  std::swap(m_h[0], m_h[1]);
+  std::swap(m_hu[0], m_hu[1]);
+
+  // the y-sweep accumulates the extremes at the end of the time step
+  m_time += i_scaling * m_dxy;
+  return ySweep(i_scaling);
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::setGhostOutflow() {
+  t_idx l_nRows = m_yCells + 2;
+
+  // the ghost cells copy the encoded cells
+  if (m_staging) encodeStaged();
+
+  // quiescent tiles are not written by the sweeps, their ghost cells have to
+  // be the same in both buffers
+  unsigned short l_nBuffers = m_activity ? 2 : 1;
+
+  for (unsigned short l_st = 0; l_st < l_nBuffers; l_st++) {
+    ghostOutflowRows(0, l_nRows, m_h[l_st].data());
+    ghostOutflowRows(0, l_nRows, m_hu[l_st].data());
+    ghostOutflowRows(0, l_nRows, m_hv[l_st].data());
+  }
+  ghostOutflowRows(0, l_nRows, m_b.data());
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::setBathymetryRange(
+    t_real i_min, t_real i_max) {
+  if (!std::is_integral<t_bath>::value) return;
+  Coding l_coding = m_coding;
+
+  // the stored values are symmetric, a few units are left for the rounding
+  t_compute l_max = std::numeric_limits<t_bath>::max();
+  t_compute l_range = std::max(t_compute(i_max) - t_compute(i_min),
+                               t_compute(1));
+  m_coding.m_scale = l_range / (2 * l_max - 2);
+  m_coding.m_offset =
+      m_coding.m_scale * std::round((i_min + i_max) / (2 * m_coding.m_scale));
+
+  // requantize the bathymetry which is already set
+  for (t_idx l_ce = 0; l_ce < m_b.getSize(); l_ce++) {
+    m_b[l_ce] = m_coding.encodeBathymetry(l_coding.decodeBathymetry(m_b[l_ce]));
+  }
+  m_speedMax = 0;
+  m_activityValid = false;
+  m_edgesValid = false;
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::setPrecise(
+    t_idx i_x, t_idx i_y, bool i_bathymetry, t_real i_value) {
+  t_idx l_ce = calculateArrayPosition(i_x, i_y);
+  if (m_staging) {
+    (i_bathymetry ? m_bathJumpY : m_bathJumpX)[l_ce] = i_value;
+    return;
+  }
+
+  t_compute l_h = m_coding.decodeHeight(m_h[0][l_ce], m_b[l_ce]);
+  t_compute l_b = m_coding.decodeBathymetry(m_b[l_ce]);
+  if (i_bathymetry) {
+    l_b = i_value;
+  } else {
+    l_h = i_value;
+  }
+  m_b[l_ce] = m_coding.encodeBathymetry(l_b);
+  m_h[0][l_ce] = m_coding.encodeHeight(l_h, l_b);
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::encodeStaged() {
+#pragma omp parallel
+  {
+    t_idx l_first = 0;
+    t_idx l_last = 0;
+    rowBlock(m_yCells + 2, l_first, l_last);
+
+    for (t_idx l_ceY = std::max(l_first, t_idx(1));
+         l_ceY < std::min(l_last, m_yCells + 1); l_ceY++) {
+      for (t_idx l_ceX = 1; l_ceX <= m_xCells; l_ceX++) {
+        t_idx l_ce = calculateArrayPosition(l_ceX, l_ceY);
+        t_compute l_b = m_bathJumpY[l_ce];
+        m_b[l_ce] = m_coding.encodeBathymetry(l_b);
+        m_h[0][l_ce] = m_coding.encodeHeight(m_bathJumpX[l_ce], l_b);
+      }
+    }
+  }
+  m_staging = false;
+}
+
+template <typename T_precision>
+tsunami_lab::t_real const *
+tsunami_lab::patches::WavePropagation2d<T_precision>::decodeOutput(
+    bool i_bathymetry) {
+  Grid2d<t_real> &l_out = m_output[i_bathymetry ? 3 : 0];
+  if (m_staging) {
+    return output(i_bathymetry ? m_bathJumpY : m_bathJumpX, l_out);
+  }
+
+  if (l_out.getSize() != m_b.getSize()) {
+    l_out = Grid2d<t_real>(m_xCells, m_yCells, 1, getStride(), false);
+  }
+#pragma omp parallel for schedule(static)
+  for (t_idx l_ceY = 0; l_ceY < m_yCells + 2; l_ceY++) {
+    t_idx l_ce = calculateArrayPosition(0, l_ceY);
+    decodeRow(i_bathymetry, l_ce, m_xCells + 2, l_out.data() + l_ce);
+  }
+  return l_out.interior();
+}
+
+template <typename T_precision>
+void tsunami_lab::patches::WavePropagation2d<T_precision>::decodeRow(
+    bool i_bathymetry, t_idx i_ce, t_idx i_nCells, t_real *o_row) const {
+  for (t_idx l_ceX = 0; l_ceX < i_nCells; l_ceX++) {
+    t_idx l_ce = i_ce + l_ceX;
+    if (i_bathymetry) {
+      o_row[l_ceX] = m_coding.decodeBathymetry(m_b[l_ce]);
+    } else {
+      o_row[l_ceX] = m_coding.decodeHeight(m_h[0][l_ce], m_b[l_ce]);
+    }
+  }
+}
+
+template <typename T_precision>
+tsunami_lab::t_real const *
+tsunami_lab::patches::WavePropagation2d<T_precision>::getRow(
+    unsigned short i_quantity, t_idx i_iy, t_real *io_row) {
+  t_idx l_ce = calculateArrayPosition(1, i_iy + 1);
+  if (i_quantity >= 4) return m_extremesGrid[i_quantity - 4].data() + l_ce;
+
+  bool l_decode = (i_quantity == 0 && T_precision::m_relative) ||
+                  (i_quantity == 3 && (T_precision::m_relative ||
+                                       std::is_integral<t_bath>::value));
+
+  if (l_decode && m_staging) {
+    Grid2d<t_jump> const &l_staged = (i_quantity == 3) ? m_bathJumpY
+                                                        : m_bathJumpX;
+    return convertRow(l_staged.data() + l_ce, io_row);
+  }
+  if (l_decode) {
+    decodeRow(i_quantity == 3, l_ce, m_xCells, io_row);
+    return io_row;
+  }
+
+  if (i_quantity == 3) return convertRow(m_b.data() + l_ce, io_row);
+  Grid2d<t_store> const *l_q[3] = {&m_h[0], &m_hu[0], &m_hv[0]};
+  return convertRow(l_q[i_quantity]->data() + l_ce, io_row);
+}
+
+// instantiations for the precision policies, see precision
+template class tsunami_lab::patches::WavePropagation2d<
+    tsunami_lab::precision::Float>;
+template class tsunami_lab::patches::WavePropagation2d<
+    tsunami_lab::precision::Double>;
+template class tsunami_lab::patches::WavePropagation2d<
+    tsunami_lab::precision::Mixed>;
+template class tsunami_lab::patches::WavePropagation2d<
+    tsunami_lab::precision::Fp16>;
+template class tsunami_lab::patches::WavePropagation2d<
+    tsunami_lab::precision::Bf16>;
 
-    l_displacementFrom = calculateArrayPosition(m_xCells, l_ce);
-    l_displacementTo = calculateArrayPosition(m_xCells + 1, l_ce);
-    l_h[l_displacementTo] = l_h[l_displacementFrom];
-    l_hu[l_displacementTo] = l_hu[l_displacementFrom];
-    l_hv[l_displacementTo] = l_hv[l_displacementFrom];
-    m_b[l_displacementTo] = m_b[l_displacementFrom];
+tsunami_lab::patches::WavePropagation2dBase *
+tsunami_lab::patches::WavePropagation2dBase::create(
+    std::string const &i_precision, t_idx i_xCells, t_idx i_yCells,
+    bool i_inPlace) {
+  if (i_precision == "float") {
+    return new WavePropagation2d<precision::Float>(i_xCells, i_yCells,
+                                                   i_inPlace);
+  } else if (i_precision == "double") {
+    return new WavePropagation2d<precision::Double>(i_xCells, i_yCells,
+                                                    i_inPlace);
+  } else if (i_precision == "mixed") {
+    return new WavePropagation2d<precision::Mixed>(i_xCells, i_yCells,
+                                                   i_inPlace);
+  } else if (i_precision == "fp16") {
+    return new WavePropagation2d<precision::Fp16>(i_xCells, i_yCells,
+                                                  i_inPlace);
+  } else if (i_precision == "bf16") {
+    return new WavePropagation2d<precision::Bf16>(i_xCells, i_yCells,
+                                                  i_inPlace);
   }
+  return nullptr;
 }
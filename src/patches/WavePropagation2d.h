@@ -31,38 +31,172 @@
 #ifndef TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D
 
-#include "WavePropagation.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "../Grid2d.h"
+#include "WavePropagation2dBase.h"
 
 namespace tsunami_lab {
 namespace patches {
+template <typename T_precision = precision::Float>
 class WavePropagation2d;
 }
 }  // namespace tsunami_lab
 
-class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
- private:
-  //! current step which indicates the active values in the arrays below
-  unsigned short m_step = 0;
+/**
+ * Two-dimensional wave propagation patch. The quantities are stored in the
+ *storage type of the precision policy, the net-updates and wave speeds are
+ *computed in its compute type, see precision. The interface uses t_real.
+ *
+ * Policies with relative heights store the sea surface height of wet cells,
+ *which keeps the few significant digits of half precision types for the
+ *waves. Their heights and bathymetry are staged in full precision while the
+ *cells are set, until the setup is finished, such that the surface of water
+ *at rest is exact.
+ **/
+template <typename T_precision>
+class tsunami_lab::patches::WavePropagation2d : public WavePropagation2dBase {
+ public:
+  //! type of the stored quantities
+  typedef typename T_precision::t_store t_store;
 
+  //! type of the net-updates and wave speeds
+  typedef typename T_precision::t_compute t_compute;
+
+  //! type of the stored bathymetry, integral types are quantized
+  typedef typename T_precision::t_bath t_bath;
+
+  //! type of the bathymetry jumps, the storage type if it is a floating point
+  //! type which the solver takes directly
+  typedef typename std::conditional<std::is_floating_point<t_store>::value,
+                                    t_store, t_compute>::type t_jump;
+
+  // relative heights are staged in the grids of the bathymetry jumps
+  static_assert(!T_precision::m_relative ||
+                    std::is_same<t_jump, t_compute>::value,
+                "relative heights require bathymetry jumps of t_compute");
+
+  /**
+   * Coding of the stored bathymetry and heights.
+   **/
+  struct Coding {
+    //! bathymetry of a unit of the stored values if they are integral
+    t_compute m_scale = 1;
+
+    //! bathymetry of the stored value 0 if the values are integral
+    t_compute m_offset = 0;
+
+    /**
+     * Decodes a stored bathymetry value.
+     *
+     * @param i_b stored value.
+     * @return bathymetry.
+     **/
+    t_compute decodeBathymetry(t_bath i_b) const {
+      if (!std::is_integral<t_bath>::value) return i_b;
+      return m_offset + m_scale * i_b;
+    }
+
+    /**
+     * Encodes a bathymetry value, integral values are rounded to the nearest
+     *unit and clamped to the range of t_bath.
+     *
+     * @param i_b bathymetry.
+     * @return stored value.
+     **/
+    t_bath encodeBathymetry(t_compute i_b) const {
+      if (!std::is_integral<t_bath>::value) return i_b;
+      t_compute l_max = std::numeric_limits<t_bath>::max();
+      t_compute l_q = std::round((i_b - m_offset) / m_scale);
+      return static_cast<t_bath>(std::max(std::min(l_q, l_max), -l_max));
+    }
+
+    /**
+     * Decodes a stored height.
+     *
+     * @param i_h stored height.
+     * @param i_b stored bathymetry of the cell.
+     * @return water height, not negative if the heights are relative.
+     **/
+    t_compute decodeHeight(t_store i_h, t_bath i_b) const {
+      if (!T_precision::m_relative) return i_h;
+      t_compute l_level = std::min(decodeBathymetry(i_b), t_compute(0));
+      return std::max(t_compute(i_h) - l_level, t_compute(0));
+    }
+
+    /**
+     * Encodes a height.
+     *
+     * @param i_h water height.
+     * @param i_b bathymetry of the cell.
+     * @return stored height.
+     **/
+    t_store encodeHeight(t_compute i_h, t_compute i_b) const {
+      if (!T_precision::m_relative) return i_h;
+      return i_h + std::min(i_b, t_compute(0));
+    }
+  };
+
+ private:
   //! number of cells discretizing the computational domain in x-direction
   t_idx m_xCells = 0;
 
   //! number of cells discretizing the computational domain in y-direction
   t_idx m_yCells = 0;
 
-  //! water heights for the current and next time step for all cells
-  t_real *m_h[2] = {nullptr, nullptr};
+  //! water heights for all cells; 0: current values, 1: written by the sweeps,
+  //! empty in the in-place mode
+  Grid2d<t_store> m_h[2];
 
-  //! momenta for the current and the next time step for all cells in
-  //! x-direction
-  t_real *m_hu[2] = {nullptr, nullptr};
+  //! momenta for all cells in x-direction; 0: current values, 1: written by
+  //! the x-sweep
+  Grid2d<t_store> m_hu[2];
 
-  //! momenta for the current and the next time step for all cells in
-  //! y-direction
-  t_real *m_hv[2] = {nullptr, nullptr};
+  //! momenta for all cells in y-direction; 0: current values, 1: written by
+  //! the y-sweep
+  Grid2d<t_store> m_hv[2];
 
   //! bathymetry data for all cells
-  t_real *m_b = nullptr;
+  Grid2d<t_bath> m_b;
+
+  //! coding of the bathymetry and heights
+  Coding m_coding;
+
+  //! true while the cells of relative heights are set; the heights and
+  //! bathymetry are staged in full precision in the grids of the bathymetry
+  //! jumps, which are unused until the edges are classified
+  bool m_staging = T_precision::m_relative;
+
+  //! types of the edges in x-direction, see solvers::fwave::classifyEdges;
+  //! the edge of a cell is the one on its right
+  Grid2d<unsigned char> m_edgeTypeX;
+
+  //! types of the edges in y-direction; the edge of a cell is the one above
+  Grid2d<unsigned char> m_edgeTypeY;
+
+  //! bathymetry jumps of the edges in x-direction
+  Grid2d<t_jump> m_bathJumpX;
+
+  //! bathymetry jumps of the edges in y-direction
+  Grid2d<t_jump> m_bathJumpY;
+
+  //! true if the edge types and bathymetry jumps match the bathymetry
+  bool m_edgesValid = false;
+
+  //! quantities of the getters of whole grids converted to t_real if they are
+  //! stored in another type, allocated by the first call; the output gathers
+  //! the rows instead, see getRow; 0: heights, 1: momenta in x-direction, 2:
+  //! momenta in y-direction, 3: bathymetry
+  Grid2d<t_real> m_output[4];
+
+  //! sides whose ghost cells are set to outflow; 0: left, 1: right, 2: bottom,
+  //! 3: top
+  bool m_outflow[4] = {true, true, true, true};
 
   //!  is left boundary reflecting
   bool m_reflBoundL = false;
@@ -70,19 +204,701 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
   //!  is right boundary reflecting
   bool m_reflBoundR = false;
 
+  //! number of columns the y-sweep advances row by row before it continues
+  //! with the next strip of columns, derived from the L2 cache
+  t_idx m_yStripWidth = 1024;
+
+  //! true if the sweeps update a single copy of the heights and momenta
+  bool m_inPlace = false;
+
+  //! true if the x- and y-edges are applied at once instead of sweep by sweep
+  bool m_unsplit = false;
+
+  //! true if the sweeps of all time steps of a call run in a single parallel
+  //! region whose stripes synchronize with their neighbours only
+  bool m_persistent = false;
+
+  /**
+   * Progress of a stripe of rows in the persistent parallel region.
+   **/
+  struct Stripe {
+    //! number of sweeps the stripe has finished
+    std::atomic<t_idx> m_sweeps;
+
+    //! maximum absolute wave speeds of the last two time steps
+    t_compute m_speed[2];
+
+    //! keeps the progress of neighbouring stripes in different cache lines
+    char m_padding[64];
+  };
+
+  //! true if the time steps are computed tile by tile
+  bool m_tiled = false;
+
+  //! number of cells of a tile in each direction, 0: derived from the L2 cache
+  t_idx m_tileSize = 0;
+
+  //! number of time steps a tile advances at once, 0: derived from the tile
+  t_idx m_tileDepth = 0;
+
+  //! maximum absolute wave speed of the last time step, 0 if none was done
+  //! since the quantities were set
+  t_compute m_speedMax = 0;
+
+  //! CFL number of the time steps, stable for the split and unsplit scheme
+  t_compute m_cfl = 0.5;
+
+  //! true if the sweeps skip tiles at rest
+  bool m_activity = false;
+
+  //! true if the activity of the tiles matches the quantities
+  bool m_activityValid = false;
+
+  //! number of cells of an activity tile in each direction
+  t_idx m_activityTileSize = 64;
+
+  //! momenta and differences of the sea surface up to the tolerance are at
+  //! rest
+  t_real m_activityTol = 0;
+
+  //! number of activity tiles in x-direction
+  t_idx m_nActTilesX = 0;
+
+  //! number of activity tiles in y-direction
+  t_idx m_nActTilesY = 0;
+
+  //! activity of the tiles, row-major
+  std::vector<unsigned char> m_tileActive;
+
+  //! activity of the tiles in the next time step
+  std::vector<unsigned char> m_tileActiveNext;
+
+  //! true if the rows are distributed by their cost and idle threads steal
+  //! rows of the others
+  bool m_balanced = false;
+
+  //! number of chunks of rows initially queued for every thread
+  static t_idx constexpr m_chunksPerQueue = 4;
+
+  //! cost of a wet edge relative to the update of a cell; the sweeps of wet
+  //! rows take about twice as long as the ones of dry rows
+  static t_real constexpr m_wetEdgeCost = 0.5;
+
+  //! number of queues the chunks were derived for, 0 if outdated
+  t_idx m_nQueues = 0;
+
+  //! first rows of the chunks of equal cost and the number of rows
+  std::vector<t_idx> m_chunkRows;
+
+  //! sums of the busy times of the slowest threads and of the mean busy
+  //! times of the sweeps of the last call
+  double m_busyMax = 0;
+  double m_busyMean = 0;
+
+  //! true if the extremes of the cells are accumulated after every time step
+  bool m_extremes = false;
+
+  //! amplitude of the sea surface from which on a wave has arrived at a cell
+  t_real m_arrivalThreshold = 0;
+
+  //! cell width converting the constant time steps to the simulated time
+  t_compute m_dxy = 1;
+
+  //! simulated time of the time steps since the construction
+  double m_time = 0;
+
+  //! minimum height of a wet cell of the extremes, shallower cells have no
+  //! meaningful velocity
+  static t_real constexpr m_wetHeight = 0.01;
+
+  //! extremes of the interior cells; 0: maximum absolute sea surface height
+  //! of the wet cells, 1: maximum velocity, 2: arrival time, -1 if none
+  Grid2d<t_real> m_extremesGrid[3];
+
+  //! cells of the stations including the ghost cells
+  std::vector<t_idx> m_stationCells;
+
+  //! ring buffer of the records of the stations: simulated time, heights,
+  //! momenta in x-direction and momenta in y-direction of all stations
+  std::vector<t_real> m_stationRing;
+
+  //! number of records of the ring buffer
+  t_idx m_stationCapacity = 1;
+
+  //! slot of the next record
+  t_idx m_stationHead = 0;
+
+  //! number of records which were not taken yet
+  t_idx m_stationCount = 0;
+
+  //! number of records which were overwritten before they were taken
+  t_idx m_stationDropped = 0;
+
+  /**
+   * Queue of chunks of rows of a sweep, other threads steal from its front.
+   **/
+  struct RowQueue {
+    //! next chunk of the queue
+    std::atomic<t_idx> m_next;
+
+    //! chunk after the last chunk of the queue
+    t_idx m_end;
+
+    //! keeps the queues of different threads in different cache lines
+    char m_padding[64];
+  };
+
+  /**
+   * Derives chunks of rows of equal cost from the edge types. Every cell of a
+   *row is updated, the wet edges are solved in addition.
+   **/
+  void initBalancing();
+
+  /**
+   * Sets up the queues of a sweep, queue i holds the i-th consecutive group
+   *of m_chunksPerQueue chunks.
+   *
+   * @param o_queues will be set to the queues, empty if the balancing is
+   *disabled.
+   **/
+  void initQueues(std::vector<RowQueue> &o_queues) const;
+
+  /**
+   * Claims the next block of rows of a sweep for the calling thread of a
+   *parallel region. Without balancing, the thread gets its rowBlock once.
+   *Otherwise the thread works through its own queue first and steals from
+   *the queues of the following threads afterwards.
+   *
+   * @param io_queues queues of the sweep.
+   * @param io_visited number of queues the thread emptied, 0 initially.
+   * @param o_first will be set to the first row of the block.
+   * @param o_last will be set to the row after the last row of the block.
+   * @return true if a block was claimed, false if all rows are done.
+   **/
+  bool claimRows(std::vector<RowQueue> &io_queues, t_idx &io_visited,
+                 t_idx &o_first, t_idx &o_last) const;
+
+  /**
+   * Adds the busy times of the threads of a sweep to the imbalance.
+   *
+   * @param i_busy busy times of the threads.
+   **/
+  void addBusyTimes(std::vector<double> const &i_busy);
+
+  /**
+   * Derives the contiguous block of rows which is owned by the calling thread
+   *of a parallel region. Both sweeps use the same blocks.
+   *
+   * @param i_nRows number of rows.
+   * @param o_first will be set to the first row of the block.
+   * @param o_last will be set to the row after the last row of the block.
+   **/
+  static void rowBlock(t_idx i_nRows, t_idx &o_first, t_idx &o_last);
+
+  /**
+   * Derives the types and bathymetry jumps of all edges from the bathymetry
+   *including the ghost cells. The edges of the last column and row have no
+   *right or upper cell and are classified as dry.
+   **/
+  void initEdges();
+
+  /**
+   * Computes the net-updates of a row of classified edges. Runs of edges
+   *between two dry cells are not passed to the solver, their net-updates are
+   *set to zero. Relative heights are decoded chunk by chunk beforehand.
+   *
+   * @param i_nEdges number of edges.
+   * @param i_hL stored heights of the left sides.
+   * @param i_hR stored heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL stored bathymetry of the left sides.
+   * @param i_bR stored bathymetry of the right sides.
+   * @param i_coding coding of the bathymetry and heights.
+   * @param i_edgeType types of the edges.
+   * @param i_bathJump bathymetry jumps of the edges.
+   * @param o_netUpdateHL will be set to the height net-updates of the left
+   *sides.
+   * @param o_netUpdateHuL will be set to the momentum net-updates of the left
+   *sides.
+   * @param o_netUpdateHR will be set to the height net-updates of the right
+   *sides.
+   * @param o_netUpdateHuR will be set to the momentum net-updates of the right
+   *sides.
+   * @return maximum absolute wave speed of the edges.
+   **/
+  static t_compute netUpdatesRow(t_idx i_nEdges, t_store const *i_hL,
+                                 t_store const *i_hR, t_store const *i_huL,
+                                 t_store const *i_huR, t_bath const *i_bL,
+                                 t_bath const *i_bR, Coding const &i_coding,
+                                 unsigned char const *i_edgeType,
+                                 t_jump const *i_bathJump,
+                                 t_compute *o_netUpdateHL,
+                                 t_compute *o_netUpdateHuL,
+                                 t_compute *o_netUpdateHR,
+                                 t_compute *o_netUpdateHuR);
+
+  /**
+   * Computes the net-updates of a run of wet edges, see netUpdatesRow. The
+   *stored quantities are passed to the solver directly.
+   **/
+  template <typename T>
+  static t_compute netUpdatesRun(std::false_type, t_idx i_nEdges,
+                                 T const *i_hL, T const *i_hR, T const *i_huL,
+                                 T const *i_huR, t_bath const *,
+                                 t_bath const *, Coding const &,
+                                 unsigned char const *i_edgeType,
+                                 T const *i_bathJump,
+                                 t_compute *o_netUpdateHL,
+                                 t_compute *o_netUpdateHuL,
+                                 t_compute *o_netUpdateHR,
+                                 t_compute *o_netUpdateHuR);
+
+  /**
+   * Computes the net-updates of a run of wet edges with relative heights,
+   *see netUpdatesRow. The heights and momenta are decoded chunk by chunk.
+   **/
+  static t_compute netUpdatesRun(std::true_type, t_idx i_nEdges,
+                                 t_store const *i_hL, t_store const *i_hR,
+                                 t_store const *i_huL, t_store const *i_huR,
+                                 t_bath const *i_bL, t_bath const *i_bR,
+                                 Coding const &i_coding,
+                                 unsigned char const *i_edgeType,
+                                 t_jump const *i_bathJump,
+                                 t_compute *o_netUpdateHL,
+                                 t_compute *o_netUpdateHuL,
+                                 t_compute *o_netUpdateHR,
+                                 t_compute *o_netUpdateHuR);
+
+  /**
+   * Updates the heights and momenta in x-direction with the net-updates of
+   *all edges in x-direction. Reads the current values and writes the other
+   *buffer, which becomes the current one afterwards.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_compute xSweep(t_compute i_scaling);
+
+  /**
+   * Updates the heights and momenta in y-direction with the net-updates of
+   *all edges in y-direction. Reads the current values and writes the other
+   *buffer, which becomes the current one afterwards.
+   *
+   * @param i_scaling scaling of the time step (dt / dy).
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_compute ySweep(t_compute i_scaling);
+
+  /**
+   * Updates the heights and momenta in x-direction in place. The net-updates
+   *of a row are computed before the row is written, every thread sweeps the
+   *block of rows it touched first.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_compute xSweepInPlace(t_compute i_scaling);
+
+  /**
+   * Updates the heights and momenta in y-direction in place. Every thread
+   *derives the new values of the first and last row of its block into a
+   *rolling buffer while the neighbouring rows are unchanged. After a barrier,
+   *the inner rows are swept bottom to top, each row is written once the edges
+   *above it are computed. The buffered rows are written last.
+   *
+   * @param i_scaling scaling of the time step (dt / dy).
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_compute ySweepInPlace(t_compute i_scaling);
+
+  /**
+   * Applies the x-sweep to a rectangular block of cells. Only the edges
+   *adjacent to the block are evaluated, the outermost columns of the array
+   *only have the edge on their inner side.
+   *
+   * @param i_stride stride of the arrays in y-direction.
+   * @param i_nCols number of columns of the arrays.
+   * @param i_rowFirst first row of the block.
+   * @param i_rowLast row after the last row of the block.
+   * @param i_colFirst first column of the block.
+   * @param i_colLast column after the last column of the block.
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_h water heights.
+   * @param i_hu momenta in x-direction.
+   * @param i_b bathymetry.
+   * @param i_coding coding of the bathymetry and heights.
+   * @param i_edgeType types of the edges in x-direction.
+   * @param i_bathJump bathymetry jumps of the edges in x-direction.
+   * @param o_h will be set to the updated water heights of the block.
+   * @param o_hu will be set to the updated momenta of the block.
+   * @param o_netUpdates scratch memory of 4 * i_nCols values.
+   * @return maximum absolute wave speed of the evaluated edges.
+   **/
+  static t_compute xSweepRows(t_idx i_stride, t_idx i_nCols, t_idx i_rowFirst,
+                              t_idx i_rowLast, t_idx i_colFirst,
+                              t_idx i_colLast, t_compute i_scaling,
+                              t_store const *i_h, t_store const *i_hu,
+                              t_bath const *i_b, Coding const &i_coding,
+                              unsigned char const *i_edgeType,
+                              t_jump const *i_bathJump, t_store *o_h,
+                              t_store *o_hu, t_compute *o_netUpdates);
+
+  /**
+   * Applies the y-sweep to a rectangular block of cells. Only the edges
+   *adjacent to the block are evaluated, the outermost rows of the array only
+   *have the edge on their inner side.
+   *
+   * @param i_stride stride of the arrays in y-direction.
+   * @param i_nRows number of rows of the arrays.
+   * @param i_rowFirst first row of the block.
+   * @param i_rowLast row after the last row of the block.
+   * @param i_colFirst first column of the block.
+   * @param i_colLast column after the last column of the block.
+   * @param i_scaling scaling of the time step (dt / dy).
+   * @param i_h water heights.
+   * @param i_hv momenta in y-direction.
+   * @param i_b bathymetry.
+   * @param i_coding coding of the bathymetry and heights.
+   * @param i_edgeType types of the edges in y-direction.
+   * @param i_bathJump bathymetry jumps of the edges in y-direction.
+   * @param o_h will be set to the updated water heights of the block.
+   * @param o_hv will be set to the updated momenta of the block.
+   * @param o_netUpdates scratch memory of 6 * (i_colLast - i_colFirst) values.
+   * @return maximum absolute wave speed of the evaluated edges.
+   **/
+  static t_compute ySweepRows(t_idx i_stride, t_idx i_nRows, t_idx i_rowFirst,
+                              t_idx i_rowLast, t_idx i_colFirst,
+                              t_idx i_colLast, t_compute i_scaling,
+                              t_store const *i_h, t_store const *i_hv,
+                              t_bath const *i_b, Coding const &i_coding,
+                              unsigned char const *i_edgeType,
+                              t_jump const *i_bathJump, t_store *o_h,
+                              t_store *o_hv, t_compute *o_netUpdates);
+
+  /**
+   * Applies the net-updates of the x- and y-edges to a block of rows at once,
+   *every cell is read and written once per time step. The x-edges are
+   *computed row by row, the y-edges above a row are carried over to the next
+   *row. The ghost columns only receive the updates of their inner x-edge.
+   *
+   * @param i_stride stride of the arrays in y-direction.
+   * @param i_nCols number of columns of the arrays.
+   * @param i_nRows number of rows of the arrays.
+   * @param i_rowFirst first row of the block.
+   * @param i_rowLast row after the last row of the block.
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_h water heights.
+   * @param i_hu momenta in x-direction.
+   * @param i_hv momenta in y-direction.
+   * @param i_b bathymetry.
+   * @param i_coding coding of the bathymetry and heights.
+   * @param i_edgeTypeX types of the edges in x-direction.
+   * @param i_bathJumpX bathymetry jumps of the edges in x-direction.
+   * @param i_edgeTypeY types of the edges in y-direction.
+   * @param i_bathJumpY bathymetry jumps of the edges in y-direction.
+   * @param o_h will be set to the updated water heights of the block.
+   * @param o_hu will be set to the updated momenta in x-direction.
+   * @param o_hv will be set to the updated momenta in y-direction.
+   * @param o_netUpdates scratch memory of 10 * i_nCols values.
+   * @return maximum absolute wave speed of the evaluated edges.
+   **/
+  static t_compute unsplitRows(t_idx i_stride, t_idx i_nCols, t_idx i_nRows,
+                               t_idx i_rowFirst, t_idx i_rowLast,
+                               t_compute i_scaling, t_store const *i_h,
+                               t_store const *i_hu, t_store const *i_hv,
+                               t_bath const *i_b, Coding const &i_coding,
+                               unsigned char const *i_edgeTypeX,
+                               t_jump const *i_bathJumpX,
+                               unsigned char const *i_edgeTypeY,
+                               t_jump const *i_bathJumpY, t_store *o_h,
+                               t_store *o_hu, t_store *o_hv,
+                               t_compute *o_netUpdates);
+
+  /**
+   * Performs a time step with the unsplit scheme. Reads the current values
+   *and writes the other buffers, which become the current ones afterwards.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @return maximum absolute wave speed of the time step.
+   **/
+  t_compute unsplitStep(t_compute i_scaling);
+
+  /**
+   * Copies the values of the boundary cells to the ghost cells of a block of
+   *rows (outflow). The ghost rows are only set by the blocks containing them.
+   *
+   * @param i_rowFirst first row of the block including the ghost rows.
+   * @param i_rowLast row after the last row of the block.
+   * @param io_q values of a quantity.
+   **/
+  template <typename T>
+  void ghostOutflowRows(t_idx i_rowFirst, t_idx i_rowLast, T *io_q);
+
+  /**
+   * Waits until a stripe has finished the given number of sweeps.
+   *
+   * @param i_stripe stripe.
+   * @param i_nSweeps number of sweeps.
+   **/
+  static void waitForStripe(Stripe const &i_stripe, t_idx i_nSweeps);
+
+  /**
+   * Performs time steps with the split scheme in a single parallel region.
+   *Every thread owns a stripe of rows and sets its ghost cells. The y-sweep
+   *of a stripe waits for the x-sweeps of the neighbouring stripes and the
+   *x-sweep of the next time step for their y-sweeps; the stripes do not
+   *synchronize otherwise, except for the reduction of the wave speeds if the
+   *time steps are adaptive. The result is bitwise identical to the sweeps.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scaling scaling of the time steps (dt / dx), ignored if i_dxy is
+   *given.
+   * @param i_dxy cell width; if positive, every time step is derived from the
+   *maximum wave speed of the previous one, see m_speedMax.
+   * @param o_time will be set to the sum of the adaptive time steps.
+   * @return maximum absolute wave speed of the last time step.
+   **/
+  t_compute persistentSteps(t_idx i_nSteps, t_compute i_scaling,
+                            t_compute i_dxy, t_compute &o_time);
+
+  /**
+   * Checks if the time steps are computed in the persistent parallel region.
+   *
+   * @return true if the persistent region is used.
+   **/
+  bool usePersistent() const {
+    return m_persistent;
+  }
+
+  /**
+   * Performs time steps tile by tile. Every tile is copied together with a
+   *halo of one cell per step and advanced by all steps before it is written
+   *back, the halo's cells are computed redundantly by the neighbouring tiles.
+   *The result is bitwise identical to the sweeps.
+   *
+   * @param i_scaling scaling of the time steps (dt / dx).
+   * @param i_nSteps number of time steps.
+   * @param i_tileSize number of cells of a tile in each direction.
+   * @param i_speedLimit largest wave speed for which the time steps are
+   *stable, 0 if unchecked. The cells are left unchanged if a wave exceeds it.
+   * @return maximum absolute wave speed of the time steps.
+   **/
+  t_compute tiledSteps(t_compute i_scaling, t_idx i_nSteps, t_idx i_tileSize,
+                       t_compute i_speedLimit);
+
+  /**
+   * Performs time steps with a constant time step, either unsplit, tiled or
+   *through the sweeps.
+   *
+   * @param i_scaling scaling of the time steps (dt / dx).
+   * @param i_nSteps number of time steps, 1 if the tiling is disabled.
+   * @param i_tileSize number of cells of a tile in each direction.
+   * @param i_speedLimit largest wave speed for which the tiled time steps are
+   *stable, 0 if unchecked. The steps are discarded if a wave exceeds it.
+   * @return maximum absolute wave speed of the time steps.
+   **/
+  t_compute steps(t_compute i_scaling, t_idx i_nSteps, t_idx i_tileSize,
+                  t_compute i_speedLimit = 0);
+
+  /**
+   * Accumulates the extremes of the interior cells of a block of rows.
+   *
+   * @param i_rowFirst first row of the block including the ghost rows.
+   * @param i_rowLast row after the last row of the block.
+   * @param i_h heights.
+   * @param i_hu momenta in x-direction.
+   * @param i_hv momenta in y-direction.
+   * @param i_time simulated time of the quantities.
+   **/
+  void extremesRows(t_idx i_rowFirst, t_idx i_rowLast, t_store const *i_h,
+                    t_store const *i_hu, t_store const *i_hv, double i_time);
+
+  /**
+   * Accumulates the extremes of all cells from the current quantities, for
+   *the schemes whose sweeps do not accumulate them.
+   **/
+  void extremesAll();
+
+  /**
+   * Samples the stations of a block of rows into a slot of the ring buffer.
+   *
+   * @param i_rowFirst first row of the block including the ghost rows.
+   * @param i_rowLast row after the last row of the block.
+   * @param i_slot slot of the record.
+   * @param i_h heights.
+   * @param i_hu momenta in x-direction.
+   * @param i_hv momenta in y-direction.
+   **/
+  void stationsRows(t_idx i_rowFirst, t_idx i_rowLast, t_idx i_slot,
+                    t_store const *i_h, t_store const *i_hu,
+                    t_store const *i_hv);
+
+  /**
+   * Records the simulated time and the current quantities of all stations.
+   **/
+  void sampleStations();
+
+  /**
+   * Advances the ring buffer of the stations by written records, the oldest
+   *records are dropped if it overflows.
+   *
+   * @param i_nRecords number of written records.
+   **/
+  void advanceStations(t_idx i_nRecords);
+
+  /**
+   * Checks if the edge between two cells is at rest, i.e., all wet cells have
+   *no momentum and two wet cells have the same sea surface height.
+   *
+   * @param i_ceL id of the first cell.
+   * @param i_ceR id of the second cell.
+   * @return true if the edge is at rest.
+   **/
+  bool edgeAtRest(t_idx i_ceL, t_idx i_ceR) const;
+
+  /**
+   * Derives the activity of all tiles from the current quantities, a tile is
+   *active if any edge of its cells is not at rest. Both buffers are
+   *synchronized since the sweeps only write active tiles.
+   **/
+  void initActivity();
+
+  /**
+   * Activates the neighbours of the active tiles whose border bands are not
+   *at rest anymore. Tiles stay active once they were activated.
+   **/
+  void growActivity();
+
+  /**
+   * Applies a sweep to the active tiles only.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_xSweep true for the x-sweep, false for the y-sweep.
+   * @return maximum absolute wave speed of the sweep.
+   **/
+  t_compute sweepActive(t_compute i_scaling, bool i_xSweep);
+
+  /**
+   * Derives the maximum absolute wave speed of all edges from the current
+   *quantities without updating them.
+   *
+   * @return maximum absolute wave speed.
+   **/
+  t_compute edgeSpeedMax();
+
+  /**
+   * Gets the interior of a grid whose values are stored in t_real.
+   *
+   * @param i_q grid of a quantity.
+   * @return values starting at the first interior cell.
+   **/
+  static t_real const *output(Grid2d<t_real> const &i_q, Grid2d<t_real> &) {
+    return i_q.interior();
+  }
+
+  /**
+   * Converts the values of a grid to t_real, the converted grid shares the
+   *stride in y-direction.
+   *
+   * @param i_q grid of a quantity.
+   * @param io_out grid which will be set to the converted values.
+   * @return converted values starting at the first interior cell.
+   **/
+  template <typename T>
+  static t_real const *output(Grid2d<T> const &i_q, Grid2d<t_real> &io_out) {
+    if (io_out.getSize() != i_q.getSize()) {
+      io_out = Grid2d<t_real>(i_q.getNx(), i_q.getNy(), i_q.getGhost(),
+                              i_q.getStride(), false);
+    }
+#pragma omp parallel for schedule(static)
+    for (t_idx l_ce = 0; l_ce < i_q.getSize(); l_ce++) {
+      io_out[l_ce] = i_q[l_ce];
+    }
+    return io_out.interior();
+  }
+
+  /**
+   * Gets a row whose values are stored in t_real.
+   *
+   * @param i_q values of the row's interior cells.
+   * @return values of the row.
+   **/
+  t_real const *convertRow(t_real const *i_q, t_real *) const { return i_q; }
+
+  /**
+   * Converts the values of a row to t_real.
+   *
+   * @param i_q values of the row's interior cells.
+   * @param io_row will be set to the converted values.
+   * @return converted values.
+   **/
+  template <typename T>
+  t_real const *convertRow(T const *i_q, t_real *io_row) const {
+    for (t_idx l_ceX = 0; l_ceX < m_xCells; l_ceX++) io_row[l_ceX] = i_q[l_ceX];
+    return io_row;
+  }
+
+  /**
+   * Decodes the relative heights or the quantized bathymetry to t_real. The
+   *staged values are taken while the cells are set.
+   *
+   * @param i_bathymetry true for the bathymetry, false for the heights.
+   * @return decoded values starting at the first interior cell.
+   **/
+  t_real const *decodeOutput(bool i_bathymetry);
+
+  /**
+   * Decodes the relative heights or the quantized bathymetry of consecutive
+   *cells to t_real.
+   *
+   * @param i_bathymetry true for the bathymetry, false for the heights.
+   * @param i_ce position of the first cell.
+   * @param i_nCells number of cells.
+   * @param o_row will be set to the decoded values.
+   **/
+  void decodeRow(bool i_bathymetry, t_idx i_ce, t_idx i_nCells,
+                 t_real *o_row) const;
+
+  /**
+   * Sets the height or bathymetry of a cell in full precision, e.g., for
+   *relative heights. The value is staged until the setup is finished, cells
+   *which are set afterwards decode the other quantity of the cell and encode
+   *both.
+   *
+   * @param i_x id of the cell in x-direction including the ghost cells.
+   * @param i_y id of the cell in y-direction including the ghost cells.
+   * @param i_bathymetry true for the bathymetry, false for the height.
+   * @param i_value height or bathymetry.
+   **/
+  void setPrecise(t_idx i_x, t_idx i_y, bool i_bathymetry, t_real i_value);
+
+  /**
+   * Encodes the staged heights and bathymetry of the interior cells, every
+   *thread encodes the block of rows it sweeps later.
+   **/
+  void encodeStaged();
+
  public:
   /**
    * Constructs the 2d wave propagation solver.
    *
    * @param i_xCells number of cells in x-direction.
    * @param i_yCells number of cells in y-direction.
+   * @param i_inPlace true if the heights and momenta are stored once and
+   *updated in place by the split sweeps, which halves the memory of the
+   *state. The in-place mode rejects the unsplit scheme, the tiled execution,
+   *the tracking of active tiles, the persistent region and the balancing, and
+   *does not support xSweepBlock and completeStep.
    **/
-  WavePropagation2d(t_idx i_xCells, t_idx i_yCells);
+  WavePropagation2d(t_idx i_xCells, t_idx i_yCells, bool i_inPlace = false);
 
   /**
-   * Destructor which frees all allocated memory.
+   * Checks if the heights and momenta are updated in place.
+   *
+   * @return true for the in-place mode.
    **/
-  ~WavePropagation2d();
+  bool isInPlace() const { return m_inPlace; }
 
   /**
    * Performs a time step.
@@ -91,19 +907,235 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
    **/
   void timeStep(t_real i_scaling, t_idx i_computeSteps);
 
+  /**
+   * Performs time steps with the largest stable time step. The time step is
+   *derived from the maximum wave speed of the previous step, which the sweeps
+   *reduce on the fly. Tiles use one time step for all steps they advance at
+   *once.
+   *
+   * @param i_dxy cell size.
+   * @param i_computeSteps number of time steps.
+   * @return simulated time of all time steps.
+   **/
+  t_real timeStepAdaptive(t_real i_dxy, t_idx i_computeSteps);
+
   /**
    * Sets the values of the ghost cells according to outflow boundary
    *conditions.
    **/
   void setGhostOutflow();
 
+  /**
+   * Selects the unsplit scheme, which applies the net-updates of the x- and
+   *y-edges in a single traversal of the grid, or the dimensionally split
+   *scheme, which applies them sweep by sweep. The unsplit scheme cannot be
+   *combined with the in-place mode, the persistent region, the tiled
+   *execution and the tracking of active tiles.
+   *
+   * @param i_unsplit true for the unsplit scheme.
+   * @return false if the unsplit scheme was rejected, the solver is unchanged.
+   **/
+  bool setUnsplit(bool i_unsplit) {
+    if (i_unsplit && (m_inPlace || m_persistent || m_tiled || m_activity)) {
+      return false;
+    }
+    m_unsplit = i_unsplit;
+    m_activityValid = false;
+    return true;
+  }
+
+  /**
+   * Selects whether the split scheme runs all time steps of a call in a
+   *single parallel region whose threads synchronize with their neighbours
+   *only, instead of a parallel region per sweep. The persistent region cannot
+   *be combined with the in-place mode, the unsplit scheme, the tiled
+   *execution, the tracking of active tiles and the balancing of the rows.
+   *
+   * @param i_persistent true for the persistent parallel region.
+   * @return false if the persistent region was rejected, the solver is
+   *unchanged.
+   **/
+  bool setPersistent(bool i_persistent) {
+    if (i_persistent &&
+        (m_inPlace || m_unsplit || m_tiled || m_activity || m_balanced)) {
+      return false;
+    }
+    m_persistent = i_persistent;
+    return true;
+  }
+
+  /**
+   * Enables or disables the tiled execution with temporal blocking. The tiled
+   *execution cannot be combined with the in-place mode, the unsplit scheme,
+   *the persistent region, the tracking of active tiles and the balancing of
+   *the rows.
+   *
+   * @param i_tiled true if the time steps are computed tile by tile.
+   * @param i_tileSize number of cells of a tile in each direction, 0 derives
+   *it from the size of the L2 cache.
+   * @param i_depth number of time steps a tile advances at once, 0 derives it
+   *from the tile size.
+   * @return false if the tiled execution was rejected, the solver is unchanged.
+   **/
+  bool setTiling(bool i_tiled, t_idx i_tileSize = 0, t_idx i_depth = 0) {
+    if (i_tiled &&
+        (m_inPlace || m_unsplit || m_persistent || m_activity || m_balanced)) {
+      return false;
+    }
+    m_tiled = i_tiled;
+    m_tileSize = i_tileSize;
+    m_tileDepth = i_depth;
+    return true;
+  }
+
+  /**
+   * Enables or disables the tracking of active tiles. The sweeps skip tiles
+   *whose edges are at rest, e.g., the ocean ahead of a tsunami. The tracking
+   *cannot be combined with the in-place mode, the unsplit scheme, the
+   *persistent region, the tiled execution and the balancing of the rows.
+   *
+   * @param i_enabled true if tiles at rest are skipped.
+   * @param i_tileSize number of cells of a tile in each direction.
+   * @param i_tolerance momenta and differences of the sea surface height up to
+   *the tolerance are at rest.
+   * @return false if the tracking was rejected, the solver is unchanged.
+   **/
+  bool setActivityTracking(bool i_enabled, t_idx i_tileSize = 64,
+                           t_real i_tolerance = 1E-3);
+
+  /**
+   * Gets the fraction of active tiles.
+   *
+   * @return fraction of active tiles, 1 if the tracking is disabled.
+   **/
+  t_real getActiveFraction() const;
+
+  /**
+   * Enables or disables the distribution of the rows by their cost, which is
+   *derived from the number of wet edges, and the stealing of rows by idle
+   *threads. Applies to the sweeps and the unsplit scheme, the balancing
+   *cannot be combined with the in-place mode, the persistent region, the
+   *tiled execution and the tracking of active tiles.
+   *
+   * @param i_balanced true if the rows are balanced.
+   * @return false if the balancing was rejected, the solver is unchanged.
+   **/
+  bool setBalancing(bool i_balanced) {
+    if (i_balanced && (m_inPlace || m_persistent || m_tiled || m_activity)) {
+      return false;
+    }
+    m_balanced = i_balanced;
+    m_nQueues = 0;
+    return true;
+  }
+
+  /**
+   * Gets the load imbalance of the sweeps of the last call of timeStep or
+   *timeStepAdaptive, i.e., the busy time of the slowest thread relative to
+   *the mean busy time of all threads minus one. 0 is perfectly balanced.
+   *
+   * @return load imbalance, 0 if no sweep was measured.
+   **/
+  double getLoadImbalance() const {
+    return (m_busyMean > 0) ? m_busyMax / m_busyMean - 1 : 0;
+  }
+
+  /**
+   * Enables or disables the accumulation of the maximum absolute sea surface
+   *height, the maximum velocity and the arrival time of every interior cell
+   *and resets them. The y-sweep of the split scheme accumulates the rows it
+   *wrote, the other schemes traverse the cells after every time step; the
+   *tiled execution after every block of time steps a tile advances at once.
+   *
+   * @param i_enabled true if the extremes are accumulated.
+   * @param i_threshold amplitude of the sea surface from which on a wave has
+   *arrived at a cell.
+   * @param i_dxy cell width, converts the scaling of timeStep and
+   *completeStep to the simulated time. timeStepAdaptive uses its own.
+   * @return true.
+   **/
+  bool setExtremes(bool i_enabled, t_real i_threshold = 0.01,
+                   t_real i_dxy = 1);
+
+  /**
+   * Gets the maximum absolute sea surface height of the cells while they were
+   *wet.
+   *
+   * @return maximum absolute sea surface heights, starting at the first
+   *interior cell.
+   **/
+  t_real const *getMaxAmplitude() const {
+    return m_extremesGrid[0].interior();
+  }
+
+  /**
+   * Gets the maximum velocity of the cells while they were wet.
+   *
+   * @return maximum velocities, starting at the first interior cell.
+   **/
+  t_real const *getMaxVelocity() const { return m_extremesGrid[1].interior(); }
+
+  /**
+   * Gets the simulated time at which the absolute sea surface height of the
+   *cells reached the threshold first.
+   *
+   * @return arrival times, -1 if the wave did not arrive, starting at the
+   *first interior cell.
+   **/
+  t_real const *getArrivalTime() const { return m_extremesGrid[2].interior(); }
+
+  /**
+   * Sets the cells sampled after every time step, e.g., virtual tide gauges.
+   *Every record holds the simulated time and the height and momenta of all
+   *stations. The records are kept in a ring buffer until they are taken; if
+   *more are recorded, the oldest ones are dropped. The tiled execution
+   *samples after every block of time steps a tile advances at once.
+   *
+   * @param i_nStations number of stations, 0 disables the sampling.
+   * @param i_ix ids of the cells of the stations in x-direction.
+   * @param i_iy ids of the cells of the stations in y-direction.
+   * @param i_capacity number of records of the ring buffer, e.g., the number
+   *of time steps between two calls of getStationRecords.
+   **/
+  void setStations(t_idx i_nStations, t_idx const *i_ix, t_idx const *i_iy,
+                   t_idx i_capacity);
+
+  /**
+   * Appends the records of the stations since the last call, oldest first,
+   *and removes them from the ring buffer.
+   *
+   * @param io_records records are appended to, 1 + 3 * number of stations
+   *values each.
+   **/
+  void getStationRecords(std::vector<t_real> &io_records);
+
+  /**
+   * Gets the number of records of the stations which were dropped.
+   *
+   * @return number of records.
+   **/
+  t_idx getStationsDropped() const { return m_stationDropped; }
+
+  /**
+   * Derives the tile size and the number of time steps a tile advances at
+   *once.
+   *
+   * @param i_computeSteps number of time steps per call of timeStep.
+   * @param o_tileSize will be set to the number of cells of a tile in each
+   *direction.
+   * @param o_depth will be set to the number of time steps a tile advances at
+   *once.
+   **/
+  void deriveTiling(t_idx i_computeSteps, t_idx &o_tileSize,
+                    t_idx &o_depth) const;
+
   /**
    * calculate the position in one dimensional array
    *
    * @return the position.
    **/
-  t_idx calculateArrayPosition(t_idx i_ix, t_idx i_iy) {
-    return i_ix + (i_iy * (m_xCells + 2));
+  t_idx calculateArrayPosition(t_idx i_ix, t_idx i_iy) const {
+    return i_ix + (i_iy * m_b.getStride());
   }
 
   /**
@@ -111,34 +1143,56 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
    *
    * @return stride in y-direction.
    **/
-  t_idx getStride() { return (m_xCells + 2); }
+  t_idx getStride() { return m_b.getStride(); }
 
   /**
    * Gets cells' water heights.
    *
    * @return water heights.
    */
-  t_real const *getHeight() { return m_h[m_step] + 3 + m_xCells; }
+  t_real const *getHeight() {
+    if (T_precision::m_relative) return decodeOutput(false);
+    return output(m_h[0], m_output[0]);
+  }
 
   /**
    * Gets the cells' momenta in x-direction.
    *
    * @return momenta in x-direction.
    **/
-  t_real const *getMomentumX() { return m_hu[m_step] + 3 + m_xCells; }
+  t_real const *getMomentumX() { return output(m_hu[0], m_output[1]); }
 
   /**
    * Gets the cell's momentum in y-direction.
    *
    * @return momenta in y-direction.
    **/
-  t_real const *getMomentumY() { return m_hv[m_step] + 3 + m_xCells; }
+  t_real const *getMomentumY() { return output(m_hv[0], m_output[2]); }
   /**
    * Gets the cells' bathymetry in x-direction.
    *
    * @return bathymetry in x-direction.
    **/
-  t_real const *getBathymetry() { return m_b + 3 + m_xCells; }
+  t_real const *getBathymetry() {
+    if (T_precision::m_relative || std::is_integral<t_bath>::value) {
+      return decodeOutput(true);
+    }
+    return output(m_b, m_output[3]);
+  }
+
+  /**
+   * Gets the interior cells of a row of a quantity. Quantities stored in
+   *t_real are returned directly, others are converted or decoded into the
+   *buffer; no grid of the whole domain is allocated.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry, 4-6: extremes, see setExtremes.
+   * @param i_iy id of the row.
+   * @param io_row buffer of a row.
+   * @return values of the row's interior cells.
+   **/
+  t_real const *getRow(unsigned short i_quantity, t_idx i_iy,
+                       t_real *io_row);
 
   /**
    * Sets the height of the cell to the given value.
@@ -148,7 +1202,11 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
    * @param i_h water height.
    **/
   void setHeight(t_idx i_ix, t_idx i_iy, t_real i_h) {
-    m_h[m_step][(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_h;
+    if (T_precision::m_relative) {
+      setPrecise(i_ix + 1, i_iy + 1, false, i_h);
+    } else {
+      m_h[0](i_ix + 1, i_iy + 1) = i_h;
+    }
   }
 
   /**
@@ -159,7 +1217,7 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
    * @param i_y id of the cell in y-direction.
    **/
   void setMomentumX(t_idx i_ix, t_idx i_iy, t_real i_hu) {
-    m_hu[m_step][(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_hu;
+    m_hu[0](i_ix + 1, i_iy + 1) = i_hu;
   }
 
   /**
@@ -170,8 +1228,8 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
    * @param i_hu momentum in x-direction.
    **/
   void setMomentumY(t_idx i_ix, t_idx i_iy, t_real i_hv) {
-    m_hu[m_step][(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_hv;
-  };
+    m_hv[0](i_ix + 1, i_iy + 1) = i_hv;
+  }
 
   /**
    * Sets the bathymetry value to the cell given it's id.
@@ -181,9 +1239,35 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
    * @param i_b bathymetry value of the cell.
    **/
   void setBathymetry(t_idx i_ix, t_idx i_iy, t_real i_b) {
-    m_b[(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_b;
+    if (T_precision::m_relative) {
+      setPrecise(i_ix + 1, i_iy + 1, true, i_b);
+    } else {
+      m_b(i_ix + 1, i_iy + 1) = m_coding.encodeBathymetry(i_b);
+    }
+  }
+
+  /**
+   * Encodes the staged cells of relative heights and invalidates the wave
+   *speed, activity and bathymetry jumps derived from the cells. Has to be
+   *called once after the cells were set.
+   **/
+  void finishSetup() {
+    if (m_staging) encodeStaged();
+    m_speedMax = 0;
+    m_activityValid = false;
+    m_edgesValid = false;
   }
 
+  /**
+   * Sets the range of the bathymetry which is quantized if it is stored in an
+   *integral type, the bathymetry 0 is exact. Has to be called before the
+   *bathymetry is set.
+   *
+   * @param i_min minimum bathymetry.
+   * @param i_max maximum bathymetry.
+   **/
+  void setBathymetryRange(t_real i_min, t_real i_max);
+
   /**
    * Sets the ghost cells to reflecting or not.
    *
@@ -197,6 +1281,104 @@ class tsunami_lab::patches::WavePropagation2d : public WavePropagation {
     m_reflBoundR = i_reflR;
   }
 
+  /**
+   * Selects the sides whose ghost cells are set to outflow at the beginning
+   *of the time steps. The ghost cells of the other sides keep their values,
+   *e.g., the halos of a patch set by its neighbours.
+   *
+   * @param i_left true if the left ghost cells are outflow.
+   * @param i_right true if the right ghost cells are outflow.
+   * @param i_bottom true if the bottom ghost cells are outflow.
+   * @param i_top true if the top ghost cells are outflow.
+   **/
+  void setOutflow(bool i_left, bool i_right, bool i_bottom, bool i_top) {
+    m_outflow[0] = i_left;
+    m_outflow[1] = i_right;
+    m_outflow[2] = i_bottom;
+    m_outflow[3] = i_top;
+  }
+
+  /**
+   * Gets the maximum absolute wave speed of the last time step.
+   *
+   * @return maximum absolute wave speed, 0 if the quantities were set since.
+   **/
+  t_compute getSpeedMax() const { return m_speedMax; }
+
+  /**
+   * Derives the maximum absolute wave speed of all edges from the current
+   *quantities, e.g., for the first time step of several patches. Sets the
+   *ghost cells and classifies the edges beforehand.
+   *
+   * @return maximum absolute wave speed.
+   **/
+  t_compute deriveSpeedMax();
+
+  /**
+   * Copies the current quantities of a row including its ghost cells in
+   *x-direction to a row of another patch with the same number of cells in
+   *x-direction, e.g., to exchange halos.
+   *
+   * @param i_rowSrc row of this patch including the ghost rows.
+   * @param io_dst other patch.
+   * @param i_rowDst row of the other patch including the ghost rows.
+   * @param i_bathymetry true if the bathymetry is copied as well.
+   **/
+  void copyRowTo(t_idx i_rowSrc, WavePropagation2d &io_dst, t_idx i_rowDst,
+                 bool i_bathymetry) const;
+
+  /**
+   * Copies the current quantities of a block of cells to a buffer, e.g., to
+   *send halos to another process. The quantities are stored one after
+   *another, each one row by row.
+   *
+   * @param i_x first column of the block including the ghost columns.
+   * @param i_y first row of the block including the ghost rows.
+   * @param i_nx number of columns of the block.
+   * @param i_ny number of rows of the block.
+   * @param i_nQuantities 3: heights and momenta, 4: bathymetry as well, which
+   *is decoded.
+   * @param o_buffer will be set to the i_nQuantities * i_nx * i_ny values.
+   **/
+  void packCells(t_idx i_x, t_idx i_y, t_idx i_nx, t_idx i_ny,
+                 unsigned short i_nQuantities, t_store *o_buffer) const;
+
+  /**
+   * Copies a buffer of packCells to a block of cells, e.g., to receive halos
+   *from another process.
+   *
+   * @param i_x first column of the block including the ghost columns.
+   * @param i_y first row of the block including the ghost rows.
+   * @param i_nx number of columns of the block.
+   * @param i_ny number of rows of the block.
+   * @param i_nQuantities 3: heights and momenta, 4: bathymetry as well.
+   * @param i_buffer values of the block.
+   **/
+  void unpackCells(t_idx i_x, t_idx i_y, t_idx i_nx, t_idx i_ny,
+                   unsigned short i_nQuantities, t_store const *i_buffer);
+
+  /**
+   * Computes the x-sweep of a block of rows without making the result the
+   *current quantities, e.g., to sweep the interior rows while the halos are
+   *exchanged. The blocks of a time step have to cover all rows before
+   *completeStep. Classifies the edges beforehand if the bathymetry changed.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_rowFirst first row of the block including the ghost rows.
+   * @param i_rowLast row after the last row of the block.
+   * @return maximum absolute wave speed of the block.
+   **/
+  t_compute xSweepBlock(t_compute i_scaling, t_idx i_rowFirst, t_idx i_rowLast);
+
+  /**
+   * Makes the x-sweep of the blocks the current quantities and performs the
+   *y-sweep of the time step, which accumulates the extremes if enabled.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @return maximum absolute wave speed of the y-sweep.
+   **/
+  t_compute completeStep(t_compute i_scaling);
+
   void MemTransfer(){}
 };
 
@@ -28,8 +28,14 @@
  * @section DESCRIPTION
  * Two-dimensional wave propagation patch.
  **/
+#include <omp.h>
+
 #include <catch2/catch.hpp>
+#include <cmath>
+#include <type_traits>
+#include <vector>
 
+#include "../Arena.h"
 #include "WavePropagation2d.h"
 
 TEST_CASE("Test the 2d wave propagation solver in a steady State.",
@@ -54,7 +60,7 @@ TEST_CASE("Test the 2d wave propagation solver in a steady State.",
   // construct solver and setup a dambreak problem
   std::size_t l_xRows = 8;
   std::size_t l_yColums = 3;
-  tsunami_lab::patches::WavePropagation2d m_waveProp(l_xRows, l_yColums);
+  tsunami_lab::patches::WavePropagation2d<> m_waveProp(l_xRows, l_yColums);
   for (std::size_t l_ceY = 0; l_ceY < l_yColums; l_ceY++) {
     for (std::size_t l_ceX = 0; l_ceX < l_xRows; l_ceX++) {
       m_waveProp.setHeight(l_ceX, l_ceY, 10);
@@ -62,6 +68,7 @@ TEST_CASE("Test the 2d wave propagation solver in a steady State.",
       m_waveProp.setMomentumY(l_ceX, l_ceY, 0);
     }
   }
+  m_waveProp.finishSetup();
   
 
   // perform a time step
@@ -69,10 +76,11 @@ TEST_CASE("Test the 2d wave propagation solver in a steady State.",
 
   for (std::size_t l_ceY = 0; l_ceY < l_yColums; l_ceY++) {
     // steady state
-    for (std::size_t l_ce = 0; l_ce < l_xRows; l_ce++) {
-      REQUIRE(m_waveProp.getHeight()[l_ce + l_xRows * l_ceY] == Approx(10));
-      REQUIRE(m_waveProp.getMomentumX()[l_ce + l_xRows * l_ceY] == Approx(0));
-      REQUIRE(m_waveProp.getMomentumY()[l_ce + l_xRows * l_ceY] == Approx(0));
+    for (std::size_t l_ceX = 0; l_ceX < l_xRows; l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * m_waveProp.getStride();
+      REQUIRE(m_waveProp.getHeight()[l_ce] == Approx(10));
+      REQUIRE(m_waveProp.getMomentumX()[l_ce] == Approx(0));
+      REQUIRE(m_waveProp.getMomentumY()[l_ce] == Approx(0));
     }
   }
   /*
@@ -100,3 +108,1086 @@ TEST_CASE("Test the 2d wave propagation solver in a steady State.",
     }
     */
 }
+
+TEST_CASE("Test the 2d wave propagation solver for different thread counts.",
+          "[WaveProp2dThreads]") {
+  /*
+   * Test case:
+   *
+   *   Dam break with varying bathymetry and a dry island, the results have
+   *   to be bitwise identical for any number of threads.
+   */
+  std::size_t l_nx = 23;
+  std::size_t l_ny = 17;
+  std::vector<float> l_ref;
+  int l_maxThreads = omp_get_max_threads();
+
+  for (int l_nThreads = 1; l_nThreads < 8; l_nThreads += 2) {
+    omp_set_num_threads(l_nThreads);
+
+    tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        float l_b = -20 + (float)((l_ceX * 3 + l_ceY * 5) % 7);
+        if (l_ceX > 15 && l_ceY > 10) l_b = 5;
+        l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+        l_waveProp.setHeight(l_ceX, l_ceY,
+                             l_b < 0 ? -l_b + (l_ceX < 8 ? 2 : 0) : 0);
+        l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+        l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+      }
+    }
+    l_waveProp.finishSetup();
+
+    l_waveProp.timeStep(0.05, 5);
+    l_waveProp.timeStep(0.05, 5);
+
+    std::vector<float> l_res;
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+        l_res.push_back(l_waveProp.getHeight()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumX()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumY()[l_ce]);
+      }
+    }
+
+    if (l_nThreads == 1) {
+      l_ref = l_res;
+    } else {
+      REQUIRE(l_res == l_ref);
+    }
+  }
+  omp_set_num_threads(l_maxThreads);
+}
+
+TEST_CASE("Test the tiled 2d wave propagation solver.", "[WaveProp2dTiled]") {
+  /*
+   * Test case:
+   *
+   *   Dam break with varying bathymetry and a dry island, the tiled time steps
+   *   have to be bitwise identical to the sweeps for all tile sizes and
+   *   temporal blocking depths.
+   */
+  std::size_t l_nx = 37;
+  std::size_t l_ny = 29;
+  std::vector<float> l_ref;
+
+  std::size_t l_tiling[5][2] = {{0, 0}, {8, 1}, {8, 3}, {13, 4}, {64, 2}};
+
+  for (int l_ti = 0; l_ti < 5; l_ti++) {
+    tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        float l_b = -20 + (float)((l_ceX * 3 + l_ceY * 5) % 7);
+        if (l_ceX > 25 && l_ceY > 18) l_b = 5;
+        l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+        l_waveProp.setHeight(l_ceX, l_ceY,
+                             l_b < 0 ? -l_b + (l_ceX < 8 ? 2 : 0) : 0);
+        l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+        l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+      }
+    }
+    l_waveProp.finishSetup();
+
+    // the first configuration uses the sweeps
+    if (l_ti > 0) {
+      l_waveProp.setTiling(true, l_tiling[l_ti][0], l_tiling[l_ti][1]);
+    }
+
+    l_waveProp.timeStep(0.05, 7);
+    l_waveProp.timeStep(0.05, 5);
+
+    std::vector<float> l_res;
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+        l_res.push_back(l_waveProp.getHeight()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumX()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumY()[l_ce]);
+      }
+    }
+
+    if (l_ti == 0) {
+      l_ref = l_res;
+    } else {
+      REQUIRE(l_res == l_ref);
+    }
+  }
+}
+
+TEST_CASE("Test the adaptive temporal blocks of the tiled solver.",
+          "[WaveProp2dTiled]") {
+  /*
+   * Test case:
+   *
+   *   Sheet of water on a steep slope, the water accelerates and the wave
+   *   speed triples within eight time steps. A temporal block of eight
+   *   steps with the time step of its start violates the CFL condition, the
+   *   block is discarded and the steps are taken one by one, i.e., the result
+   *   is bitwise identical to the sweeps.
+   */
+  std::size_t l_nx = 40;
+  std::size_t l_ny = 12;
+  std::vector<float> l_ref;
+  float l_timeRef = 0;
+
+  for (int l_ti = 0; l_ti < 2; l_ti++) {
+    tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        l_waveProp.setBathymetry(l_ceX, l_ceY, -100 - (float)l_ceX);
+        l_waveProp.setHeight(l_ceX, l_ceY, 1);
+        l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+        l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+      }
+    }
+    l_waveProp.finishSetup();
+    if (l_ti == 1) l_waveProp.setTiling(true, 16, 8);
+
+    float l_time = l_waveProp.timeStepAdaptive(1, 8);
+
+    std::vector<float> l_res;
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+        l_res.push_back(l_waveProp.getHeight()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumX()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumY()[l_ce]);
+      }
+    }
+
+    if (l_ti == 0) {
+      l_ref = l_res;
+      l_timeRef = l_time;
+    } else {
+      REQUIRE(l_time == l_timeRef);
+      REQUIRE(l_res == l_ref);
+    }
+  }
+}
+
+TEST_CASE("Test the adaptive time steps of the 2d wave propagation solver.",
+          "[WaveProp2dAdaptive]") {
+  /*
+   * Test case:
+   *
+   *   Lake at rest with a depth of 10, the fastest waves travel with
+   *   sqrt(g * 10) and the time step is 0.5 * dxy / sqrt(g * 10). Afterwards
+   *   a dam break with faster waves and thus smaller time steps.
+   */
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(20, 10);
+  for (std::size_t l_ceY = 0; l_ceY < 10; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < 20; l_ceX++) {
+      l_waveProp.setBathymetry(l_ceX, l_ceY, -10);
+      l_waveProp.setHeight(l_ceX, l_ceY, 10);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+
+  float l_time = l_waveProp.timeStepAdaptive(100, 4);
+  REQUIRE(l_time == Approx(4 * 0.5 * 100 / std::sqrt(9.80665 * 10)));
+  REQUIRE(l_waveProp.getHeight()[5 + 5 * l_waveProp.getStride()] ==
+          Approx(10));
+
+  // dam break
+  for (std::size_t l_ceY = 0; l_ceY < 10; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < 10; l_ceX++) {
+      l_waveProp.setHeight(l_ceX, l_ceY, 20);
+    }
+  }
+  l_waveProp.finishSetup();
+
+  // the new quantities restrict the first time step already
+  float l_timeDam = l_waveProp.timeStepAdaptive(100, 1);
+  REQUIRE(l_timeDam < 0.5 * 100 / std::sqrt(9.80665 * 15));
+  REQUIRE(l_timeDam > 0.5 * 100 / std::sqrt(9.80665 * 20) / 2);
+
+  l_timeDam = l_waveProp.timeStepAdaptive(100, 1);
+  REQUIRE(l_timeDam < l_time / 4);
+}
+
+TEST_CASE("Test the activity tracking of the 2d wave propagation solver.",
+          "[WaveProp2dActivity]") {
+  /*
+   * Test case:
+   *
+   *   Lake at rest with a flat bottom and a hump of water in the middle. The
+   *   edges at rest have zero net-updates, thus skipping their tiles gives
+   *   bitwise identical results if no tolerance is used.
+   */
+  std::size_t l_nx = 60;
+  std::size_t l_ny = 50;
+  std::vector<float> l_ref;
+
+  for (int l_run = 0; l_run < 2; l_run++) {
+    tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        bool l_hump = l_ceX >= 28 && l_ceX < 32 && l_ceY >= 23 && l_ceY < 27;
+        l_waveProp.setBathymetry(l_ceX, l_ceY, -10);
+        l_waveProp.setHeight(l_ceX, l_ceY, l_hump ? 11 : 10);
+        l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+        l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+      }
+    }
+    l_waveProp.finishSetup();
+
+    if (l_run == 1) {
+      REQUIRE(l_waveProp.setActivityTracking(true, 8, 0));
+      REQUIRE(l_waveProp.getActiveFraction() == 1);
+
+      // the tiled execution is rejected together with the tracking
+      REQUIRE_FALSE(l_waveProp.setTiling(true, 16, 4));
+    }
+
+    l_waveProp.timeStep(0.05, 4);
+
+    // the wave did not reach the corners yet
+    if (l_run == 1) {
+      REQUIRE(l_waveProp.getActiveFraction() < 0.5);
+    }
+
+    l_waveProp.timeStep(0.05, 30);
+
+    std::vector<float> l_res;
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+        l_res.push_back(l_waveProp.getHeight()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumX()[l_ce]);
+        l_res.push_back(l_waveProp.getMomentumY()[l_ce]);
+      }
+    }
+
+    if (l_run == 0) {
+      l_ref = l_res;
+    } else {
+      REQUIRE(l_res == l_ref);
+    }
+  }
+}
+
+TEST_CASE("Test the unsplit 2d wave propagation solver.",
+          "[WaveProp2dUnsplit]") {
+  /*
+   * Test case 1:
+   *
+   *   Dam break without variation in y-direction. The y-edges do not
+   *   contribute, thus the unsplit scheme is bitwise identical to the split
+   *   one.
+   */
+  std::size_t l_nx = 31;
+  std::size_t l_ny = 9;
+  std::vector<float> l_res[2];
+
+  for (int l_sc = 0; l_sc < 2; l_sc++) {
+    tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        float l_b = -20 + (float)((l_ceX * 3) % 7);
+        if (l_ceX > 26) l_b = 5;
+        l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+        l_waveProp.setHeight(l_ceX, l_ceY,
+                             l_b < 0 ? -l_b + (l_ceX < 8 ? 2 : 0) : 0);
+        l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+        l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+      }
+    }
+    l_waveProp.finishSetup();
+    l_waveProp.setUnsplit(l_sc == 1);
+
+    l_waveProp.timeStep(0.05, 6);
+
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+        l_res[l_sc].push_back(l_waveProp.getHeight()[l_ce]);
+        l_res[l_sc].push_back(l_waveProp.getMomentumX()[l_ce]);
+        l_res[l_sc].push_back(l_waveProp.getMomentumY()[l_ce]);
+      }
+    }
+  }
+  REQUIRE(l_res[1] == l_res[0]);
+
+  /*
+   * Test case 2:
+   *
+   *   Hump in the center of a square lake. Other than the split scheme, the
+   *   unsplit one treats both directions alike, the solution stays
+   *   symmetric to the diagonal.
+   */
+  std::size_t l_n = 25;
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_n, l_n);
+  for (std::size_t l_ceY = 0; l_ceY < l_n; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_n; l_ceX++) {
+      float l_dX = l_ceX - 12.0f;
+      float l_dY = l_ceY - 12.0f;
+      l_waveProp.setBathymetry(l_ceX, l_ceY, -10);
+      l_waveProp.setHeight(l_ceX, l_ceY,
+                           10 + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 8));
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+  REQUIRE(l_waveProp.setUnsplit(true));
+
+  // the tiled execution and the tracking are rejected with the unsplit scheme
+  REQUIRE_FALSE(l_waveProp.setTiling(true));
+  REQUIRE_FALSE(l_waveProp.setActivityTracking(true));
+
+  // the ghost cells are reset in every step
+  for (int l_st = 0; l_st < 10; l_st++) l_waveProp.timeStepAdaptive(1, 1);
+
+  for (std::size_t l_ceY = 0; l_ceY < l_n; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_n; l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+      std::size_t l_ceT = l_ceY + l_ceX * l_waveProp.getStride();
+      REQUIRE(l_waveProp.getHeight()[l_ce] ==
+              Approx(l_waveProp.getHeight()[l_ceT]));
+      REQUIRE(l_waveProp.getMomentumX()[l_ce] ==
+              Approx(l_waveProp.getMomentumY()[l_ceT]).margin(1E-5));
+    }
+  }
+}
+
+TEST_CASE("Test the time steps in a persistent parallel region.",
+          "[WaveProp2dPersistent]") {
+  /*
+   * Test case:
+   *
+   *   Off-center hump on a sloped beach with dry cells. The stripes of the
+   *   persistent region only synchronize with their neighbours, the result
+   *   is bitwise identical to the sweeps for constant and adaptive time
+   *   steps, an odd number of steps and more threads than rows.
+   */
+  std::size_t l_sizes[2][2] = {{37, 23}, {11, 2}};
+
+  for (int l_si = 0; l_si < 2; l_si++) {
+    std::size_t l_nx = l_sizes[l_si][0];
+    std::size_t l_ny = l_sizes[l_si][1];
+    std::vector<float> l_res[2];
+    float l_time[2] = {0, 0};
+
+    for (int l_sc = 0; l_sc < 2; l_sc++) {
+      tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          float l_dX = l_ceX - 9.0f;
+          float l_dY = l_ceY - 7.0f;
+          float l_b = -15 + (float)l_ceX * 0.5f;
+          l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+          l_waveProp.setHeight(
+              l_ceX, l_ceY,
+              l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6)
+                      : 0);
+          l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+          l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+        }
+      }
+      l_waveProp.finishSetup();
+      REQUIRE(l_waveProp.setPersistent(l_sc == 1));
+      if (l_sc == 1) {
+        // the other modes are rejected with the persistent region
+        REQUIRE_FALSE(l_waveProp.setUnsplit(true));
+        REQUIRE_FALSE(l_waveProp.setTiling(true));
+        REQUIRE_FALSE(l_waveProp.setActivityTracking(true));
+      }
+
+      l_waveProp.timeStep(0.05, 3);
+      l_time[l_sc] += l_waveProp.timeStepAdaptive(1, 5);
+      l_time[l_sc] += l_waveProp.timeStepAdaptive(1, 4);
+
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+          l_res[l_sc].push_back(l_waveProp.getHeight()[l_ce]);
+          l_res[l_sc].push_back(l_waveProp.getMomentumX()[l_ce]);
+          l_res[l_sc].push_back(l_waveProp.getMomentumY()[l_ce]);
+        }
+      }
+    }
+    REQUIRE(l_time[1] == l_time[0]);
+    REQUIRE(l_res[1] == l_res[0]);
+  }
+}
+
+/**
+ * Advances an off-center hump on a sloped beach with dry cells.
+ *
+ * @param i_inPlace true for the in-place mode.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ * @param o_res will be set to the heights and momenta of all cells.
+ * @return simulated time of the adaptive time steps.
+ **/
+template <typename T_precision>
+static float beachInPlace(bool i_inPlace, std::size_t i_nx, std::size_t i_ny,
+                          std::vector<float> &o_res) {
+  tsunami_lab::patches::WavePropagation2d<T_precision> l_waveProp(
+      i_nx, i_ny, i_inPlace);
+  REQUIRE(l_waveProp.isInPlace() == i_inPlace);
+
+  // the other modes are rejected with the in-place sweeps
+  REQUIRE(l_waveProp.setUnsplit(true) == !i_inPlace);
+  REQUIRE(l_waveProp.setUnsplit(false));
+  REQUIRE(l_waveProp.setTiling(true) == !i_inPlace);
+  REQUIRE(l_waveProp.setTiling(false));
+  REQUIRE(l_waveProp.setActivityTracking(true) == !i_inPlace);
+  REQUIRE(l_waveProp.setActivityTracking(false));
+  REQUIRE(l_waveProp.setPersistent(true) == !i_inPlace);
+  REQUIRE(l_waveProp.setPersistent(false));
+  REQUIRE(l_waveProp.setBalancing(true) == !i_inPlace);
+  REQUIRE(l_waveProp.setBalancing(false));
+  for (std::size_t l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 7.0f;
+      float l_b = -15 + (float)l_ceX * 0.5f + (float)(l_ceY % 4);
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      l_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6) : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+
+  l_waveProp.timeStep(0.05, 3);
+  float l_time = l_waveProp.timeStepAdaptive(1, 5);
+  l_time += l_waveProp.timeStepAdaptive(1, 4);
+
+  o_res.clear();
+  for (std::size_t l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+      o_res.push_back(l_waveProp.getHeight()[l_ce]);
+      o_res.push_back(l_waveProp.getMomentumX()[l_ce]);
+      o_res.push_back(l_waveProp.getMomentumY()[l_ce]);
+    }
+  }
+  return l_time;
+}
+
+TEST_CASE("Test the in-place sweeps of a single buffer.",
+          "[WaveProp2dInPlace]") {
+  /*
+   * Test case:
+   *
+   *   Off-center hump on a sloped beach with dry cells. The in-place sweeps
+   *   buffer the first and last row of every block of rows, the result is
+   *   bitwise identical to the double-buffered sweeps for constant and
+   *   adaptive time steps, blocks of one, two and more rows, more threads
+   *   than rows and the 16-bit storage.
+   */
+  int l_maxThreads = omp_get_max_threads();
+  std::size_t l_sizes[3][2] = {{37, 23}, {11, 2}, {19, 9}};
+  int l_nThreads[3] = {1, 3, 7};
+
+  for (int l_si = 0; l_si < 3; l_si++) {
+    std::size_t l_nx = l_sizes[l_si][0];
+    std::size_t l_ny = l_sizes[l_si][1];
+    std::vector<float> l_ref;
+    std::vector<float> l_res;
+
+    float l_timeRef =
+        beachInPlace<tsunami_lab::precision::Float>(false, l_nx, l_ny, l_ref);
+    for (int l_th = 0; l_th < 3; l_th++) {
+      omp_set_num_threads(l_nThreads[l_th]);
+      float l_time =
+          beachInPlace<tsunami_lab::precision::Float>(true, l_nx, l_ny, l_res);
+      REQUIRE(l_time == l_timeRef);
+      REQUIRE(l_res == l_ref);
+    }
+    omp_set_num_threads(l_maxThreads);
+
+    l_timeRef =
+        beachInPlace<tsunami_lab::precision::Fp16>(false, l_nx, l_ny, l_ref);
+    float l_time =
+        beachInPlace<tsunami_lab::precision::Fp16>(true, l_nx, l_ny, l_res);
+    REQUIRE(l_time == l_timeRef);
+    REQUIRE(l_res == l_ref);
+  }
+}
+
+TEST_CASE("Test the balancing of the rows by their cost.",
+          "[WaveProp2dBalance]") {
+  /*
+   * Test case:
+   *
+   *   Coast whose upper half is dry land. The chunks of the balanced sweeps
+   *   are claimed in any order, the result is bitwise identical to the
+   *   static blocks of rows for the split and the unsplit scheme.
+   */
+  std::size_t l_nx = 29;
+  std::size_t l_ny = 41;
+
+  for (int l_un = 0; l_un < 2; l_un++) {
+    std::vector<float> l_res[2];
+
+    for (int l_sc = 0; l_sc < 2; l_sc++) {
+      tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          float l_dX = l_ceX - 14.0f;
+          float l_dY = l_ceY - 8.0f;
+          float l_b = (l_ceY > 20) ? 5 : -10 + (float)l_ceY * 0.25f;
+          l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+          l_waveProp.setHeight(
+              l_ceX, l_ceY,
+              l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 10)
+                      : 0);
+          l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+          l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+        }
+      }
+      l_waveProp.finishSetup();
+      l_waveProp.setUnsplit(l_un == 1);
+      REQUIRE(l_waveProp.setBalancing(l_sc == 1));
+      if (l_sc == 1) {
+        // the modes without balanced rows are rejected
+        REQUIRE_FALSE(l_waveProp.setPersistent(true));
+        REQUIRE_FALSE(l_waveProp.setTiling(true));
+        REQUIRE_FALSE(l_waveProp.setActivityTracking(true));
+      }
+
+      l_waveProp.timeStepAdaptive(1, 7);
+      REQUIRE(l_waveProp.getLoadImbalance() >= 0);
+
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+          l_res[l_sc].push_back(l_waveProp.getHeight()[l_ce]);
+          l_res[l_sc].push_back(l_waveProp.getMomentumX()[l_ce]);
+          l_res[l_sc].push_back(l_waveProp.getMomentumY()[l_ce]);
+        }
+      }
+    }
+    REQUIRE(l_res[1] == l_res[0]);
+  }
+}
+
+/**
+ * Sets up a beach with a Gaussian hump, performs adaptive time steps and
+ *gathers the heights and momenta.
+ *
+ * @param i_unsplit true for the unsplit scheme.
+ * @param o_res will be set to the heights and momenta of all cells.
+ * @return simulated time.
+ **/
+template <typename T_precision>
+static float beachPrecision(bool i_unsplit, std::vector<float> &o_res) {
+  std::size_t l_nx = 37;
+  std::size_t l_ny = 19;
+
+  tsunami_lab::patches::WavePropagation2d<T_precision> l_waveProp(l_nx, l_ny);
+  l_waveProp.setBathymetryRange(-15, 3);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 9.0f;
+      float l_b = -15 + (float)l_ceX * 0.5f;
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      l_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6) : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+  l_waveProp.setUnsplit(i_unsplit);
+
+  float l_time = l_waveProp.timeStepAdaptive(1, 20);
+
+  o_res.clear();
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+      o_res.push_back(l_waveProp.getHeight()[l_ce]);
+      o_res.push_back(l_waveProp.getMomentumX()[l_ce]);
+      o_res.push_back(l_waveProp.getMomentumY()[l_ce]);
+    }
+  }
+  return l_time;
+}
+
+TEST_CASE("Test the precision policies of the 2d wave propagation solver.",
+          "[WaveProp2dPrecision]") {
+  /*
+   * Test case:
+   *
+   *   Gaussian hump in front of a beach, whose rows are padded differently in
+   *   float and double. Double precision and the mixed policy only deviate
+   *   from float by rounding; the default policy is float.
+   */
+  REQUIRE(std::is_same<tsunami_lab::patches::WavePropagation2d<>,
+                       tsunami_lab::patches::WavePropagation2d<
+                           tsunami_lab::precision::Float> >::value);
+
+  // the factory constructs the policies by their names
+  tsunami_lab::patches::WavePropagation2dBase *l_patch =
+      tsunami_lab::patches::WavePropagation2dBase::create("float", 5, 3, false);
+  REQUIRE(dynamic_cast<tsunami_lab::patches::WavePropagation2d<
+              tsunami_lab::precision::Float> *>(l_patch) != nullptr);
+  delete l_patch;
+  l_patch =
+      tsunami_lab::patches::WavePropagation2dBase::create("bf16", 5, 3, true);
+  REQUIRE(dynamic_cast<tsunami_lab::patches::WavePropagation2d<
+              tsunami_lab::precision::Bf16> *>(l_patch) != nullptr);
+  REQUIRE(dynamic_cast<tsunami_lab::patches::WavePropagation2d<
+              tsunami_lab::precision::Bf16> *>(l_patch)
+              ->isInPlace());
+  delete l_patch;
+  REQUIRE(tsunami_lab::patches::WavePropagation2dBase::create(
+              "half", 5, 3, false) == nullptr);
+
+  for (int l_un = 0; l_un < 2; l_un++) {
+    std::vector<float> l_res[3];
+    float l_time[3];
+    l_time[0] = beachPrecision<tsunami_lab::precision::Float>(l_un == 1,
+                                                              l_res[0]);
+    l_time[1] = beachPrecision<tsunami_lab::precision::Double>(l_un == 1,
+                                                               l_res[1]);
+    l_time[2] = beachPrecision<tsunami_lab::precision::Mixed>(l_un == 1,
+                                                              l_res[2]);
+
+    for (int l_pr = 1; l_pr < 3; l_pr++) {
+      REQUIRE(l_time[l_pr] == Approx(l_time[0]).epsilon(1E-4));
+      REQUIRE(l_res[l_pr].size() == l_res[0].size());
+      for (std::size_t l_va = 0; l_va < l_res[0].size(); l_va++) {
+        REQUIRE(l_res[l_pr][l_va] == Approx(l_res[0][l_va]).margin(1E-3));
+      }
+    }
+  }
+}
+
+TEST_CASE("Test the 16-bit storage of the 2d wave propagation solver.",
+          "[WaveProp2dCompact]") {
+  /*
+   * Test case:
+   *
+   *   The Gaussian hump of the precision policies with heights relative to
+   *   the still-water level in half precision and brain floating point
+   *   numbers, and quantized bathymetry. The waves keep about three and two
+   *   significant digits.
+   */
+  for (int l_un = 0; l_un < 2; l_un++) {
+    std::vector<float> l_res[3];
+    float l_time[3];
+    l_time[0] = beachPrecision<tsunami_lab::precision::Float>(l_un == 1,
+                                                              l_res[0]);
+    l_time[1] = beachPrecision<tsunami_lab::precision::Fp16>(l_un == 1,
+                                                             l_res[1]);
+    l_time[2] = beachPrecision<tsunami_lab::precision::Bf16>(l_un == 1,
+                                                             l_res[2]);
+
+    float l_margin[3] = {0, 2E-3, 2E-2};
+    for (int l_pr = 1; l_pr < 3; l_pr++) {
+      REQUIRE(l_time[l_pr] == Approx(l_time[0]).epsilon(1E-4));
+      REQUIRE(l_res[l_pr].size() == l_res[0].size());
+      for (std::size_t l_va = 0; l_va < l_res[0].size(); l_va++) {
+        REQUIRE(l_res[l_pr][l_va] ==
+                Approx(l_res[0][l_va]).margin(l_margin[l_pr]));
+      }
+    }
+  }
+
+  /*
+   * Test case:
+   *
+   *   Lake at rest above a rough bathymetry in [-4000, 1000], which is set
+   *   after the heights. The quantized bathymetry deviates by at most half a
+   *   unit of 5000 / 65532, but the sea surface stays at rest. The momenta
+   *   are as small as in single precision.
+   */
+  std::size_t l_nx = 23;
+  std::size_t l_ny = 11;
+  tsunami_lab::patches::WavePropagation2d<tsunami_lab::precision::Fp16>
+      l_waveProp(l_nx, l_ny);
+  l_waveProp.setBathymetryRange(-4000, 1000);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      float l_b = -4000 + 200.3f * l_ceX + 31.7f * l_ceY;
+      l_waveProp.setHeight(l_ceX, l_ceY, l_b < 0 ? -l_b : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+    }
+  }
+  l_waveProp.finishSetup();
+  l_waveProp.timeStepAdaptive(1000, 10);
+
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+      float l_b = -4000 + 200.3f * l_ceX + 31.7f * l_ceY;
+      float l_h = l_waveProp.getHeight()[l_ce];
+
+      REQUIRE(l_waveProp.getBathymetry()[l_ce] ==
+              Approx(l_b).margin(5000.0 / 65532 / 2));
+      if (l_b < 0) {
+        REQUIRE(l_h + l_waveProp.getBathymetry()[l_ce] ==
+                Approx(0).margin(1E-3));
+      } else {
+        REQUIRE(l_h == 0);
+      }
+      REQUIRE(l_waveProp.getMomentumX()[l_ce] == Approx(0).margin(5E-2));
+      REQUIRE(l_waveProp.getMomentumY()[l_ce] == Approx(0).margin(5E-2));
+    }
+  }
+}
+
+TEST_CASE("Test the rows of the output of relative heights.",
+          "[WaveProp2dRows]") {
+  /*
+   * Test case:
+   *
+   *   Hump of relative heights in half precision above a sloped bathymetry.
+   *   The rows of the output are decoded into the buffer of a row, thus the
+   *   peak footprint of the setup, the time steps and the output is about 24
+   *   bytes per cell: two buffers of the heights and momenta and the
+   *   bathymetry at 2 bytes, the edge types at 2 bytes and the bathymetry
+   *   jumps at 8 bytes. The rows match the decoded grids of the getters.
+   */
+  std::size_t l_nx = 400;
+  std::size_t l_ny = 200;
+  std::size_t l_nCells = (l_nx + 2) * (l_ny + 2);
+
+  tsunami_lab::Arena l_arena(64 << 20);
+  tsunami_lab::Arena::setGlobal(&l_arena);
+  {
+    tsunami_lab::patches::WavePropagation2d<tsunami_lab::precision::Fp16>
+        l_waveProp(l_nx, l_ny);
+#pragma omp parallel for
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        float l_b = -100 + 0.2f * l_ceX;
+        float l_dX = l_ceX - 100.0f;
+        float l_dY = l_ceY - 100.0f;
+        float l_h = -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 200);
+        l_waveProp.setHeight(l_ceX, l_ceY, l_h);
+        l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+        l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+        l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      }
+    }
+    l_waveProp.finishSetup();
+    l_waveProp.timeStepAdaptive(10, 4);
+
+    std::vector<std::vector<float>> l_rows(4);
+    for (unsigned short l_qu = 0; l_qu < 4; l_qu++) {
+      l_rows[l_qu].resize(l_nx * l_ny);
+#pragma omp parallel
+      {
+        std::vector<float> l_buffer(l_nx);
+#pragma omp for
+        for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+          float const *l_row =
+              l_waveProp.getRow(l_qu, l_ceY, l_buffer.data());
+          std::copy(l_row, l_row + l_nx, l_rows[l_qu].data() + l_ceY * l_nx);
+        }
+      }
+    }
+
+    // small blocks, queues and padding of the rows are below 2 bytes
+    REQUIRE(l_arena.getPeak() <= 26 * l_nCells);
+
+    float const *l_q[4] = {l_waveProp.getHeight(), l_waveProp.getMomentumX(),
+                           l_waveProp.getMomentumY(),
+                           l_waveProp.getBathymetry()};
+    for (unsigned short l_qu = 0; l_qu < 4; l_qu++) {
+      for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+        for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+          REQUIRE(l_rows[l_qu][l_ceX + l_ceY * l_nx] ==
+                  l_q[l_qu][l_ceX + l_ceY * l_waveProp.getStride()]);
+        }
+      }
+    }
+    REQUIRE(l_rows[0][100 + 100 * l_nx] > 80.5f);
+  }
+  tsunami_lab::Arena::setGlobal(nullptr);
+}
+
+/**
+ * Advances an off-center hump on a sloped beach with dry cells and
+ *accumulates the extremes of the cells.
+ *
+ * @param i_mode 0: sweeps, 1: in-place sweeps, 2: persistent region, 3:
+ *unsplit scheme.
+ * @param o_res will be set to the extremes of all cells.
+ * @return simulated time of the adaptive time steps.
+ **/
+static float beachExtremes(int i_mode, std::vector<float> &o_res) {
+  std::size_t l_nx = 31;
+  std::size_t l_ny = 17;
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny,
+                                                       i_mode == 1);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 7.0f;
+      float l_b = -15 + (float)l_ceX * 0.5f + (float)(l_ceY % 4);
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      l_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6) : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+  l_waveProp.setPersistent(i_mode == 2);
+  l_waveProp.setUnsplit(i_mode == 3);
+  l_waveProp.setExtremes(true, 0.05f, 2);
+
+  l_waveProp.timeStep(0.05, 3);
+  float l_time = l_waveProp.timeStepAdaptive(2, 5);
+  l_time += l_waveProp.timeStepAdaptive(2, 4);
+
+  o_res.clear();
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+      o_res.push_back(l_waveProp.getMaxAmplitude()[l_ce]);
+      o_res.push_back(l_waveProp.getMaxVelocity()[l_ce]);
+      o_res.push_back(l_waveProp.getArrivalTime()[l_ce]);
+    }
+  }
+  return l_time;
+}
+
+/**
+ * Advances the off-center hump on the sloped beach of the extremes and
+ *samples four stations into a ring buffer of four records.
+ *
+ * @param i_mode 0: sweeps, 1: in-place sweeps, 2: persistent region.
+ * @param o_records will be set to the records taken after every call of the
+ *time steps.
+ * @return number of dropped records.
+ **/
+static std::size_t beachStations(int i_mode, std::vector<float> &o_records) {
+  std::size_t l_nx = 31;
+  std::size_t l_ny = 17;
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny,
+                                                       i_mode == 1);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 7.0f;
+      float l_b = -15 + (float)l_ceX * 0.5f + (float)(l_ceY % 4);
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      l_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6) : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+  l_waveProp.setPersistent(i_mode == 2);
+  std::size_t l_ix[4] = {9, 0, 30, 12};
+  std::size_t l_iy[4] = {7, 0, 16, 3};
+  l_waveProp.setStations(4, l_ix, l_iy, 4);
+
+  o_records.clear();
+  l_waveProp.timeStep(0.05, 3);
+  l_waveProp.getStationRecords(o_records);
+  l_waveProp.timeStepAdaptive(2, 5);
+  l_waveProp.getStationRecords(o_records);
+  l_waveProp.timeStepAdaptive(2, 4);
+  l_waveProp.getStationRecords(o_records);
+
+  return l_waveProp.getStationsDropped();
+}
+
+TEST_CASE("Test the extremes of the cells.", "[WaveProp2dExtremes]") {
+  /*
+   * Test case:
+   *
+   *   Off-center hump on a sloped beach with dry cells, advanced by single
+   *   constant time steps. After every step, the extremes match the ones
+   *   derived from the quantities of the getters: the maximum absolute sea
+   *   surface height and velocity of the wet cells and the first time at
+   *   which the sea surface deviates by at least 0.05 from zero.
+   */
+  std::size_t l_nx = 31;
+  std::size_t l_ny = 17;
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 7.0f;
+      float l_b = -15 + (float)l_ceX * 0.5f + (float)(l_ceY % 4);
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      l_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6) : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+  l_waveProp.setExtremes(true, 0.05f, 2);
+
+  std::size_t l_nCells = l_nx * l_ny;
+  std::vector<float> l_ampMax(l_nCells, 0);
+  std::vector<float> l_velMax(l_nCells, 0);
+  std::vector<float> l_arrival(l_nCells, -1);
+  std::size_t l_nArrived = 0;
+
+  for (int l_st = 1; l_st <= 12; l_st++) {
+    l_waveProp.timeStep(0.05, 1);
+
+    for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        std::size_t l_ce = l_ceX + l_ceY * l_waveProp.getStride();
+        std::size_t l_id = l_ceX + l_ceY * l_nx;
+        float l_h = l_waveProp.getHeight()[l_ce];
+        float l_hu = l_waveProp.getMomentumX()[l_ce];
+        float l_hv = l_waveProp.getMomentumY()[l_ce];
+        float l_b = l_waveProp.getBathymetry()[l_ce];
+
+        if (l_h >= 0.01f) {
+          float l_amp = std::abs(l_h + l_b);
+          l_ampMax[l_id] = std::max(l_ampMax[l_id], l_amp);
+          l_velMax[l_id] = std::max(l_velMax[l_id],
+                                    std::sqrt(l_hu * l_hu + l_hv * l_hv) / l_h);
+          if (l_arrival[l_id] < 0 && l_amp >= 0.05f) {
+            l_arrival[l_id] = l_st * 0.05f * 2;
+          }
+        }
+
+        REQUIRE(l_waveProp.getMaxAmplitude()[l_ce] ==
+                Approx(l_ampMax[l_id]));
+        REQUIRE(l_waveProp.getMaxVelocity()[l_ce] == Approx(l_velMax[l_id]));
+        REQUIRE(l_waveProp.getArrivalTime()[l_ce] == Approx(l_arrival[l_id]));
+      }
+    }
+  }
+
+  // the wave arrived at the hump first, but not at the far end
+  for (std::size_t l_id = 0; l_id < l_nCells; l_id++) {
+    if (l_arrival[l_id] >= 0) l_nArrived++;
+  }
+  REQUIRE(l_arrival[9 + 7 * l_nx] == Approx(0.1));
+  REQUIRE(l_nArrived > 0);
+  REQUIRE(l_nArrived < l_nCells);
+
+  // the output gathers the extremes row by row
+  std::vector<float> l_row(l_nx);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    float const *l_extremes[3] = {l_waveProp.getMaxAmplitude(),
+                                  l_waveProp.getMaxVelocity(),
+                                  l_waveProp.getArrivalTime()};
+    for (unsigned short l_ex = 0; l_ex < 3; l_ex++) {
+      float const *l_values = l_waveProp.getRow(4 + l_ex, l_ceY, l_row.data());
+      for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+        REQUIRE(l_values[l_ceX] ==
+                l_extremes[l_ex][l_ceX + l_ceY * l_waveProp.getStride()]);
+      }
+    }
+  }
+
+  /*
+   * Test case:
+   *
+   *   The same beach with constant and adaptive time steps. The extremes
+   *   accumulated by the y-sweep of the split scheme are bitwise identical
+   *   to the ones of the persistent region and of the traversal after the
+   *   in-place sweeps. The unsplit scheme has similar extremes.
+   */
+  std::vector<float> l_res[4];
+  float l_time[4];
+  for (int l_mo = 0; l_mo < 4; l_mo++) {
+    l_time[l_mo] = beachExtremes(l_mo, l_res[l_mo]);
+  }
+  REQUIRE(l_time[1] == l_time[0]);
+  REQUIRE(l_time[2] == l_time[0]);
+  REQUIRE(l_res[1] == l_res[0]);
+  REQUIRE(l_res[2] == l_res[0]);
+
+  REQUIRE(l_res[3].size() == l_res[0].size());
+  for (std::size_t l_va = 0; l_va < l_res[0].size(); l_va += 3) {
+    REQUIRE(l_res[3][l_va] == Approx(l_res[0][l_va]).margin(5E-2));
+  }
+}
+
+TEST_CASE("Test the sampling of the stations.", "[WaveProp2dStations]") {
+  /*
+   * Test case:
+   *
+   *   Off-center hump on a sloped beach, advanced by single constant time
+   *   steps. After every step, the single record holds the simulated time
+   *   and the quantities of the getters at the cells of the stations.
+   */
+  std::size_t l_nx = 31;
+  std::size_t l_ny = 17;
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nx, l_ny);
+  for (std::size_t l_ceY = 0; l_ceY < l_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 7.0f;
+      float l_b = -15 + (float)l_ceX * 0.5f + (float)(l_ceY % 4);
+      l_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      l_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 6) : 0);
+      l_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      l_waveProp.setMomentumY(l_ceX, l_ceY, 0);
+    }
+  }
+  l_waveProp.finishSetup();
+  std::size_t l_ix[3] = {9, 0, 30};
+  std::size_t l_iy[3] = {7, 16, 2};
+  l_waveProp.setStations(3, l_ix, l_iy, 4);
+
+  std::vector<float> l_records;
+  for (int l_st = 1; l_st <= 6; l_st++) {
+    l_waveProp.timeStep(0.05, 1);
+
+    l_records.clear();
+    l_waveProp.getStationRecords(l_records);
+    REQUIRE(l_records.size() == 10);
+    REQUIRE(l_records[0] == Approx(l_st * 0.05));
+
+    for (std::size_t l_sn = 0; l_sn < 3; l_sn++) {
+      std::size_t l_ce = l_ix[l_sn] + l_iy[l_sn] * l_waveProp.getStride();
+      REQUIRE(l_records[1 + l_sn] == l_waveProp.getHeight()[l_ce]);
+      REQUIRE(l_records[4 + l_sn] == l_waveProp.getMomentumX()[l_ce]);
+      REQUIRE(l_records[7 + l_sn] == l_waveProp.getMomentumY()[l_ce]);
+    }
+  }
+
+  // a drained buffer has no records
+  l_records.clear();
+  l_waveProp.getStationRecords(l_records);
+  REQUIRE(l_records.empty());
+  REQUIRE(l_waveProp.getStationsDropped() == 0);
+
+  /*
+   * Test case:
+   *
+   *   The same beach with constant and adaptive time steps, the five steps
+   *   of the second call overflow the ring buffer of four records. The
+   *   records of the sweeps are bitwise identical to the ones of the
+   *   in-place sweeps and of the persistent region.
+   */
+  std::vector<float> l_res[3];
+  for (int l_mo = 0; l_mo < 3; l_mo++) {
+    REQUIRE(beachStations(l_mo, l_res[l_mo]) == 1);
+  }
+  REQUIRE(l_res[0].size() == 11 * 13);
+  REQUIRE(l_res[1] == l_res[0]);
+  REQUIRE(l_res[2] == l_res[0]);
+
+  // the simulated times of the records increase
+  REQUIRE(l_res[0][0] == Approx(0.05));
+  for (std::size_t l_re = 1; l_re < 11; l_re++) {
+    REQUIRE(l_res[0][l_re * 13] > l_res[0][(l_re - 1) * 13]);
+  }
+}
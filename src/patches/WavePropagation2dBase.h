@@ -0,0 +1,176 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Interface of the two-dimensional wave propagation patch, independent of
+ *its precision policy.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D_BASE
+#define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D_BASE
+
+#include <string>
+#include <vector>
+
+#include "WavePropagation.h"
+
+namespace tsunami_lab {
+namespace patches {
+class WavePropagation2dBase;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Interface of the two-dimensional wave propagation patch. Gives access to
+ *the execution modes of the patch without knowing its precision policy, see
+ *WavePropagation2d for the documentation of the methods. The default
+ *arguments match the ones of WavePropagation2d.
+ **/
+class tsunami_lab::patches::WavePropagation2dBase : public WavePropagation {
+ public:
+  /**
+   * Constructs the patch with the given precision policy.
+   *
+   * @param i_precision name of the precision policy: "float", "double",
+   *"mixed", "fp16" or "bf16".
+   * @param i_xCells number of cells in x-direction.
+   * @param i_yCells number of cells in y-direction.
+   * @param i_inPlace true if the heights and momenta are updated in place.
+   * @return patch, nullptr if the precision policy is unknown.
+   **/
+  static WavePropagation2dBase *create(std::string const &i_precision,
+                                       t_idx i_xCells, t_idx i_yCells,
+                                       bool i_inPlace);
+
+  /**
+   * Sets the range of the bathymetry which is quantized if it is stored in an
+   *integral type.
+   *
+   * @param i_min minimum bathymetry.
+   * @param i_max maximum bathymetry.
+   **/
+  virtual void setBathymetryRange(t_real i_min, t_real i_max) = 0;
+
+  /**
+   * Selects the unsplit scheme.
+   *
+   * @param i_unsplit true for the unsplit scheme.
+   * @return false if the unsplit scheme was rejected.
+   **/
+  virtual bool setUnsplit(bool i_unsplit) = 0;
+
+  /**
+   * Selects the persistent parallel region of the split scheme.
+   *
+   * @param i_persistent true for the persistent parallel region.
+   * @return false if the persistent region was rejected.
+   **/
+  virtual bool setPersistent(bool i_persistent) = 0;
+
+  /**
+   * Enables or disables the tiled execution with temporal blocking.
+   *
+   * @param i_tiled true if the time steps are computed tile by tile.
+   * @param i_tileSize number of cells of a tile in each direction, 0 derives
+   *it.
+   * @param i_depth number of time steps a tile advances at once, 0 derives it.
+   * @return false if the tiled execution was rejected.
+   **/
+  virtual bool setTiling(bool i_tiled, t_idx i_tileSize = 0,
+                         t_idx i_depth = 0) = 0;
+
+  /**
+   * Derives the tile size and the number of time steps a tile advances at
+   *once.
+   *
+   * @param i_computeSteps number of time steps per call of timeStep.
+   * @param o_tileSize will be set to the tile size.
+   * @param o_depth will be set to the time steps a tile advances at once.
+   **/
+  virtual void deriveTiling(t_idx i_computeSteps, t_idx &o_tileSize,
+                            t_idx &o_depth) const = 0;
+
+  /**
+   * Enables or disables the tracking of active tiles.
+   *
+   * @param i_enabled true if tiles at rest are skipped.
+   * @param i_tileSize number of cells of a tile in each direction.
+   * @param i_tolerance tolerance of the cells at rest.
+   * @return false if the tracking was rejected.
+   **/
+  virtual bool setActivityTracking(bool i_enabled, t_idx i_tileSize = 64,
+                                   t_real i_tolerance = 1E-3) = 0;
+
+  /**
+   * Gets the fraction of active tiles.
+   *
+   * @return fraction of active tiles, 1 if the tracking is disabled.
+   **/
+  virtual t_real getActiveFraction() const = 0;
+
+  /**
+   * Enables or disables the balancing of the rows.
+   *
+   * @param i_balanced true if the rows are balanced.
+   * @return false if the balancing was rejected.
+   **/
+  virtual bool setBalancing(bool i_balanced) = 0;
+
+  /**
+   * Gets the load imbalance of the sweeps of the last call of timeStep or
+   *timeStepAdaptive.
+   *
+   * @return busy time of the slowest thread relative to the mean, minus one.
+   **/
+  virtual double getLoadImbalance() const = 0;
+
+  /**
+   * Sets the cells sampled after every time step.
+   *
+   * @param i_nStations number of stations, 0 disables the sampling.
+   * @param i_ix ids of the cells of the stations in x-direction.
+   * @param i_iy ids of the cells of the stations in y-direction.
+   * @param i_capacity number of records of the ring buffer.
+   **/
+  virtual void setStations(t_idx i_nStations, t_idx const *i_ix,
+                           t_idx const *i_iy, t_idx i_capacity) = 0;
+
+  /**
+   * Appends the records of the stations since the last call, oldest first.
+   *
+   * @param io_records records are appended to.
+   **/
+  virtual void getStationRecords(std::vector<t_real> &io_records) = 0;
+
+  /**
+   * Gets the number of records of the stations which were dropped.
+   *
+   * @return number of records.
+   **/
+  virtual t_idx getStationsDropped() const = 0;
+};
+
+#endif
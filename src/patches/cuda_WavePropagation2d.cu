@@ -21,22 +21,13 @@ tsunami_lab::patches::cuda_WavePropagation2d::cuda_WavePropagation2d(
   m_blockspergrid_y = std::ceil((m_yCells + 2) / 16.0);
 
   size = (m_xCells + 2) * (m_yCells + 2);
-  // allocate memory including ghostcells on each side
-  m_h = (float *)malloc(size * sizeof(float));
-  m_hu = (float *)malloc(size * sizeof(float));
-  m_hv = (float *)malloc(size * sizeof(float));
-  m_b = (float *)malloc(size * sizeof(float));
-
-  // init to zero
-  for (unsigned long l_ceY = 0; l_ceY < (m_yCells + 2); l_ceY++) {
-    for (unsigned long l_ceX = 0; l_ceX < (m_xCells + 2); l_ceX++) {
-      unsigned long l_ce = l_ceX + l_ceY * (m_xCells + 2);
-      m_b[l_ce] = 0;
-      m_h[l_ce] = 0;
-      m_hu[l_ce] = 0;
-      m_hv[l_ce] = 0;
-    }
-  }
+  // allocate memory including ghostcells on each side, the grids are
+  // initialized to zero; the rows are not padded since the kernels assume the
+  // stride of the device arrays
+  m_h = Grid2d<t_real>(m_xCells, m_yCells, 1, m_xCells + 2);
+  m_hu = Grid2d<t_real>(m_xCells, m_yCells, 1, m_xCells + 2);
+  m_hv = Grid2d<t_real>(m_xCells, m_yCells, 1, m_xCells + 2);
+  m_b = Grid2d<t_real>(m_xCells, m_yCells, 1, m_xCells + 2);
 
   // allocate memory on GPU
   cudaMalloc((void **)&h_dev, size * sizeof(float));
@@ -47,6 +38,9 @@ tsunami_lab::patches::cuda_WavePropagation2d::cuda_WavePropagation2d(
   cudaMalloc((void **)&mom_dev_UpdateR, size * sizeof(float));
   cudaMalloc((void **)&hv_dev, size * sizeof(float));
   cudaMalloc((void **)&b_dev, size * sizeof(float));
+  cudaMalloc((void **)&speedMax_dev, sizeof(unsigned int));
+  cudaMalloc((void **)&scaling_dev, sizeof(float));
+  cudaMalloc((void **)&time_dev, sizeof(float));
 
   dim3 threadsPerBlock(16, 16);
 
@@ -58,12 +52,6 @@ tsunami_lab::patches::cuda_WavePropagation2d::cuda_WavePropagation2d(
 }
 
 tsunami_lab::patches::cuda_WavePropagation2d::~cuda_WavePropagation2d() {
-  // free memory on CPU
-  free(m_h);
-  free(m_hu);
-  free(m_hv);
-  free(m_b);
-
   // free memory on GPU
   cudaFree(h_dev);
   cudaFree(h_dev_UpdateR);
@@ -73,15 +61,63 @@ tsunami_lab::patches::cuda_WavePropagation2d::~cuda_WavePropagation2d() {
   cudaFree(mom_dev_UpdateL);
   cudaFree(hv_dev);
   cudaFree(b_dev);
+  cudaFree(speedMax_dev);
+  cudaFree(scaling_dev);
+  cudaFree(time_dev);
 }
 void tsunami_lab::patches::cuda_WavePropagation2d::MemTransfer() {
-  cudaMemcpy(h_dev, m_h, size * sizeof(float), cudaMemcpyHostToDevice);
-  cudaMemcpy(hu_dev, m_hu, size * sizeof(float), cudaMemcpyHostToDevice);
-  cudaMemcpy(hv_dev, m_hv, size * sizeof(float), cudaMemcpyHostToDevice);
-  cudaMemcpy(b_dev, m_b, size * sizeof(float), cudaMemcpyHostToDevice);
+  cudaMemcpy(h_dev, m_h.data(), size * sizeof(float), cudaMemcpyHostToDevice);
+  cudaMemcpy(hu_dev, m_hu.data(), size * sizeof(float), cudaMemcpyHostToDevice);
+  cudaMemcpy(hv_dev, m_hv.data(), size * sizeof(float), cudaMemcpyHostToDevice);
+  cudaMemcpy(b_dev, m_b.data(), size * sizeof(float), cudaMemcpyHostToDevice);
 }
 void tsunami_lab::patches::cuda_WavePropagation2d::timeStep(
     t_real i_scaling, t_idx i_computeSteps) {
+  cudaMemcpy(scaling_dev, &i_scaling, sizeof(float), cudaMemcpyHostToDevice);
+
+  steps(i_computeSteps, false, 0);
+}
+
+tsunami_lab::t_real
+tsunami_lab::patches::cuda_WavePropagation2d::timeStepAdaptive(
+    t_real i_dxy, t_idx i_computeSteps) {
+  t_idx l_nx = m_xCells + 2;
+  t_idx l_ny = m_yCells + 2;
+
+  dim3 threadsPerBlock(16, 16);
+  dim3 BlocksPerGrid(m_blockspergrid_x, m_blockspergrid_y);
+
+  // the first time step has no wave speeds of a previous one, the edges are
+  // evaluated with a zero time step
+  if (!m_speedInit) {
+    float l_zero = 0;
+    cudaMemcpy(scaling_dev, &l_zero, sizeof(float), cudaMemcpyHostToDevice);
+    cudaMemset(speedMax_dev, 0, sizeof(unsigned int));
+
+    setGhostOutflow<<<BlocksPerGrid, threadsPerBlock>>>(h_dev, hu_dev, hv_dev,
+                                                        b_dev, l_nx, l_ny);
+    netUpdates<<<BlocksPerGrid, threadsPerBlock>>>(
+        h_dev, h_dev_UpdateR, h_dev_UpdateL, hu_dev, mom_dev_UpdateR,
+        mom_dev_UpdateL, l_nx - 1, l_ny, b_dev, scaling_dev, l_nx, 1,
+        speedMax_dev);
+    netUpdates<<<BlocksPerGrid, threadsPerBlock>>>(
+        h_dev, h_dev_UpdateR, h_dev_UpdateL, hv_dev, mom_dev_UpdateR,
+        mom_dev_UpdateL, l_nx, l_ny - 1, b_dev, scaling_dev, l_nx, l_nx,
+        speedMax_dev);
+    m_speedInit = true;
+  }
+
+  cudaMemset(time_dev, 0, sizeof(float));
+  steps(i_computeSteps, true, i_dxy);
+
+  float l_time = 0;
+  cudaMemcpy(&l_time, time_dev, sizeof(float), cudaMemcpyDeviceToHost);
+  return l_time;
+}
+
+void tsunami_lab::patches::cuda_WavePropagation2d::steps(t_idx i_computeSteps,
+                                                         bool i_adaptive,
+                                                         t_real i_dxy) {
   t_idx l_nx = m_xCells + 2;
   t_idx l_ny = m_yCells + 2;
 
@@ -92,11 +128,21 @@ void tsunami_lab::patches::cuda_WavePropagation2d::timeStep(
     setGhostOutflow<<<BlocksPerGrid, threadsPerBlock>>>(h_dev, hu_dev, hv_dev,
                                                         b_dev, l_nx, l_ny);
 
+    // derive the time step from the previous one's wave speeds, the
+    // reduction restarts for this step
+    if (i_adaptive) {
+      deriveTimeStep<<<1, 1>>>(speedMax_dev, scaling_dev, time_dev, i_dxy,
+                               m_cfl);
+    } else {
+      cudaMemset(speedMax_dev, 0, sizeof(unsigned int));
+    }
+
     // x Sweep
 
     netUpdates<<<BlocksPerGrid, threadsPerBlock>>>(
         h_dev, h_dev_UpdateR, h_dev_UpdateL, hu_dev, mom_dev_UpdateR,
-        mom_dev_UpdateL, l_nx - 1, l_ny, b_dev, i_scaling, l_nx, 1);
+        mom_dev_UpdateL, l_nx - 1, l_ny, b_dev, scaling_dev, l_nx, 1,
+        speedMax_dev);
 
     updateValues<<<BlocksPerGrid, threadsPerBlock>>>(
         h_dev, h_dev_UpdateR, h_dev_UpdateL, hu_dev, mom_dev_UpdateR,
@@ -105,15 +151,28 @@ void tsunami_lab::patches::cuda_WavePropagation2d::timeStep(
     // y Sweep
     netUpdates<<<BlocksPerGrid, threadsPerBlock>>>(
         h_dev, h_dev_UpdateR, h_dev_UpdateL, hv_dev, mom_dev_UpdateR,
-        mom_dev_UpdateL, l_nx, l_ny - 1, b_dev, i_scaling, l_nx, l_nx);
+        mom_dev_UpdateL, l_nx, l_ny - 1, b_dev, scaling_dev, l_nx, l_nx,
+        speedMax_dev);
 
     updateValues<<<BlocksPerGrid, threadsPerBlock>>>(
         h_dev, h_dev_UpdateR, h_dev_UpdateL, hv_dev, mom_dev_UpdateR,
         mom_dev_UpdateL, l_nx, l_ny);
   }
-  cudaMemcpy(m_h, h_dev, size * sizeof(float), cudaMemcpyDeviceToHost);
-  cudaMemcpy(m_hu, hu_dev, size * sizeof(float), cudaMemcpyDeviceToHost);
-  cudaMemcpy(m_hv, hv_dev, size * sizeof(float), cudaMemcpyDeviceToHost);
+  cudaMemcpy(m_h.data(), h_dev, size * sizeof(float), cudaMemcpyDeviceToHost);
+  cudaMemcpy(m_hu.data(), hu_dev, size * sizeof(float), cudaMemcpyDeviceToHost);
+  cudaMemcpy(m_hv.data(), hv_dev, size * sizeof(float), cudaMemcpyDeviceToHost);
+}
+
+__global__ void deriveTimeStep(unsigned int *io_speedMax, float *o_scaling,
+                               float *io_time, float i_dxy, float i_cfl) {
+  // domains without water do not restrict the time step
+  float l_speedMax = __uint_as_float(*io_speedMax);
+  if (l_speedMax <= 0) l_speedMax = 1;
+
+  float l_dt = i_cfl * i_dxy / l_speedMax;
+  *o_scaling = l_dt / i_dxy;
+  *io_time += l_dt;
+  *io_speedMax = 0;
 }
 
 __global__ void updateValues(float *o_h, float *i_h_UpdateR, float *i_h_UpdateL,
@@ -206,11 +265,15 @@ __global__ void netUpdates(float *i_height, float *o_height_UpdateR,
                            float *o_height_UpdateL, float *i_momentum,
                            float *o_momentum_UpdateR, float *o_momentum_UpdateL,
                            int i_xEdges, int i_yEdges, float *i_b,
-                           float i_scaling, int i_nx, int i_stride) {
+                           float const *i_scaling, int i_nx, int i_stride,
+                           unsigned int *io_speedMax) {
   int l_i = blockIdx.x * blockDim.x + threadIdx.x;
   int l_j = blockIdx.y * blockDim.y + threadIdx.y;
   int idx = l_i + l_j * i_nx;
 
+  float l_scaling = *i_scaling;
+  float l_speed = 0;
+
   if (l_i < i_xEdges && l_j < i_yEdges) {
     // compute u for left and right
 
@@ -263,9 +326,11 @@ __global__ void netUpdates(float *i_height, float *o_height_UpdateR,
 
     // compute the alpha values
     float l_strengthL =
-        -i_scaling * l_detInv * (l_waveSpeedR * l_fJump_1 - l_fJump_2);
+        -l_scaling * l_detInv * (l_waveSpeedR * l_fJump_1 - l_fJump_2);
     float l_strengthR =
-        -i_scaling * l_detInv * (l_fJump_2 - l_waveSpeedL * l_fJump_1);
+        -l_scaling * l_detInv * (l_fJump_2 - l_waveSpeedL * l_fJump_1);
+
+    l_speed = fmaxf(fabsf(l_waveSpeedL), fabsf(l_waveSpeedR));
 
     if (l_waveSpeedL < 0) {
       o_height_UpdateL[idx] = l_strengthL;
@@ -293,4 +358,16 @@ __global__ void netUpdates(float *i_height, float *o_height_UpdateR,
       o_momentum_UpdateR[idx + i_stride] = 0;
     }
   }
+
+  // edges between dry cells have no valid speed
+  if (!(l_speed > 0)) l_speed = 0;
+
+  // reduce the wave speeds in the warp, one atomic per warp; the bits of
+  // non-negative floats are ordered like unsigned integers
+  for (int l_off = 16; l_off > 0; l_off /= 2) {
+    l_speed = fmaxf(l_speed, __shfl_down_sync(0xffffffff, l_speed, l_off));
+  }
+  if ((threadIdx.x + threadIdx.y * blockDim.x) % 32 == 0) {
+    atomicMax(io_speedMax, __float_as_uint(l_speed));
+  }
 }
@@ -3,6 +3,7 @@
 
 #include <cuda.h>
 
+#include "../Grid2d.h"
 #include "WavePropagation.h"
 
 namespace tsunami_lab {
@@ -20,10 +21,10 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
   int m_blockspergrid_x;
   int m_blockspergrid_y;
 
-  t_real *m_h;
-  t_real *m_hv;
-  t_real *m_hu;
-  t_real *m_b;
+  Grid2d<t_real> m_h;
+  Grid2d<t_real> m_hv;
+  Grid2d<t_real> m_hu;
+  Grid2d<t_real> m_b;
 
   t_real *h_dev;
   t_real *h_dev_UpdateR;
@@ -34,6 +35,29 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
   t_real *hv_dev;
   t_real *b_dev;
 
+  //! maximum wave speed of the running time step as bits of a float
+  unsigned int *speedMax_dev;
+  //! scaling of the running time step
+  t_real *scaling_dev;
+  //! simulated time of the time steps of a call
+  t_real *time_dev;
+
+  //! true if the wave speeds of the initial quantities were derived
+  bool m_speedInit = false;
+
+  //! CFL number of the dimensionally split scheme in two dimensions
+  t_real m_cfl = 0.5;
+
+  /**
+   * Performs time steps on the device.
+   *
+   * @param i_computeSteps number of time steps.
+   * @param i_adaptive true if the time step is derived from the wave speeds of
+   *the previous step, otherwise the scaling on the device is used.
+   * @param i_dxy cell size.
+   **/
+  void steps(t_idx i_computeSteps, bool i_adaptive, t_real i_dxy);
+
   bool m_reflBoundL;
   bool m_reflBoundR;
 
@@ -44,6 +68,16 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
 
   void timeStep(t_real i_scaling, t_idx i_computeSteps);
 
+  /**
+   * Performs time steps with the largest stable time step. The time step is
+   *derived on the device from the maximum wave speed of the previous step.
+   *
+   * @param i_dxy cell size.
+   * @param i_computeSteps number of time steps.
+   * @return simulated time of all time steps.
+   **/
+  t_real timeStepAdaptive(t_real i_dxy, t_idx i_computeSteps);
+
   /**
    * Gets the stride in y-direction. x-direction is stride-1.
    *
@@ -56,28 +90,28 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
    *
    * @return water heights.
    */
-  t_real const *getHeight() { return m_h + 3 + m_xCells; }
+  t_real const *getHeight() { return m_h.interior(); }
 
   /**
    * Gets the cells' momenta in x-direction.
    *
    * @return momenta in x-direction.
    **/
-  t_real const *getMomentumX() { return m_hu + 3 + m_xCells; }
+  t_real const *getMomentumX() { return m_hu.interior(); }
 
   /**
    * Gets the cell's momentum in y-direction.
    *
    * @return momenta in y-direction.
    **/
-  t_real const *getMomentumY() { return m_hv + 3 + m_xCells; }
+  t_real const *getMomentumY() { return m_hv.interior(); }
 
   /**
    * Gets the cells' bathymetry in x-direction.
    *
    * @return bathymetry in x-direction.
    **/
-  t_real const *getBathymetry() { return m_b + 3 + m_xCells; }
+  t_real const *getBathymetry() { return m_b.interior(); }
 
   /**
    * Sets the height of the cell to the given value.
@@ -87,7 +121,7 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
    * @param i_h water height.
    **/
   void setHeight(t_idx i_ix, t_idx i_iy, t_real i_h) {
-    m_h[(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_h;
+    m_h(i_ix + 1, i_iy + 1) = i_h;
   }
 
   /**
@@ -98,7 +132,7 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
    * @param i_y id of the cell in y-direction.
    **/
   void setMomentumX(t_idx i_ix, t_idx i_iy, t_real i_hu) {
-    m_hu[(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_hu;
+    m_hu(i_ix + 1, i_iy + 1) = i_hu;
   }
 
   /**
@@ -109,7 +143,7 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
    * @param i_hu momentum in x-direction.
    **/
   void setMomentumY(t_idx i_ix, t_idx i_iy, t_real i_hv) {
-    m_hu[(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_hv;
+    m_hu(i_ix + 1, i_iy + 1) = i_hv;
   };
 
   /**
@@ -120,7 +154,7 @@ class tsunami_lab::patches::cuda_WavePropagation2d : public WavePropagation {
    * @param i_b bathymetry value of the cell.
    **/
   void setBathymetry(t_idx i_ix, t_idx i_iy, t_real i_b) {
-    m_b[(i_ix + 1) + ((i_iy + 1) * (m_xCells + 2))] = i_b;
+    m_b(i_ix + 1, i_iy + 1) = i_b;
   }
 
   void setReflection(t_idx, bool i_reflL, bool i_reflR) {
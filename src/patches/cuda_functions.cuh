@@ -6,8 +6,11 @@
 
 __global__ void netUpdates(float *i_height, float *o_height_UpdateR, float *o_height_UpdateL,
     float *i_momentum, float *o_momentum_UpdateR, float *o_momentum_UpdateL, 
-    int i_xEdges, int i_yEdges, float *i_b, float i_scaling,
-    int i_nx, int i_stride);
+    int i_xEdges, int i_yEdges, float *i_b, float const *i_scaling,
+    int i_nx, int i_stride, unsigned int *io_speedMax);
+
+__global__ void deriveTimeStep(unsigned int *io_speedMax, float *o_scaling,
+                               float *io_time, float i_dxy, float i_cfl);
 
 __global__ void setGhostOutflow(float *i_height, float *i_hu, float *i_hv,
          float *i_b, int i_nx, int i_ny);
@@ -0,0 +1,212 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Two-dimensional wave propagation patch distributed to MPI processes.
+ **/
+#include "mpi_WavePropagation2d.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+tsunami_lab::patches::mpi_WavePropagation2d::mpi_WavePropagation2d(
+    t_idx i_xCells, t_idx i_yCells, MPI_Comm i_comm) {
+  m_xCellsGlobal = i_xCells;
+  m_yCellsGlobal = i_yCells;
+
+  // dimension 0 of the grid of processes is the y-direction, which gets the
+  // larger number of processes and keeps the messages of the rows contiguous
+  int l_nRanks = 1;
+  MPI_Comm_size(i_comm, &l_nRanks);
+  int l_dims[2] = {0, 0};
+  MPI_Dims_create(l_nRanks, 2, l_dims);
+  int l_periods[2] = {0, 0};
+  MPI_Cart_create(i_comm, 2, l_dims, l_periods, 1, &m_comm);
+  MPI_Comm_rank(m_comm, &m_rank);
+
+  int l_coords[2] = {0, 0};
+  MPI_Cart_coords(m_comm, m_rank, 2, l_coords);
+  MPI_Cart_shift(m_comm, 1, 1, &m_neighbours[0], &m_neighbours[1]);
+  MPI_Cart_shift(m_comm, 0, 1, &m_neighbours[2], &m_neighbours[3]);
+
+  m_xFirst = (m_xCellsGlobal * l_coords[1]) / l_dims[1];
+  m_xCells = (m_xCellsGlobal * (l_coords[1] + 1)) / l_dims[1] - m_xFirst;
+  m_yFirst = (m_yCellsGlobal * l_coords[0]) / l_dims[0];
+  m_yCells = (m_yCellsGlobal * (l_coords[0] + 1)) / l_dims[0] - m_yFirst;
+  if (m_xCells == 0 || m_yCells == 0) {
+    std::cerr << "the domain has less cells than processes in a direction"
+              << std::endl;
+    MPI_Abort(m_comm, EXIT_FAILURE);
+  }
+
+  // only the boundaries of the whole domain are outflow, the other ghost
+  // cells are halos
+  m_patch = new WavePropagation2d<>(m_xCells, m_yCells);
+  m_patch->setOutflow(
+      m_neighbours[0] == MPI_PROC_NULL, m_neighbours[1] == MPI_PROC_NULL,
+      m_neighbours[2] == MPI_PROC_NULL, m_neighbours[3] == MPI_PROC_NULL);
+}
+
+tsunami_lab::patches::mpi_WavePropagation2d::~mpi_WavePropagation2d() {
+  delete m_patch;
+  MPI_Comm_free(&m_comm);
+}
+
+void tsunami_lab::patches::mpi_WavePropagation2d::exchangeColumns(
+    unsigned short i_nQuantities) {
+  t_idx l_nRows = m_yCells + 2;
+  int l_count = i_nQuantities * l_nRows;
+
+  // columns sent to and received from the left and right neighbours
+  t_idx l_colSend[2] = {1, m_xCells};
+  t_idx l_colRecv[2] = {0, m_xCells + 1};
+
+  // the tag is the side of the receiver
+  MPI_Request l_requests[4];
+  for (unsigned short l_si = 0; l_si < 2; l_si++) {
+    m_recvBuffers[l_si].resize(l_count);
+    m_sendBuffers[l_si].resize(l_count);
+
+    MPI_Irecv(m_recvBuffers[l_si].data(), l_count, realType(),
+              m_neighbours[l_si], l_si, m_comm, &l_requests[l_si]);
+
+    m_patch->packCells(l_colSend[l_si], 0, 1, l_nRows, i_nQuantities,
+                       m_sendBuffers[l_si].data());
+    MPI_Isend(m_sendBuffers[l_si].data(), l_count, realType(),
+              m_neighbours[l_si], 1 - l_si, m_comm, &l_requests[2 + l_si]);
+  }
+  MPI_Waitall(4, l_requests, MPI_STATUSES_IGNORE);
+
+  for (unsigned short l_si = 0; l_si < 2; l_si++) {
+    if (m_neighbours[l_si] == MPI_PROC_NULL) continue;
+    m_patch->unpackCells(l_colRecv[l_si], 0, 1, l_nRows, i_nQuantities,
+                         m_recvBuffers[l_si].data());
+  }
+}
+
+void tsunami_lab::patches::mpi_WavePropagation2d::startRows(
+    unsigned short i_nQuantities) {
+  t_idx l_nCols = m_xCells + 2;
+  int l_count = i_nQuantities * l_nCols;
+
+  // rows sent to the bottom and top neighbours, including the corners
+  t_idx l_rowSend[2] = {1, m_yCells};
+
+  for (unsigned short l_si = 2; l_si < 4; l_si++) {
+    m_recvBuffers[l_si].resize(l_count);
+    m_sendBuffers[l_si].resize(l_count);
+
+    MPI_Irecv(m_recvBuffers[l_si].data(), l_count, realType(),
+              m_neighbours[l_si], l_si, m_comm, &m_rowRequests[l_si - 2]);
+
+    m_patch->packCells(0, l_rowSend[l_si - 2], l_nCols, 1, i_nQuantities,
+                       m_sendBuffers[l_si].data());
+    MPI_Isend(m_sendBuffers[l_si].data(), l_count, realType(),
+              m_neighbours[l_si], 5 - l_si, m_comm, &m_rowRequests[l_si]);
+  }
+}
+
+void tsunami_lab::patches::mpi_WavePropagation2d::finishRows(
+    unsigned short i_nQuantities) {
+  t_idx l_nCols = m_xCells + 2;
+  t_idx l_rowRecv[2] = {0, m_yCells + 1};
+
+  MPI_Waitall(4, m_rowRequests, MPI_STATUSES_IGNORE);
+
+  for (unsigned short l_si = 2; l_si < 4; l_si++) {
+    if (m_neighbours[l_si] == MPI_PROC_NULL) continue;
+    m_patch->unpackCells(0, l_rowRecv[l_si - 2], l_nCols, 1, i_nQuantities,
+                         m_recvBuffers[l_si].data());
+  }
+}
+
+tsunami_lab::t_real tsunami_lab::patches::mpi_WavePropagation2d::step(
+    t_real i_scaling, bool i_first) {
+  // the boundaries of the whole domain are set once per call, like the ones
+  // of a single patch
+  if (i_first) m_patch->setGhostOutflow();
+
+  // the bathymetry is exchanged after it changed, the edges of the interior
+  // rows depend on its halos
+  bool l_bathymetry = !m_halosBathymetryValid;
+  unsigned short l_nQuantities = l_bathymetry ? 4 : 3;
+  exchangeColumns(l_nQuantities);
+  startRows(l_nQuantities);
+  if (l_bathymetry) finishRows(l_nQuantities);
+  m_halosBathymetryValid = true;
+
+  // the interior rows only depend on the columns, the halo rows are swept
+  // once they arrived
+  t_real l_speedMax = m_patch->xSweepBlock(i_scaling, 1, m_yCells + 1);
+  if (!l_bathymetry) finishRows(l_nQuantities);
+  l_speedMax = std::max(l_speedMax, m_patch->xSweepBlock(i_scaling, 0, 1));
+  l_speedMax = std::max(
+      l_speedMax, m_patch->xSweepBlock(i_scaling, m_yCells + 1, m_yCells + 2));
+
+  l_speedMax = std::max(l_speedMax, m_patch->completeStep(i_scaling));
+
+  return l_speedMax;
+}
+
+void tsunami_lab::patches::mpi_WavePropagation2d::timeStep(
+    t_real i_scaling, t_idx i_computeSteps) {
+  for (t_idx l_st = 0; l_st < i_computeSteps; l_st++) {
+    m_speedMax = step(i_scaling, l_st == 0);
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &m_speedMax, 1, realType(), MPI_MAX, m_comm);
+}
+
+tsunami_lab::t_real tsunami_lab::patches::mpi_WavePropagation2d::timeStepAdaptive(
+    t_real i_dxy, t_idx i_computeSteps) {
+  // the first time step has no wave speeds of a previous one
+  if (m_speedMax <= 0) {
+    m_patch->setGhostOutflow();
+    unsigned short l_nQuantities = m_halosBathymetryValid ? 3 : 4;
+    exchangeColumns(l_nQuantities);
+    startRows(l_nQuantities);
+    finishRows(l_nQuantities);
+    m_halosBathymetryValid = true;
+
+    m_speedMax = m_patch->deriveSpeedMax();
+    MPI_Allreduce(MPI_IN_PLACE, &m_speedMax, 1, realType(), MPI_MAX, m_comm);
+  }
+
+  t_real l_time = 0;
+  for (t_idx l_st = 0; l_st < i_computeSteps; l_st++) {
+    // largest stable time step of all processes, domains without water do not
+    // restrict the time step
+    t_real l_speedMax = (m_speedMax > 0) ? m_speedMax : 1;
+    t_real l_dt = m_cfl * i_dxy / l_speedMax;
+
+    m_speedMax = step(l_dt / i_dxy, l_st == 0);
+    MPI_Allreduce(MPI_IN_PLACE, &m_speedMax, 1, realType(), MPI_MAX, m_comm);
+    l_time += l_dt;
+  }
+
+  return l_time;
+}
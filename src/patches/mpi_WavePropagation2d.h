@@ -0,0 +1,372 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Two-dimensional wave propagation patch distributed to MPI processes.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_MPI_WAVE_PROPAGATION_2D
+#define TSUNAMI_LAB_PATCHES_MPI_WAVE_PROPAGATION_2D
+
+#include <mpi.h>
+
+#include <vector>
+
+#include "WavePropagation.h"
+#include "WavePropagation2d.h"
+
+namespace tsunami_lab {
+namespace patches {
+class mpi_WavePropagation2d;
+}
+}  // namespace tsunami_lab
+
+/**
+ * Decomposes the domain into blocks of a two-dimensional Cartesian grid of
+ *processes. Every process advances its block with a WavePropagation2d whose
+ *ghost layer holds the halos of the neighbouring blocks. The halos are
+ *exchanged before every time step: the columns first, then the rows including
+ *the ghost columns, which carries the corners over the diagonal. The
+ *exchange of the rows overlaps with the x-sweep of the interior rows. Every
+ *process sweeps its halo rows itself, thus the result is the same as the one
+ *of a single WavePropagation2d. The dimensionally split scheme is used.
+ *
+ * The setters take the ids of the whole domain and ignore cells of other
+ *processes, the getters return the block of the process.
+ **/
+class tsunami_lab::patches::mpi_WavePropagation2d : public WavePropagation {
+ private:
+  //! communicator of the Cartesian grid of processes
+  MPI_Comm m_comm = MPI_COMM_NULL;
+
+  //! rank in m_comm
+  int m_rank = 0;
+
+  //! neighbouring processes; 0: left, 1: right, 2: bottom, 3: top
+  int m_neighbours[4] = {MPI_PROC_NULL, MPI_PROC_NULL, MPI_PROC_NULL,
+                         MPI_PROC_NULL};
+
+  //! number of cells of the whole domain in x-direction
+  t_idx m_xCellsGlobal = 0;
+
+  //! number of cells of the whole domain in y-direction
+  t_idx m_yCellsGlobal = 0;
+
+  //! first column of the block in the whole domain
+  t_idx m_xFirst = 0;
+
+  //! first row of the block in the whole domain
+  t_idx m_yFirst = 0;
+
+  //! number of cells of the block in x-direction
+  t_idx m_xCells = 0;
+
+  //! number of cells of the block in y-direction
+  t_idx m_yCells = 0;
+
+  //! block of the process including the halos
+  WavePropagation2d<> *m_patch = nullptr;
+
+  //! true if the halos hold the bathymetry of the neighbours
+  bool m_halosBathymetryValid = false;
+
+  //! maximum absolute wave speed of all processes in the last time step, 0
+  //! if none was done since the quantities were set
+  t_real m_speedMax = 0;
+
+  //! CFL number of the time steps, the same as the one of the patch
+  t_real m_cfl = 0.5;
+
+  //! buffers of the halos sent to the neighbours, see m_neighbours
+  std::vector<t_real> m_sendBuffers[4];
+
+  //! buffers of the halos received from the neighbours, see m_neighbours
+  std::vector<t_real> m_recvBuffers[4];
+
+  //! pending requests of the exchange of the rows
+  MPI_Request m_rowRequests[4] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL,
+                                  MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+  /**
+   * Gets the MPI datatype of t_real.
+   *
+   * @return datatype.
+   **/
+  static MPI_Datatype realType() {
+    return (sizeof(t_real) == sizeof(double)) ? MPI_DOUBLE : MPI_FLOAT;
+  }
+
+  /**
+   * Exchanges the columns next to the left and right halos of all rows and
+   *waits for them.
+   *
+   * @param i_nQuantities 3: heights and momenta, 4: bathymetry as well.
+   **/
+  void exchangeColumns(unsigned short i_nQuantities);
+
+  /**
+   * Starts the exchange of the rows next to the bottom and top halos including
+   *the ghost columns. The columns have to be exchanged before.
+   *
+   * @param i_nQuantities 3: heights and momenta, 4: bathymetry as well.
+   **/
+  void startRows(unsigned short i_nQuantities);
+
+  /**
+   * Waits for the rows of startRows and copies them to the halos.
+   *
+   * @param i_nQuantities 3: heights and momenta, 4: bathymetry as well.
+   **/
+  void finishRows(unsigned short i_nQuantities);
+
+  /**
+   * Exchanges the halos and performs a time step of the block.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_first true for the first time step of a call.
+   * @return maximum absolute wave speed of the block.
+   **/
+  t_real step(t_real i_scaling, bool i_first);
+
+  /**
+   * Checks if a cell of the whole domain belongs to the block.
+   *
+   * @param i_ix id of the cell in x-direction.
+   * @param i_iy id of the cell in y-direction.
+   * @return true if the process owns the cell.
+   **/
+  bool owns(t_idx i_ix, t_idx i_iy) const {
+    return i_ix >= m_xFirst && i_ix < m_xFirst + m_xCells &&
+           i_iy >= m_yFirst && i_iy < m_yFirst + m_yCells;
+  }
+
+ public:
+  /**
+   * Constructs the block of the calling process. Collective over the
+   *communicator.
+   *
+   * @param i_xCells number of cells of the whole domain in x-direction.
+   * @param i_yCells number of cells of the whole domain in y-direction.
+   * @param i_comm communicator of the processes sharing the domain.
+   **/
+  mpi_WavePropagation2d(t_idx i_xCells, t_idx i_yCells, MPI_Comm i_comm);
+
+  /**
+   * Destructor which frees the block and the communicator.
+   **/
+  ~mpi_WavePropagation2d();
+
+  /**
+   * Performs time steps. Collective over the communicator.
+   *
+   * @param i_scaling scaling of the time step (dt / dx).
+   * @param i_computeSteps number of time steps.
+   **/
+  void timeStep(t_real i_scaling, t_idx i_computeSteps);
+
+  /**
+   * Performs time steps with the largest stable time step of all processes.
+   *Collective over the communicator.
+   *
+   * @param i_dxy cell size.
+   * @param i_computeSteps number of time steps.
+   * @return simulated time of all time steps.
+   **/
+  t_real timeStepAdaptive(t_real i_dxy, t_idx i_computeSteps);
+
+  /**
+   * Gets the rank of the process in the Cartesian grid.
+   *
+   * @return rank.
+   **/
+  int getRank() const { return m_rank; }
+
+  /**
+   * Gets the first column of the block in the whole domain.
+   *
+   * @return id of the column.
+   **/
+  t_idx getXFirst() const { return m_xFirst; }
+
+  /**
+   * Gets the first row of the block in the whole domain.
+   *
+   * @return id of the row.
+   **/
+  t_idx getYFirst() const { return m_yFirst; }
+
+  /**
+   * Gets the number of cells of the block in x-direction.
+   *
+   * @return number of cells.
+   **/
+  t_idx getNx() const { return m_xCells; }
+
+  /**
+   * Gets the number of cells of the block in y-direction.
+   *
+   * @return number of cells.
+   **/
+  t_idx getNy() const { return m_yCells; }
+
+  /**
+   * Gets the stride of the block in y-direction. x-direction is stride-1.
+   *
+   * @return stride in y-direction.
+   **/
+  t_idx getStride() { return m_patch->getStride(); }
+
+  /**
+   * Gets the water heights of the block.
+   *
+   * @return water heights.
+   **/
+  t_real const *getHeight() { return m_patch->getHeight(); }
+
+  /**
+   * Gets the momenta in x-direction of the block.
+   *
+   * @return momenta in x-direction.
+   **/
+  t_real const *getMomentumX() { return m_patch->getMomentumX(); }
+
+  /**
+   * Gets the momenta in y-direction of the block.
+   *
+   * @return momenta in y-direction.
+   **/
+  t_real const *getMomentumY() { return m_patch->getMomentumY(); }
+
+  /**
+   * Gets the bathymetry of the block.
+   *
+   * @return bathymetry.
+   **/
+  t_real const *getBathymetry() { return m_patch->getBathymetry(); }
+
+  /**
+   * Enables or disables the accumulation of the extremes of the block by the
+   *y-sweeps of its patch.
+   *
+   * @param i_enabled true if the extremes are accumulated.
+   * @param i_threshold amplitude of the sea surface from which on a wave has
+   *arrived at a cell.
+   * @param i_dxy cell width, converts the scaling of all time steps to the
+   *simulated time.
+   * @return true.
+   **/
+  bool setExtremes(bool i_enabled, t_real i_threshold = 0.01,
+                   t_real i_dxy = 1) {
+    return m_patch->setExtremes(i_enabled, i_threshold, i_dxy);
+  }
+
+  /**
+   * Gets the interior cells of a row of a quantity of the block.
+   *
+   * @param i_quantity 0: heights, 1: momenta in x-direction, 2: momenta in
+   *y-direction, 3: bathymetry, 4-6: extremes, see setExtremes.
+   * @param i_iy id of the row in the block.
+   * @param io_row buffer of a row.
+   * @return values of the row's interior cells.
+   **/
+  t_real const *getRow(unsigned short i_quantity, t_idx i_iy,
+                       t_real *io_row) {
+    return m_patch->getRow(i_quantity, i_iy, io_row);
+  }
+
+  /**
+   * Sets the height of a cell of the block.
+   *
+   * @param i_ix id of the cell in x-direction of the whole domain.
+   * @param i_iy id of the cell in y-direction of the whole domain.
+   * @param i_h water height.
+   **/
+  void setHeight(t_idx i_ix, t_idx i_iy, t_real i_h) {
+    if (!owns(i_ix, i_iy)) return;
+    m_patch->setHeight(i_ix - m_xFirst, i_iy - m_yFirst, i_h);
+  }
+
+  /**
+   * Sets the momentum in x-direction of a cell of the block.
+   *
+   * @param i_ix id of the cell in x-direction of the whole domain.
+   * @param i_iy id of the cell in y-direction of the whole domain.
+   * @param i_hu momentum in x-direction.
+   **/
+  void setMomentumX(t_idx i_ix, t_idx i_iy, t_real i_hu) {
+    if (!owns(i_ix, i_iy)) return;
+    m_patch->setMomentumX(i_ix - m_xFirst, i_iy - m_yFirst, i_hu);
+  }
+
+  /**
+   * Sets the momentum in y-direction of a cell of the block.
+   *
+   * @param i_ix id of the cell in x-direction of the whole domain.
+   * @param i_iy id of the cell in y-direction of the whole domain.
+   * @param i_hv momentum in y-direction.
+   **/
+  void setMomentumY(t_idx i_ix, t_idx i_iy, t_real i_hv) {
+    if (!owns(i_ix, i_iy)) return;
+    m_patch->setMomentumY(i_ix - m_xFirst, i_iy - m_yFirst, i_hv);
+  }
+
+  /**
+   * Sets the bathymetry of a cell of the block.
+   *
+   * @param i_ix id of the cell in x-direction of the whole domain.
+   * @param i_iy id of the cell in y-direction of the whole domain.
+   * @param i_b bathymetry.
+   **/
+  void setBathymetry(t_idx i_ix, t_idx i_iy, t_real i_b) {
+    if (!owns(i_ix, i_iy)) return;
+    m_patch->setBathymetry(i_ix - m_xFirst, i_iy - m_yFirst, i_b);
+  }
+
+  /**
+   * Finishes the setup of the cells of the block.
+   **/
+  void finishSetup() {
+    m_patch->finishSetup();
+    m_speedMax = 0;
+    m_halosBathymetryValid = false;
+  }
+
+  /**
+   * Sets the reflection of the boundaries of the whole domain.
+   *
+   * @param i_iy row in which the ghost cells are set.
+   * @param i_reflL reflection of the left ghost cells.
+   * @param i_reflR reflection of the right ghost cells.
+   **/
+  void setReflection(t_idx i_iy, bool i_reflL, bool i_reflR) {
+    m_patch->setReflection(i_iy, i_reflL && m_neighbours[0] == MPI_PROC_NULL,
+                           i_reflR && m_neighbours[1] == MPI_PROC_NULL);
+  }
+
+  void MemTransfer() {}
+};
+
+#endif
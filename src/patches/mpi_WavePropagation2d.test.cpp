@@ -0,0 +1,125 @@
+/**
+ * @author Julius Isken, Max Engel
+ *
+ * @section LICENSE
+ * Copyright 2020, Julius Isken, Max Engel
+ *
+ * Redistribution and use in source and binary forms, with or without
+ *modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *this list of conditions and the following disclaimer in the documentation
+ *and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ *DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ *FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ *SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ *OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * @section DESCRIPTION
+ * Unit tests of the two-dimensional patch distributed to MPI processes, run
+ *them with mpirun, e.g., mpirun -np 4 ./build/tests "[MpiWaveProp2d]".
+ **/
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include "WavePropagation2d.h"
+#include "mpi_WavePropagation2d.h"
+
+/**
+ * Sets up a hump next to a sloped beach with dry cells.
+ *
+ * @param io_waveProp solver.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ **/
+static void setupBeach(tsunami_lab::patches::WavePropagation &io_waveProp,
+                       std::size_t i_nx, std::size_t i_ny) {
+  for (std::size_t l_ceY = 0; l_ceY < i_ny; l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < i_nx; l_ceX++) {
+      float l_dX = l_ceX - 9.0f;
+      float l_dY = l_ceY - 6.0f;
+      float l_b = -12 + (float)l_ceX * 0.5f + (float)(l_ceY % 3);
+      io_waveProp.setBathymetry(l_ceX, l_ceY, l_b);
+      io_waveProp.setHeight(
+          l_ceX, l_ceY,
+          l_b < 0 ? -l_b + std::exp(-(l_dX * l_dX + l_dY * l_dY) / 5) : 0);
+      io_waveProp.setMomentumX(l_ceX, l_ceY, 0);
+      io_waveProp.setMomentumY(l_ceX, l_ceY, 0.1f * (float)(l_ceX % 2));
+    }
+  }
+  io_waveProp.finishSetup();
+}
+
+TEST_CASE("Test the two-dimensional patch distributed to MPI processes.",
+          "[MpiWaveProp2d]") {
+  /*
+   * Test case:
+   *
+   *   Every process advances its block of a sloped beach with constant and
+   *   adaptive time steps, the blocks are bitwise identical to the ones of a
+   *   single patch advanced by every process. So are the extremes
+   *   accumulated by the blocks.
+   */
+  std::size_t l_nx = 31;
+  std::size_t l_ny = 22;
+
+  tsunami_lab::patches::WavePropagation2d<> l_single(l_nx, l_ny);
+  setupBeach(l_single, l_nx, l_ny);
+  l_single.setExtremes(true, 0.05f, 1);
+  l_single.timeStep(0.05, 3);
+  float l_timeSingle = l_single.timeStepAdaptive(1, 5);
+  l_timeSingle += l_single.timeStepAdaptive(1, 4);
+
+  tsunami_lab::patches::mpi_WavePropagation2d l_mpi(l_nx, l_ny,
+                                                    MPI_COMM_WORLD);
+  setupBeach(l_mpi, l_nx, l_ny);
+  REQUIRE(l_mpi.setExtremes(true, 0.05f, 1));
+  l_mpi.timeStep(0.05, 3);
+  float l_time = l_mpi.timeStepAdaptive(1, 5);
+  l_time += l_mpi.timeStepAdaptive(1, 4);
+  REQUIRE(l_time == l_timeSingle);
+
+  for (std::size_t l_ceY = 0; l_ceY < l_mpi.getNy(); l_ceY++) {
+    for (std::size_t l_ceX = 0; l_ceX < l_mpi.getNx(); l_ceX++) {
+      std::size_t l_ce = l_ceX + l_ceY * l_mpi.getStride();
+      std::size_t l_ceSingle = (l_mpi.getXFirst() + l_ceX) +
+                               (l_mpi.getYFirst() + l_ceY) *
+                                   l_single.getStride();
+
+      REQUIRE(l_mpi.getHeight()[l_ce] == l_single.getHeight()[l_ceSingle]);
+      REQUIRE(l_mpi.getMomentumX()[l_ce] ==
+              l_single.getMomentumX()[l_ceSingle]);
+      REQUIRE(l_mpi.getMomentumY()[l_ce] ==
+              l_single.getMomentumY()[l_ceSingle]);
+      REQUIRE(l_mpi.getBathymetry()[l_ce] ==
+              l_single.getBathymetry()[l_ceSingle]);
+    }
+  }
+
+  std::vector<float> l_row(l_mpi.getNx());
+  for (std::size_t l_ceY = 0; l_ceY < l_mpi.getNy(); l_ceY++) {
+    float const *l_extremes[3] = {l_single.getMaxAmplitude(),
+                                  l_single.getMaxVelocity(),
+                                  l_single.getArrivalTime()};
+    for (unsigned short l_ex = 0; l_ex < 3; l_ex++) {
+      float const *l_values = l_mpi.getRow(4 + l_ex, l_ceY, l_row.data());
+      for (std::size_t l_ceX = 0; l_ceX < l_mpi.getNx(); l_ceX++) {
+        std::size_t l_ceSingle = (l_mpi.getXFirst() + l_ceX) +
+                                 (l_mpi.getYFirst() + l_ceY) *
+                                     l_single.getStride();
+        REQUIRE(l_values[l_ceX] == l_extremes[l_ex][l_ceSingle]);
+      }
+    }
+  }
+}
@@ -34,6 +34,11 @@
 #include <cmath>
 #include <cstdlib>
 
+// definitions of the edge types, required since they may be odr-used
+unsigned char constexpr tsunami_lab::solvers::fwave::m_dryL;
+unsigned char constexpr tsunami_lab::solvers::fwave::m_dryR;
+unsigned char constexpr tsunami_lab::solvers::fwave::m_dryDry;
+
 // compute the lambdas we need
 void tsunami_lab::solvers::fwave::waveSpeeds(t_real i_hL, t_real i_hR,
                                              t_real i_uL, t_real i_uR,
@@ -76,11 +81,11 @@ void tsunami_lab::solvers::fwave::waveStrengths(
   o_strengthR = l_detInv * (l_fJump_2 - i_waveSpeedL * l_fJump_1);
 }
 
-void tsunami_lab::solvers::fwave::netUpdates(t_real i_hL, t_real i_hR,
-                                             t_real i_huL, t_real i_huR,
-                                             t_real i_bL, t_real i_bR,
-                                             t_real o_netUpdateL[2],
-                                             t_real o_netUpdateR[2]) {
+tsunami_lab::t_real tsunami_lab::solvers::fwave::netUpdates(
+    t_real i_hL, t_real i_hR, t_real i_huL, t_real i_huR, t_real i_bL,
+    t_real i_bR, t_real o_netUpdateL[2], t_real o_netUpdateR[2]) {
+  t_real l_speed = 0;
+
   // check if left cell is dry
   if (i_bL >= 0) {
     // check if both cells are dry
@@ -89,14 +94,14 @@ void tsunami_lab::solvers::fwave::netUpdates(t_real i_hL, t_real i_hR,
       o_netUpdateR[0] = 0;
       o_netUpdateL[1] = 0;
       o_netUpdateR[1] = 0;
-      return;
+      return 0;
     } else {
       i_hL = i_hR;
       i_huL = -i_huR;
       i_bL = i_bR;
 
-      netUpdatesWithoutRefBoundary(i_hL, i_hR, i_huL, i_huR, i_bL, i_bR,
-                                   o_netUpdateL, o_netUpdateR);
+      l_speed = netUpdatesWithoutRefBoundary(i_hL, i_hR, i_huL, i_huR, i_bL,
+                                             i_bR, o_netUpdateL, o_netUpdateR);
       o_netUpdateL[0] = 0;
       o_netUpdateL[1] = 0;
     }
@@ -107,18 +112,159 @@ void tsunami_lab::solvers::fwave::netUpdates(t_real i_hL, t_real i_hR,
     i_huR = -i_huL;
     i_bR = i_bL;
 
-    netUpdatesWithoutRefBoundary(i_hL, i_hR, i_huL, i_huR, i_bL, i_bR,
-                                 o_netUpdateL, o_netUpdateR);
+    l_speed = netUpdatesWithoutRefBoundary(i_hL, i_hR, i_huL, i_huR, i_bL,
+                                           i_bR, o_netUpdateL, o_netUpdateR);
     o_netUpdateR[0] = 0;
     o_netUpdateR[1] = 0;
   }
-
   // no dry cell
-  netUpdatesWithoutRefBoundary(i_hL, i_hR, i_huL, i_huR, i_bL, i_bR,
-                               o_netUpdateL, o_netUpdateR);
+  else {
+    l_speed = netUpdatesWithoutRefBoundary(i_hL, i_hR, i_huL, i_huR, i_bL,
+                                           i_bR, o_netUpdateL, o_netUpdateR);
+  }
+
+  return l_speed;
+}
+
+tsunami_lab::t_real tsunami_lab::solvers::fwave::netUpdatesBatch(
+    t_idx i_nEdges, t_real const *i_hL, t_real const *i_hR,
+    t_real const *i_huL, t_real const *i_huR, t_real const *i_bL,
+    t_real const *i_bR, t_real *o_netUpdateHL, t_real *o_netUpdateHuL,
+    t_real *o_netUpdateHR, t_real *o_netUpdateHuR) {
+  // classify the edges chunk by chunk, the classified batch does the math
+  t_idx const l_nChunk = 256;
+  unsigned char l_edgeType[l_nChunk];
+  t_real l_bathJump[l_nChunk];
+
+  t_real l_speedMax = 0;
+  for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed += l_nChunk) {
+    t_idx l_n = std::min(l_nChunk, i_nEdges - l_ed);
+    classifyEdges(l_n, i_bL + l_ed, i_bR + l_ed, l_edgeType, l_bathJump);
+
+    t_real l_speed = netUpdatesBatch(
+        l_n, i_hL + l_ed, i_hR + l_ed, i_huL + l_ed, i_huR + l_ed, l_edgeType,
+        l_bathJump, o_netUpdateHL + l_ed, o_netUpdateHuL + l_ed,
+        o_netUpdateHR + l_ed, o_netUpdateHuR + l_ed);
+    l_speedMax = std::max(l_speedMax, l_speed);
+  }
+
+  return l_speedMax;
 }
 
-void tsunami_lab::solvers::fwave::netUpdatesWithoutRefBoundary(
+template <typename T_store, typename T_compute>
+T_compute tsunami_lab::solvers::fwave::netUpdatesBatch(
+    t_idx i_nEdges, T_store const *i_hL, T_store const *i_hR,
+    T_store const *i_huL, T_store const *i_huR, unsigned char const *i_edgeType,
+    T_store const *i_bathJump, T_compute *o_netUpdateHL,
+    T_compute *o_netUpdateHuL, T_compute *o_netUpdateHR,
+    T_compute *o_netUpdateHuR) {
+  T_compute const l_gSqrt = static_cast<T_compute>(m_gSqrtDouble);
+  T_compute const l_g = static_cast<T_compute>(m_gDouble);
+  T_compute l_speedMax = 0;
+
+#pragma omp simd reduction(max : l_speedMax)
+  for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed++) {
+    unsigned char l_type = i_edgeType[l_ed];
+
+    // masks of the dry sides
+    bool l_dryL = (l_type & m_dryL) != 0;
+    bool l_dryR = (l_type & m_dryR) != 0;
+    bool l_dry = l_type == m_dryDry;
+
+    T_compute l_hInL = i_hL[l_ed];
+    T_compute l_hInR = i_hR[l_ed];
+    T_compute l_huInL = i_huL[l_ed];
+    T_compute l_huInR = i_huR[l_ed];
+
+    // reflect a dry side at the edge and keep the lanes of dry edges finite,
+    // their results are masked below
+    T_compute l_hL = l_dry ? 1 : (l_dryL ? l_hInR : l_hInL);
+    T_compute l_huL = l_dry ? 0 : (l_dryL ? -l_huInR : l_huInL);
+
+    T_compute l_hR = l_dry ? 1 : (l_dryR ? l_hInL : l_hInR);
+    T_compute l_huR = l_dry ? 0 : (l_dryR ? -l_huInL : l_huInR);
+
+    // compute particle velocities
+    T_compute l_uL = l_huL / l_hL;
+    T_compute l_uR = l_huR / l_hR;
+
+    // compute wave speeds, see waveSpeeds
+    T_compute l_hSqrtL = std::sqrt(l_hL);
+    T_compute l_hSqrtR = std::sqrt(l_hR);
+
+    T_compute l_hRoe = 0.5f * (l_hL + l_hR);
+    T_compute l_uRoe = l_hSqrtL * l_uL + l_hSqrtR * l_uR;
+    l_uRoe /= l_hSqrtL + l_hSqrtR;
+
+    T_compute l_ghSqrtRoe = l_gSqrt * std::sqrt(l_hRoe);
+    T_compute l_speedL = l_uRoe - l_ghSqrtRoe;
+    T_compute l_speedR = l_uRoe + l_ghSqrtRoe;
+
+    // compute wave strengths, see waveStrengths
+    T_compute l_detInv = 1 / (l_speedR - l_speedL);
+
+    T_compute l_bathEff = i_bathJump[l_ed] * (l_hL + l_hR) / 2;
+
+    T_compute l_fJump_1 = l_huR - l_huL;
+    T_compute l_fJump_2 = l_huR * l_huR / l_hR - l_huL * l_huL / l_hL +
+                          (l_g / 2) * (l_hR * l_hR - l_hL * l_hL);
+    l_fJump_2 -= l_bathEff;
+
+    T_compute l_strengthL = l_detInv * (l_speedR * l_fJump_1 - l_fJump_2);
+    T_compute l_strengthR = l_detInv * (l_fJump_2 - l_speedL * l_fJump_1);
+
+    // compute scaled waves
+    T_compute l_waveL1 = l_speedL * l_strengthL;
+    T_compute l_waveR1 = l_speedR * l_strengthR;
+
+    // select the net-updates depending on wave speeds
+    bool l_leftL = l_speedL < 0;
+    bool l_leftR = !(l_speedR > 0);
+
+    T_compute l_netHL =
+        (l_leftL ? l_strengthL : 0) + (l_leftR ? l_strengthR : 0);
+    T_compute l_netHuL = (l_leftL ? l_waveL1 : 0) + (l_leftR ? l_waveR1 : 0);
+    T_compute l_netHR =
+        (l_leftL ? 0 : l_strengthL) + (l_leftR ? 0 : l_strengthR);
+    T_compute l_netHuR = (l_leftL ? 0 : l_waveL1) + (l_leftR ? 0 : l_waveR1);
+
+    // dry sides do not receive updates
+    o_netUpdateHL[l_ed] = l_dryL ? 0 : l_netHL;
+    o_netUpdateHuL[l_ed] = l_dryL ? 0 : l_netHuL;
+    o_netUpdateHR[l_ed] = l_dryR ? 0 : l_netHR;
+    o_netUpdateHuR[l_ed] = l_dryR ? 0 : l_netHuR;
+
+    // fastest wave of the edge, dry edges have none
+    T_compute l_speed = std::max(std::abs(l_speedL), std::abs(l_speedR));
+    l_speed = l_dry ? 0 : l_speed;
+    l_speedMax = std::max(l_speedMax, l_speed);
+  }
+
+  return l_speedMax;
+}
+
+template <typename T_compute, typename T_store>
+void tsunami_lab::solvers::fwave::classifyEdges(t_idx i_nEdges,
+                                                T_store const *i_bL,
+                                                T_store const *i_bR,
+                                                unsigned char *o_edgeType,
+                                                T_store *o_bathJump) {
+  T_compute const l_g = static_cast<T_compute>(m_gDouble);
+
+  for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed++) {
+    bool l_dryL = i_bL[l_ed] >= 0;
+    bool l_dryR = i_bR[l_ed] >= 0;
+
+    o_edgeType[l_ed] = (l_dryL ? m_dryL : 0) | (l_dryR ? m_dryR : 0);
+
+    // a dry side takes the bathymetry of the reflected one
+    T_compute l_bL = l_dryL ? i_bR[l_ed] : i_bL[l_ed];
+    T_compute l_bR = l_dryR ? i_bL[l_ed] : i_bR[l_ed];
+    o_bathJump[l_ed] = -l_g * (l_bR - l_bL);
+  }
+}
+
+tsunami_lab::t_real tsunami_lab::solvers::fwave::netUpdatesWithoutRefBoundary(
     t_real i_hL, t_real i_hR, t_real i_huL, t_real i_huR, t_real i_bL,
     t_real i_bR, t_real o_netUpdateL[2], t_real o_netUpdateR[2]) {
   // compute particle velocities, redundant
@@ -168,4 +314,25 @@ void tsunami_lab::solvers::fwave::netUpdatesWithoutRefBoundary(
       o_netUpdateL[l_qt] += l_waveR[l_qt];
     }
   }
+
+  return std::max(std::abs(l_speedL), std::abs(l_speedR));
 }
+
+// instantiations for the precision policies, see precision
+template float tsunami_lab::solvers::fwave::netUpdatesBatch(
+    t_idx, float const *, float const *, float const *, float const *,
+    unsigned char const *, float const *, float *, float *, float *, float *);
+template void tsunami_lab::solvers::fwave::classifyEdges<float>(
+    t_idx, float const *, float const *, unsigned char *, float *);
+template double tsunami_lab::solvers::fwave::netUpdatesBatch(
+    t_idx, double const *, double const *, double const *, double const *,
+    unsigned char const *, double const *, double *, double *, double *,
+    double *);
+template void tsunami_lab::solvers::fwave::classifyEdges<double>(
+    t_idx, double const *, double const *, unsigned char *, double *);
+template double tsunami_lab::solvers::fwave::netUpdatesBatch(
+    t_idx, float const *, float const *, float const *, float const *,
+    unsigned char const *, float const *, double *, double *, double *,
+    double *);
+template void tsunami_lab::solvers::fwave::classifyEdges<double>(
+    t_idx, float const *, float const *, unsigned char *, float *);
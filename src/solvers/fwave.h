@@ -40,10 +40,23 @@ class fwave;
 }  // namespace tsunami_lab
 
 class tsunami_lab::solvers::fwave {
+ public:
+  //! bit of an edge type marking the left side as dry
+  static unsigned char constexpr m_dryL = 1;
+  //! bit of an edge type marking the right side as dry
+  static unsigned char constexpr m_dryR = 2;
+  //! edge type of an edge between two dry cells
+  static unsigned char constexpr m_dryDry = m_dryL | m_dryR;
+
  private:
+  //! square root of gravity and gravity in double precision, rounded to the
+  //! compute type of the batches
+  static double constexpr m_gSqrtDouble = 3.131557121;
+  static double constexpr m_gDouble = 9.80665;
+
   //! square root of gravity
-  static t_real constexpr m_gSqrt = 3.131557121;
-  static t_real constexpr m_g = 9.80665;
+  static t_real constexpr m_gSqrt = m_gSqrtDouble;
+  static t_real constexpr m_g = m_gDouble;
 
   /**
    * Computes the wave strengths.
@@ -98,14 +111,97 @@ class tsunami_lab::solvers::fwave {
    *height, 1: momentum.
    * @param o_netUpdateR will be set to the net-updates for the right side; 0:
    *height, 1: momentum.
-   * @param o_speed returns the greater of the 2 Roe values
+   * @return maximum absolute wave speed of the edge, 0 if both cells are dry.
    **/
-  static void netUpdates(t_real i_hL, t_real i_hR, t_real i_huL, t_real i_huR,
+  static t_real netUpdates(t_real i_hL, t_real i_hR, t_real i_huL, t_real i_huR,
                          t_real i_bL, t_real i_bR, t_real o_netUpdateL[2],
                          t_real o_netUpdateR[2]);
 
+  /**
+   * Computes the net-updates for a batch of edges, e.g., a whole row of the
+   *grid. Inputs and outputs are given as structure of arrays. Dry cells and
+   *the wave directions are handled through masked lanes instead of branches,
+   *so that the loop is vectorized.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_bL bathymetry of the left sides.
+   * @param i_bR bathymetry of the right sides.
+   * @param o_netUpdateHL will be set to the height net-updates of the left
+   *sides.
+   * @param o_netUpdateHuL will be set to the momentum net-updates of the left
+   *sides.
+   * @param o_netUpdateHR will be set to the height net-updates of the right
+   *sides.
+   * @param o_netUpdateHuR will be set to the momentum net-updates of the right
+   *sides.
+   * @return maximum absolute wave speed of all edges; edges between two dry
+   *cells are ignored.
+   **/
+  static t_real netUpdatesBatch(t_idx i_nEdges, t_real const *i_hL,
+                              t_real const *i_hR, t_real const *i_huL,
+                              t_real const *i_huR, t_real const *i_bL,
+                              t_real const *i_bR, t_real *o_netUpdateHL,
+                              t_real *o_netUpdateHuL, t_real *o_netUpdateHR,
+                              t_real *o_netUpdateHuR);
+
+  /**
+   * Computes the net-updates for a batch of edges whose types and bathymetry
+   *jumps were derived by classifyEdges. Edges between two dry cells give zero
+   *net-updates, callers are expected to skip them. The quantities are read in
+   *the storage type and the arithmetic is done in the compute type, see
+   *precision.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_hL heights of the left sides.
+   * @param i_hR heights of the right sides.
+   * @param i_huL momenta of the left sides.
+   * @param i_huR momenta of the right sides.
+   * @param i_edgeType types of the edges.
+   * @param i_bathJump bathymetry jumps of the edges.
+   * @param o_netUpdateHL will be set to the height net-updates of the left
+   *sides.
+   * @param o_netUpdateHuL will be set to the momentum net-updates of the left
+   *sides.
+   * @param o_netUpdateHR will be set to the height net-updates of the right
+   *sides.
+   * @param o_netUpdateHuR will be set to the momentum net-updates of the right
+   *sides.
+   * @return maximum absolute wave speed of all edges.
+   **/
+  template <typename T_store, typename T_compute>
+  static T_compute netUpdatesBatch(t_idx i_nEdges, T_store const *i_hL,
+                                   T_store const *i_hR, T_store const *i_huL,
+                                   T_store const *i_huR,
+                                   unsigned char const *i_edgeType,
+                                   T_store const *i_bathJump,
+                                   T_compute *o_netUpdateHL,
+                                   T_compute *o_netUpdateHuL,
+                                   T_compute *o_netUpdateHR,
+                                   T_compute *o_netUpdateHuR);
+
+  /**
+   * Derives the static properties of a batch of edges from the bathymetry: the
+   *edge type, i.e., which sides are dry, and the bathymetry jump -g * (bR - bL)
+   *after reflecting dry sides. The jumps are computed in the compute type and
+   *stored in the storage type.
+   *
+   * @param i_nEdges number of edges in the batch.
+   * @param i_bL bathymetry of the left sides.
+   * @param i_bR bathymetry of the right sides.
+   * @param o_edgeType will be set to the types of the edges, see m_dryL and
+   *m_dryR.
+   * @param o_bathJump will be set to the bathymetry jumps of the edges.
+   **/
+  template <typename T_compute = t_real, typename T_store>
+  static void classifyEdges(t_idx i_nEdges, T_store const *i_bL,
+                            T_store const *i_bR, unsigned char *o_edgeType,
+                            T_store *o_bathJump);
 
-  static void netUpdatesWithoutRefBoundary(t_real i_hL, t_real i_hR, t_real i_huL, t_real i_huR,
+  static t_real netUpdatesWithoutRefBoundary(t_real i_hL, t_real i_hR, t_real i_huL, t_real i_huR,
                          t_real i_bL, t_real i_bR, t_real o_netUpdateL[2],
                          t_real o_netUpdateR[2]);
 };
@@ -28,6 +28,7 @@
  * @section DESCRIPTION
  * Unit tests of the Fwave Riemann solver.
  **/
+#include <algorithm>
 #include <catch2/catch.hpp>
 #define private public
 #include "fwave.h"
@@ -160,3 +161,112 @@ TEST_CASE("Test the derivation of the fwave net-updates.", "[fwaveUpdates]") {
   REQUIRE(l_netUpdatesR[0] == Approx(0));
   REQUIRE(l_netUpdatesR[1] == Approx(0));
 }
+
+TEST_CASE("Test the batched fwave net-updates against the scalar ones.",
+          "[fwaveBatch]") {
+  /*
+   * Test case:
+   *  A row of edges covering wet-wet, wet-dry, dry-wet and dry-dry edges as
+   *  well as left- and right-going waves.
+   */
+  const std::size_t l_nEdges = 37;
+  float l_h[l_nEdges + 1];
+  float l_hu[l_nEdges + 1];
+  float l_b[l_nEdges + 1];
+
+  for (std::size_t l_ce = 0; l_ce < l_nEdges + 1; l_ce++) {
+    l_h[l_ce] = 5 + (l_ce * 7) % 11;
+    l_hu[l_ce] = ((l_ce * 5) % 13) - 6.0f;
+    l_b[l_ce] = -20 + (float)((l_ce * 3) % 8);
+  }
+  // dry cells
+  l_b[4] = 0;
+  l_b[5] = 3;
+  l_b[17] = 10;
+  l_b[30] = 1;
+  l_h[30] = 0;
+
+  float l_netUpdatesHL[l_nEdges];
+  float l_netUpdatesHuL[l_nEdges];
+  float l_netUpdatesHR[l_nEdges];
+  float l_netUpdatesHuR[l_nEdges];
+
+  float l_speedMax = tsunami_lab::solvers::fwave::netUpdatesBatch(
+      l_nEdges, l_h, l_h + 1, l_hu, l_hu + 1, l_b, l_b + 1, l_netUpdatesHL,
+      l_netUpdatesHuL, l_netUpdatesHR, l_netUpdatesHuR);
+
+  float l_speedMaxScalar = 0;
+  for (std::size_t l_ed = 0; l_ed < l_nEdges; l_ed++) {
+    float l_netUpdatesL[2];
+    float l_netUpdatesR[2];
+    float l_speed = tsunami_lab::solvers::fwave::netUpdates(
+        l_h[l_ed], l_h[l_ed + 1], l_hu[l_ed], l_hu[l_ed + 1], l_b[l_ed],
+        l_b[l_ed + 1], l_netUpdatesL, l_netUpdatesR);
+    l_speedMaxScalar = std::max(l_speedMaxScalar, l_speed);
+
+    REQUIRE(l_netUpdatesHL[l_ed] == Approx(l_netUpdatesL[0]));
+    REQUIRE(l_netUpdatesHuL[l_ed] == Approx(l_netUpdatesL[1]));
+    REQUIRE(l_netUpdatesHR[l_ed] == Approx(l_netUpdatesR[0]));
+    REQUIRE(l_netUpdatesHuR[l_ed] == Approx(l_netUpdatesR[1]));
+  }
+
+  // dry sides do not receive updates
+  REQUIRE(l_netUpdatesHR[3] == 0);
+  REQUIRE(l_netUpdatesHL[4] == 0);
+  REQUIRE(l_netUpdatesHR[4] == 0);
+  REQUIRE(l_netUpdatesHL[5] == 0);
+  REQUIRE(l_netUpdatesHuL[17] == 0);
+  REQUIRE(l_netUpdatesHuR[16] == 0);
+
+  // fused maximum of the wave speeds, the dry-dry edge 4 is ignored
+  REQUIRE(l_speedMax == Approx(l_speedMaxScalar));
+  REQUIRE(l_speedMax > 0);
+}
+
+TEST_CASE("Test the classification of edges.", "[fwaveClassify]") {
+  /*
+   * Test case:
+   *  b: -10 | -4 | 2 | 5 | -3
+   *
+   *  edge 0: wet-wet, jump: -9.80665 * (-4 + 10) = -58.8399
+   *  edge 1: wet-dry, the dry side is reflected, no jump
+   *  edge 2: dry-dry
+   *  edge 3: dry-wet, the dry side is reflected, no jump
+   */
+  float l_b[5] = {-10, -4, 2, 5, -3};
+  unsigned char l_edgeType[4];
+  float l_bathJump[4];
+
+  tsunami_lab::solvers::fwave::classifyEdges(4, l_b, l_b + 1, l_edgeType,
+                                             l_bathJump);
+
+  REQUIRE(l_edgeType[0] == 0);
+  REQUIRE(l_edgeType[1] == tsunami_lab::solvers::fwave::m_dryR);
+  REQUIRE(l_edgeType[2] == tsunami_lab::solvers::fwave::m_dryDry);
+  REQUIRE(l_edgeType[3] == tsunami_lab::solvers::fwave::m_dryL);
+
+  REQUIRE(l_bathJump[0] == Approx(-58.8399));
+  REQUIRE(l_bathJump[1] == 0);
+  REQUIRE(l_bathJump[3] == 0);
+
+  // the classified batch matches the one deriving the classes on the fly
+  float l_h[5] = {10, 4, 0, 0, 3};
+  float l_hu[5] = {1, -2, 0, 0, 0.5};
+  float l_netUpdates[4][4];
+  float l_netUpdatesClass[4][4];
+
+  float l_speed = tsunami_lab::solvers::fwave::netUpdatesBatch(
+      4, l_h, l_h + 1, l_hu, l_hu + 1, l_b, l_b + 1, l_netUpdates[0],
+      l_netUpdates[1], l_netUpdates[2], l_netUpdates[3]);
+  float l_speedClass = tsunami_lab::solvers::fwave::netUpdatesBatch(
+      4, l_h, l_h + 1, l_hu, l_hu + 1, l_edgeType, l_bathJump,
+      l_netUpdatesClass[0], l_netUpdatesClass[1], l_netUpdatesClass[2],
+      l_netUpdatesClass[3]);
+
+  REQUIRE(l_speedClass == l_speed);
+  for (unsigned short l_up = 0; l_up < 4; l_up++) {
+    for (unsigned short l_ed = 0; l_ed < 4; l_ed++) {
+      REQUIRE(l_netUpdatesClass[l_up][l_ed] == l_netUpdates[l_up][l_ed]);
+    }
+  }
+}
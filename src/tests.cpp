@@ -32,8 +32,22 @@
 #include <catch2/catch.hpp>
 #undef CATCH_CONFIG_RUNNER
 
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
 int main(int i_argc, char* i_argv[]) {
+#ifdef USE_MPI
+  // the tests of the distributed patch run on all processes
+  int l_provided = 0;
+  MPI_Init_thread(&i_argc, &i_argv, MPI_THREAD_FUNNELED, &l_provided);
+#endif
+
   int l_result = Catch::Session().run(i_argc, i_argv);
 
+#ifdef USE_MPI
+  MPI_Finalize();
+#endif
+
   return (l_result < 0xff ? l_result : 0xff);
 }